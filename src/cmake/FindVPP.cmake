@@ -167,6 +167,16 @@ else (VPP_LIBRARIES AND VPP_INCLUDE_DIRS)
       ${CMAKE_INSTALL_PREFIX}/lib
   )
 
+   find_library(VPPAPICLIENT_LIBRARY
+    NAMES
+      vppapiclient
+      libvppapiclient
+    PATHS
+      ${VPP_LIBRARY_PATH}
+      ${CMAKE_LIBRARY_PATH}
+      ${CMAKE_INSTALL_PREFIX}/lib
+  )
+
    find_library(VOM_LIBRARY
     NAMES
       vom
@@ -200,6 +210,7 @@ else (VPP_LIBRARIES AND VPP_INCLUDE_DIRS)
     ${VLIB_LIBRARY}
     ${VATPLUGIN_LIBRARY}
     ${VAPI_LIBRARY}
+    ${VPPAPICLIENT_LIBRARY}
     ${VOM_LIBRARY}
   )
 
@@ -0,0 +1,31 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __ALLOC_COUNT_H__
+#define __ALLOC_COUNT_H__
+
+#include <cstdint>
+
+/*
+ * Heap allocations made by the calling thread.
+ *
+ * sweetcomb-bench replaces malloc, calloc and realloc with wrappers of the
+ * glibc allocator counting calls, which also covers operator new and the
+ * allocations made inside libsysrepo.
+ */
+uint64_t alloc_count();
+
+#endif /* __ALLOC_COUNT_H__ */
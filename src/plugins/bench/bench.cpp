@@ -0,0 +1,561 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* sweetcomb-bench: time the plugin callbacks on synthetic configurations of
+ * increasing size, with sysrepo and VPP played by in-memory stand-ins. What
+ * is measured is the cost of sweetcomb itself: change parsing, staging,
+ * VOM object handling and building state data. The checks of each module
+ * and its own benchmarks are in test_<module>.cpp; this driver runs them,
+ * times the interface configurations of each size and reports. */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#include <vpp-oper/cmd_window.hpp>
+#include <vpp-oper/interface_cache.hpp>
+#include <vpp-oper/stats.hpp>
+
+#include "alloc_count.h"
+#include "bench.h"
+#include "mock_vpp.hpp"
+#include "sc_connection.h"
+#include "sc_dispatcher.h"
+#include "sc_latency.h"
+#include "sc_plugins.h"
+#include "sc_request.h"
+#include "sc_running.h"
+#include "sc_startup.h"
+#include "sys_util.h"
+
+using namespace std::chrono;
+
+namespace bench {
+
+/* Fastest run of one benchmark at one size */
+struct result_t {
+    std::string name;
+    size_t objects;
+    nanoseconds best;
+    /* heap allocations of the fastest run */
+    uint64_t allocs;
+};
+
+static std::vector<result_t> results;
+static int failures;
+
+void record(const std::string &name, size_t objects, nanoseconds t,
+            uint64_t allocs)
+{
+    for (auto &r : results) {
+        if (r.name == name && r.objects == objects) {
+            if (t < r.best) {
+                r.best = t;
+                r.allocs = allocs;
+            }
+            return;
+        }
+    }
+
+    results.push_back({ name, objects, t, allocs });
+}
+
+void check(bool ok, const std::string &what, size_t n)
+{
+    if (ok)
+        return;
+
+    fprintf(stderr, "FAIL: %s with %zu objects\n", what.c_str(), n);
+    failures++;
+}
+
+/* Round trip of the mock VAPI while timing pipelining, 0 to skip it */
+microseconds vapi_latency(20);
+
+/* Time a commit of the changes queued in the sysrepo stand-in, until the
+ * workers have pushed it to VPP. during runs once sysrepo is done with the
+ * commit, while VPP is programmed */
+void commit(const std::string &name, size_t n,
+            std::function<void()> during)
+{
+    uint64_t allocs = alloc_count();
+    steady_clock::time_point start = steady_clock::now();
+    int rc = sr::instance().commit();
+    if (during)
+        during();
+    sc_dispatcher::instance().wait();
+    nanoseconds t = steady_clock::now() - start;
+
+    record(name, n, t, alloc_count() - allocs);
+    check(SR_ERR_OK == rc, name, n);
+}
+
+/* Time a get of each xpath, for n objects in all, return the number of
+ * values replied. The gets are calls of one request if request_id is given,
+ * as sysrepo makes for the instances of a list, else requests of their own. */
+size_t get(const std::string &name, size_t n,
+           const std::vector<std::string> &xpaths,
+           uint64_t request_id)
+{
+    nanoseconds total(0);
+    uint64_t allocs = 0;
+    size_t replied = 0;
+    bool ok = true;
+
+    for (auto &xpath : xpaths) {
+        sr_val_t *values = nullptr;
+        size_t cnt = 0;
+
+        uint64_t a = alloc_count();
+        steady_clock::time_point start = steady_clock::now();
+        int rc = sr::instance().get_items(xpath, &values, &cnt, request_id);
+        total += steady_clock::now() - start;
+        allocs += alloc_count() - a;
+
+        ok = ok && SR_ERR_OK == rc && cnt > 0;
+        replied += cnt;
+        sr_free_values(values, cnt);
+    }
+
+    record(name, n, total, allocs);
+    check(ok, name, n);
+
+    return replied;
+}
+
+/* Return the number of values replied to a get of xpath, -1 if it
+ * failed */
+long get_count(const std::string &xpath)
+{
+    sr_val_t *values = nullptr;
+    size_t cnt = 0;
+
+    if (SR_ERR_OK != sr::instance().get_items(xpath, &values, &cnt))
+        return -1;
+    sr_free_values(values, cnt);
+
+    return cnt;
+}
+
+std::string itf_xpath(size_t i, const std::string &prefix)
+{
+    return "/ietf-interfaces:interfaces/interface[name='" + prefix +
+           std::to_string(i) + "']";
+}
+
+std::string ip4(int a, size_t i)
+{
+    return std::to_string(a) + "." + std::to_string((i >> 16) & 0xff) + "." +
+           std::to_string((i >> 8) & 0xff) + "." + std::to_string(i & 0xff);
+}
+
+std::string addr_xpath(size_t i)
+{
+    return itf_xpath(i) + "/ietf-ip:ipv4/address[ip='" + ip4(10, i) + "']";
+}
+
+/* Queue the creation of n enabled interfaces, or their deletion */
+void interface_changes(size_t n, sr_change_oper_t op)
+{
+    for (size_t i = 0; i < n; i++) {
+        std::string x = itf_xpath(i);
+        sr_val_t *name = sr::val(x + "/name", SR_STRING_T,
+                                 "bench" + std::to_string(i));
+
+        if (SR_OP_DELETED == op) {
+            sr::instance().change(op, sr::list(x), nullptr);
+            sr::instance().change(op, name, nullptr);
+            continue;
+        }
+
+        sr::instance().change(op, nullptr, sr::list(x));
+        sr::instance().change(op, nullptr, name);
+        sr::instance().change(op, nullptr,
+                              sr::val(x + "/type", SR_IDENTITYREF_T,
+                                      "iana-if-type:ethernetCsmacd"));
+        sr::instance().change(op, nullptr, sr::val(x + "/enabled", true));
+    }
+}
+
+/* Queue the creation or the deletion of the address of n interfaces */
+void address_changes(size_t n, sr_change_oper_t op)
+{
+    for (size_t i = 0; i < n; i++) {
+        std::string x = addr_xpath(i);
+        sr_val_t *ip = sr::val(x + "/ip", SR_STRING_T, ip4(10, i));
+        sr_val_t *len = sr::val(x + "/prefix-length", (uint8_t) 24);
+
+        if (SR_OP_CREATED == op) {
+            sr::instance().change(op, nullptr, sr::list(x));
+            sr::instance().change(op, nullptr, ip);
+            sr::instance().change(op, nullptr, len);
+        } else {
+            sr::instance().change(op, sr::list(x), nullptr);
+            sr::instance().change(op, ip, nullptr);
+            sr::instance().change(op, len, nullptr);
+        }
+    }
+}
+
+/* Queue the change of the enabled leaf of n interfaces to up */
+void enabled_changes(size_t n, bool up)
+{
+    for (size_t i = 0; i < n; i++) {
+        std::string x = itf_xpath(i) + "/enabled";
+        sr::instance().change(SR_OP_MODIFIED, sr::val(x, !up),
+                              sr::val(x, up));
+    }
+}
+
+const std::string STATE_CHANGE =
+    "/sweetcomb-interfaces:interface-state-change";
+
+/* Wait up to timeout for count notifications at xpath, return them, the
+ * others are dropped */
+std::vector<sr::notif_t> notifications(const std::string &xpath,
+                                       size_t count,
+                                       milliseconds timeout)
+{
+    steady_clock::time_point end = steady_clock::now() + timeout;
+    std::vector<sr::notif_t> all;
+
+    for (;;) {
+        for (auto &notif : sr::instance().notifications()) {
+            if (notif.xpath == xpath)
+                all.push_back(notif);
+            else
+                sr_free_values(notif.values, notif.values_cnt);
+        }
+        if (all.size() >= count || steady_clock::now() >= end)
+            return all;
+        std::this_thread::sleep_for(milliseconds(1));
+    }
+}
+
+void free_notifications(std::vector<sr::notif_t> &all)
+{
+    for (auto &notif : all)
+        sr_free_values(notif.values, notif.values_cnt);
+    all.clear();
+}
+
+} // namespace bench
+
+using namespace bench;
+
+static const std::vector<size_t> DEFAULT_SIZES = { 10, 1000, 10000 };
+
+static void run(size_t n)
+{
+    mock_vpp &vpp = mock_vpp::instance();
+    std::vector<std::string> xpaths;
+    size_t base = vpp.interfaces();
+
+    interface_changes(n, SR_OP_CREATED);
+    commit("interface create", n);
+    check(vpp.interfaces() == base + n, "interfaces in VPP", n);
+
+    enabled_changes(n, false);
+    commit("interface disable", n);
+
+    state_changes(n);
+
+    /* one address per interface */
+    address_changes(n, SR_OP_CREATED);
+    commit("ipv4 address create", n);
+    check(vpp.addresses() == n, "addresses in VPP", n);
+
+    /* state data */
+    interface_cache::instance().invalidate();
+    get("interfaces-state all (cold)", n,
+        { "/ietf-interfaces:interfaces-state/interface" });
+    get("interfaces-state all (warm)", n,
+        { "/ietf-interfaces:interfaces-state/interface" });
+
+    xpaths.clear();
+    for (size_t i = 0; i < n; i++)
+        xpaths.push_back("/ietf-interfaces:interfaces-state/interface"
+                         "[name='bench" + std::to_string(i) + "']");
+    get("interfaces-state one by one", n, xpaths);
+
+    /* a snapshot taken before the interfaces were created lacks them */
+    std::this_thread::sleep_for(interface_stats::MAX_AGE);
+
+    xpaths.clear();
+    for (size_t i = 0; i < n; i++)
+        xpaths.push_back("/ietf-interfaces:interfaces-state/interface"
+                         "[name='bench" + std::to_string(i) + "']/statistics");
+    get("interface statistics", n, xpaths);
+
+    /* the calls of one request share a snapshot of interfaces and counters */
+    uint64_t taken = sc_request::taken();
+    get("interface statistics, 1 request", n, xpaths,
+        sr::instance().request());
+    check(sc_request::taken() - taken == 1, "snapshots of one request", n);
+
+    xpaths.clear();
+    for (size_t i = 0; i < n; i++)
+        xpaths.push_back("/openconfig-interfaces:interfaces/interface"
+                         "[name='bench" + std::to_string(i) + "']/state");
+    get("openconfig interface state", n, xpaths);
+    get("openconfig state, 1 request", n, xpaths,
+        sr::instance().request());
+    openconfig_state(n);
+
+    telemetry(n);
+
+    stats_segment(n);
+
+    nat_mappings(n);
+
+    /* back to the initial state */
+    address_changes(n, SR_OP_DELETED);
+    commit("ipv4 address delete", n);
+    check(vpp.addresses() == 0, "addresses left in VPP", n);
+
+    /* the addresses and admin states of a commit are pipelined, a VPP
+     * slow to reply costs about one round trip per window of them */
+    if (vapi_latency.count()) {
+        vapi::Connection::latency() = vapi_latency;
+        address_changes(n, SR_OP_CREATED);
+        commit("ipv4 address create, latency", n);
+        check(vpp.addresses() == n, "addresses in VPP", n);
+        address_changes(n, SR_OP_DELETED);
+        commit("ipv4 address delete, latency", n);
+        check(vpp.addresses() == 0, "addresses left in VPP", n);
+        enabled_changes(n, true);
+        commit("interface enable, latency", n);
+        vapi::Connection::latency() = microseconds(0);
+
+        /* not to be taken for the ones of the next run */
+        std::vector<sr::notif_t> all =
+            notifications(STATE_CHANGE, n,
+                          milliseconds(NOTIF_DEBOUNCE * 10 + n / 10));
+        free_notifications(all);
+    }
+
+    interface_changes(n, SR_OP_DELETED);
+    commit("interface delete", n);
+    check(vpp.interfaces() == base, "interfaces left in VPP", n);
+}
+
+/* Routes loaded per second by the fastest bulk load */
+static void print_route_rate()
+{
+    for (auto &r : results) {
+        double s = duration<double>(r.best).count();
+
+        if (r.name == "static route bulk load" && s > 0)
+            printf("\n%-32s %8zu %12.0f routes/s\n", "static route load rate",
+                   r.objects, r.objects / s);
+    }
+}
+
+/* Latency of each plugin callback over all runs, as published in
+ * sweetcomb-stats */
+static void print_callbacks()
+{
+    sr_val_t *values = nullptr;
+    size_t cnt = 0;
+    int rc;
+
+    rc = sr::instance().get_items("/sweetcomb-stats:callbacks/callback",
+                                  &values, &cnt);
+    check(SR_ERR_OK == rc && cnt > 0, "sweetcomb-stats callbacks", 0);
+    sr_free_values(values, cnt);
+
+    printf("\n%-64s %10s %8s %8s %8s\n", "callback", "calls", "p50 us",
+           "p99 us", "max us");
+    for (auto &st : sc_latency::instance().stats()) {
+        printf("%-64s %10llu %8llu %8llu %8llu\n", st.xpath.c_str(),
+               (unsigned long long) st.calls,
+               (unsigned long long) st.percentile(0.50),
+               (unsigned long long) st.percentile(0.99),
+               (unsigned long long) st.max);
+    }
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr, "Usage: %s [-r repeat] [-t threads] [-N mappings] "
+            "[-R routes] [-l latency] [-w window] [-S interfaces] "
+            "[objects...]\n"
+            "  -r  runs of each benchmark, the fastest is reported (3)\n"
+            "  -t  VPP threads in the stats segment (1)\n"
+            "  -N  NAT mappings loaded in one commit, 0 to skip (100000)\n"
+            "  -R  static routes loaded in one commit, 0 to skip (100000)\n"
+            "  -l  VAPI round trip in us when timing pipelining, 0 to skip "
+            "(20)\n"
+            "  -w  requests in flight on a VAPI connection (128)\n"
+            "  -S  interfaces in running datastore at plugin start (10000)\n"
+            "  objects: configuration sizes (10 1000 10000)\n", prog);
+}
+
+int main(int argc, char **argv)
+{
+    std::vector<size_t> sizes;
+    void *private_ctx = nullptr;
+    size_t nat_mappings = 100000;
+    size_t routes = 100000;
+    size_t boot_interfaces = 10000;
+    int repeat = 3;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "r:t:N:R:l:w:S:h")) != -1) {
+        switch (opt) {
+        case 'r':
+            repeat = atoi(optarg);
+            break;
+        case 't':
+            mock_vpp::instance().set_threads(atoi(optarg));
+            break;
+        case 'N':
+            nat_mappings = strtoul(optarg, nullptr, 10);
+            break;
+        case 'R':
+            routes = strtoul(optarg, nullptr, 10);
+            break;
+        case 'l':
+            vapi_latency = microseconds(strtoul(optarg, nullptr, 10));
+            break;
+        case 'w':
+            cmd_window::set_default_window(strtoul(optarg, nullptr, 10));
+            break;
+        case 'S':
+            boot_interfaces = strtoul(optarg, nullptr, 10);
+            break;
+        default:
+            usage(argv[0]);
+            return (opt == 'h') ? 0 : 1;
+        }
+    }
+    for (int i = optind; i < argc; i++)
+        sizes.push_back(strtoul(argv[i], nullptr, 10));
+    if (sizes.empty())
+        sizes = DEFAULT_SIZES;
+
+    sr_log_stderr(SR_LL_NONE);
+    sr_log_syslog(SR_LL_NONE);
+
+    running_config(boot_interfaces);
+    size_t base = mock_vpp::instance().interfaces();
+
+    /* VPP is connected and read in the background */
+    uint64_t allocs = alloc_count();
+    steady_clock::time_point start = steady_clock::now();
+    if (SR_ERR_OK != sr_plugin_init_cb(sr::instance().session(),
+                                       &private_ctx)) {
+        fprintf(stderr, "plugin init failed\n");
+        return 1;
+    }
+    record("plugin init", 0, steady_clock::now() - start,
+           alloc_count() - allocs);
+
+    /* committed while the running datastore is applied: applies after it */
+    if (boot_interfaces)
+        check(SR_ERR_OK == running_address_commit(boot_interfaces - 1,
+                                                  SR_OP_DELETED),
+              "commit during running datastore apply", boot_interfaces);
+
+    for (int i = 0; i < 500 && !startup_done(); i++)
+        std::this_thread::sleep_for(milliseconds(10));
+    if (!sc_connection::instance().is_connected() || !startup_done()) {
+        fprintf(stderr, "plugin did not connect to the mock VPP\n");
+        return 1;
+    }
+    sc_dispatcher::instance().wait();
+    if (boot_interfaces) {
+        check(mock_vpp::instance().addresses() == boot_interfaces - 1,
+              "commit applied after running datastore", boot_interfaces);
+        check(SR_ERR_OK == running_address_commit(boot_interfaces - 1,
+                                                  SR_OP_CREATED),
+              "running address created again", boot_interfaces);
+        sc_dispatcher::instance().wait();
+    }
+
+    /* from plugin start to the running datastore programmed in VPP */
+    for (auto &ph : sc_startup::instance().phases()) {
+        if (ph.name == "total")
+            record("startup to programmed VPP", boot_interfaces, ph.duration,
+                   alloc_count() - allocs);
+    }
+    check(sc_running::instance().stats().values == 7 * boot_interfaces + 1,
+          "running datastore read", boot_interfaces);
+    check(mock_vpp::instance().interfaces() == base + boot_interfaces,
+          "running interfaces in VPP", boot_interfaces);
+    check(mock_vpp::instance().addresses() == boot_interfaces,
+          "running addresses in VPP", boot_interfaces);
+    running_config_delete(boot_interfaces);
+    check(mock_vpp::instance().interfaces() == base &&
+          mock_vpp::instance().addresses() == 0,
+          "running config left in VPP", boot_interfaces);
+
+    prefix_checks();
+    dispatch_checks();
+    transaction_checks();
+    interface_cache_checks();
+    repair_checks();
+    monitor_checks();
+    nat_bound_checks();
+
+    sr::instance().change(SR_OP_CREATED, nullptr,
+                          sr::val("/sweetcomb-interfaces:"
+                                  "state-change-notifications/debounce",
+                                  NOTIF_DEBOUNCE));
+    if (SR_ERR_OK != sr::instance().commit()) {
+        fprintf(stderr, "fail setting notification debounce\n");
+        return 1;
+    }
+
+    for (size_t n : sizes) {
+        for (int r = 0; r < repeat; r++) {
+            run(n);
+            prefix_bench(n);
+            dispatch_bench(n);
+            nat_sessions(n);
+            pipeline_bench(n);
+        }
+    }
+    for (int r = 0; r < repeat && nat_mappings; r++)
+        nat_bulk(nat_mappings);
+    for (int r = 0; r < repeat && routes; r++)
+        route_bulk(routes);
+
+    printf("%-32s %8s %12s %12s %14s\n", "benchmark", "objects", "total ms",
+           "us/object", "allocs/object");
+    for (auto &r : results) {
+        double ms = duration<double, std::milli>(r.best).count();
+
+        printf("%-32s %8zu %12.3f %12.3f %14.1f\n", r.name.c_str(), r.objects,
+               ms, r.objects ? ms * 1000 / r.objects : 0.0,
+               r.objects ? (double) r.allocs / r.objects : 0.0);
+    }
+
+    print_route_rate();
+    print_callbacks();
+    print_startup();
+
+    sr_plugin_cleanup_cb(sr::instance().session(), private_ctx);
+
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "sysrepo_mock.h"
+
+/*
+ * sweetcomb-bench is made of the driver, bench.cpp, which times the
+ * configurations of each size and reports, and of one test_<module>.cpp
+ * per module, holding the checks of its expected behavior and the
+ * benchmarks of its own. The helpers below are the driver's.
+ */
+namespace bench {
+
+typedef sysrepo_mock sr;
+
+/* Record a run of benchmark name on objects, the fastest is reported */
+void record(const std::string &name, size_t objects,
+            std::chrono::nanoseconds t, uint64_t allocs);
+
+/* Report a failure of what on n objects unless ok, the bench then fails */
+void check(bool ok, const std::string &what, size_t n);
+
+/* Round trip of the mock VAPI while timing pipelining, 0 to skip it */
+extern std::chrono::microseconds vapi_latency;
+
+/* Time a commit of the changes queued in the sysrepo stand-in, until the
+ * workers have pushed it to VPP. during runs once sysrepo is done with the
+ * commit, while VPP is programmed */
+void commit(const std::string &name, size_t n,
+            std::function<void()> during = nullptr);
+
+/* Time a get of each xpath, for n objects in all, return the number of
+ * values replied. The gets are calls of one request if request_id is given,
+ * as sysrepo makes for the instances of a list, else requests of their own. */
+size_t get(const std::string &name, size_t n,
+           const std::vector<std::string> &xpaths, uint64_t request_id = 0);
+
+/* Return the number of values replied to a get of xpath, -1 if it
+ * failed */
+long get_count(const std::string &xpath);
+
+std::string itf_xpath(size_t i, const std::string &prefix = "bench");
+std::string ip4(int a, size_t i);
+std::string addr_xpath(size_t i);
+
+/* Queue the creation of n enabled interfaces, or their deletion */
+void interface_changes(size_t n, sr_change_oper_t op);
+
+/* Queue the creation or the deletion of the address of n interfaces */
+void address_changes(size_t n, sr_change_oper_t op);
+
+/* Queue the change of the enabled leaf of n interfaces to up */
+void enabled_changes(size_t n, bool up);
+
+extern const std::string STATE_CHANGE;
+
+/* Debounce of interface-state-change set for the bench, in ms */
+const uint32_t NOTIF_DEBOUNCE = 20;
+
+/* Wait up to timeout for count notifications at xpath, return them, the
+ * others are dropped */
+std::vector<sr::notif_t> notifications(const std::string &xpath,
+                                       size_t count,
+                                       std::chrono::milliseconds timeout);
+
+void free_notifications(std::vector<sr::notif_t> &all);
+
+/* test_prefix.cpp */
+void prefix_checks();
+void prefix_bench(size_t n);
+
+/* test_dispatch.cpp */
+void dispatch_checks();
+void dispatch_bench(size_t n);
+
+/* test_transaction.cpp */
+void transaction_checks();
+void repair_checks();
+
+/* test_monitor.cpp */
+void monitor_checks();
+
+/* test_interface_cache.cpp */
+void interface_cache_checks();
+
+/* test_notifications.cpp */
+void state_changes(size_t n);
+void telemetry(size_t n);
+
+/* test_openconfig.cpp */
+void openconfig_state(size_t n);
+
+/* test_stats.cpp */
+void stats_segment(size_t n);
+
+/* test_nat.cpp */
+void nat_mappings(size_t n);
+void nat_sessions(size_t n);
+void nat_bound_checks();
+void nat_bulk(size_t n);
+
+/* test_routing.cpp */
+void route_bulk(size_t n);
+
+/* test_pipeline.cpp */
+void pipeline_bench(size_t n);
+
+/* test_running.cpp */
+void print_startup();
+bool startup_done();
+void running_config(size_t n);
+int running_address_commit(size_t i, sr_change_oper_t op);
+void running_config_delete(size_t n);
+
+} // namespace bench
+
+#endif /* __BENCH_H__ */
@@ -0,0 +1,479 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "mock_vpp.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include <vapi/ip.api.vapi.hpp>
+
+using boost::asio::ip::address;
+using boost::asio::ip::address_v4;
+using boost::asio::ip::address_v6;
+
+static address from_api(const vapi_type_address &a)
+{
+    if (ADDRESS_IP6 == a.af) {
+        address_v6::bytes_type b;
+        std::copy(a.un.ip6, a.un.ip6 + b.size(), b.begin());
+        return address_v6(b);
+    }
+
+    address_v4::bytes_type b;
+    std::copy(a.un.ip4, a.un.ip4 + b.size(), b.begin());
+    return address_v4(b);
+}
+
+static void to_api(const address &addr, vapi_type_address &a)
+{
+    if (addr.is_v6()) {
+        auto b = addr.to_v6().to_bytes();
+        a.af = ADDRESS_IP6;
+        std::copy(b.begin(), b.end(), a.un.ip6);
+    } else {
+        auto b = addr.to_v4().to_bytes();
+        a.af = ADDRESS_IP4;
+        std::copy(b.begin(), b.end(), a.un.ip4);
+    }
+}
+
+template <typename B>
+static address_v4 v4(const B &b)
+{
+    address_v4::bytes_type bytes;
+    std::copy(b, b + bytes.size(), bytes.begin());
+    return address_v4(bytes);
+}
+
+template <typename B>
+static address_v6 v6(const B &b)
+{
+    address_v6::bytes_type bytes;
+    std::copy(b, b + bytes.size(), bytes.begin());
+    return address_v6(bytes);
+}
+
+mock_vpp& mock_vpp::instance()
+{
+    /* never destroyed, the VOM objects may outlive any static */
+    static mock_vpp *vpp = new mock_vpp();
+
+    return *vpp;
+}
+
+mock_vpp::mock_vpp() : m_next(1), m_threads(1), m_stat_vectors(0)
+{
+    /* local0 */
+    add_interface("local0");
+}
+
+uint32_t mock_vpp::add_interface(const std::string &name)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+    vapi_payload_sw_interface_details d;
+
+    auto it = m_names.find(name);
+    if (it != m_names.end())
+        return it->second;
+
+    memset(&d, 0, sizeof(d));
+    d.sw_if_index = (name == "local0") ? 0 : m_next++;
+    d.sup_sw_if_index = d.sw_if_index;
+    d.l2_address[0] = 0x02;
+    d.l2_address[4] = (d.sw_if_index >> 8) & 0xff;
+    d.l2_address[5] = d.sw_if_index & 0xff;
+    d.flags = IF_STATUS_API_FLAG_LINK_UP;
+    d.link_speed = 10000000;
+    d.link_mtu = 1500;
+    strncpy(d.interface_name, name.c_str(), sizeof(d.interface_name) - 1);
+
+    m_interfaces[d.sw_if_index] = d;
+    m_names[name] = d.sw_if_index;
+
+    return d.sw_if_index;
+}
+
+uint32_t mock_vpp::add_sub_interface(uint32_t parent, uint32_t sub_id)
+{
+    std::string name;
+    uint32_t sw_if_index;
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        auto it = m_interfaces.find(parent);
+        if (it == m_interfaces.end())
+            return ~0;
+        name = std::string(it->second.interface_name) + "." +
+               std::to_string(sub_id);
+    }
+
+    sw_if_index = add_interface(name);
+
+    std::lock_guard<std::mutex> lg(m_lock);
+    vapi_payload_sw_interface_details &d = m_interfaces[sw_if_index];
+
+    d.sup_sw_if_index = parent;
+    d.sub_id = sub_id;
+    d.sub_number_of_tags = 1;
+    d.sub_outer_vlan_id = sub_id;
+
+    return sw_if_index;
+}
+
+void mock_vpp::del_interface(uint32_t sw_if_index)
+{
+    vapi_payload_sw_interface_details d;
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        auto it = m_interfaces.find(sw_if_index);
+        if (it == m_interfaces.end())
+            return;
+
+        d = it->second;
+        m_names.erase(it->second.interface_name);
+        m_interfaces.erase(it);
+    }
+
+    event(d, true);
+}
+
+void mock_vpp::set_admin(uint32_t sw_if_index, bool up)
+{
+    set_flags(sw_if_index, IF_STATUS_API_FLAG_ADMIN_UP, up);
+}
+
+void mock_vpp::set_link(uint32_t sw_if_index, bool up)
+{
+    set_flags(sw_if_index, IF_STATUS_API_FLAG_LINK_UP, up);
+}
+
+void mock_vpp::set_flags(uint32_t sw_if_index, vapi_enum_if_status_flags flag,
+                         bool set)
+{
+    vapi_payload_sw_interface_details d;
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        auto it = m_interfaces.find(sw_if_index);
+        if (it == m_interfaces.end())
+            return;
+
+        vapi_enum_if_status_flags flags = (vapi_enum_if_status_flags)
+            (set ? it->second.flags | flag : it->second.flags & ~flag);
+        if (flags == it->second.flags)
+            return;
+
+        it->second.flags = flags;
+        d = it->second;
+    }
+
+    event(d, false);
+}
+
+void mock_vpp::event(const vapi_payload_sw_interface_details &d, bool deleted)
+{
+    vapi_payload_sw_interface_event ev;
+
+    memset(&ev, 0, sizeof(ev));
+    ev.sw_if_index = d.sw_if_index;
+    ev.flags = d.flags;
+    ev.deleted = deleted;
+
+    /* delivered without m_lock, a listener may read VPP back */
+    vapi::Event_registration<vapi_payload_sw_interface_event>::deliver(ev);
+}
+
+void mock_vpp::add_address(uint32_t sw_if_index, const prefix_t &pfx)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_addresses.insert(std::make_pair(sw_if_index, pfx));
+}
+
+void mock_vpp::del_address(uint32_t sw_if_index, const prefix_t &pfx)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_addresses.erase(std::make_pair(sw_if_index, pfx));
+}
+
+void mock_vpp::add_route(const prefix_t &pfx, size_t paths)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_routes[pfx] = paths;
+}
+
+void mock_vpp::del_route(const prefix_t &pfx)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_routes.erase(pfx);
+}
+
+void mock_vpp::add_nat(const nat_pair_t &pair)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_nats.insert(pair);
+}
+
+void mock_vpp::del_nat(const nat_pair_t &pair)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_nats.erase(pair);
+}
+
+size_t mock_vpp::interfaces()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_interfaces.size();
+}
+
+size_t mock_vpp::addresses()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_addresses.size();
+}
+
+size_t mock_vpp::routes()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_routes.size();
+}
+
+size_t mock_vpp::route_paths()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+    size_t n = 0;
+
+    for (auto &r : m_routes)
+        n += r.second;
+
+    return n;
+}
+
+void mock_vpp::add_session(const session_t &s)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_sessions[v4(s.inside_ip_address).to_ulong()].push_back(s);
+}
+
+void mock_vpp::clear_sessions()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_sessions.clear();
+}
+
+size_t mock_vpp::nats()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_nats.size();
+}
+
+bool mock_vpp::has_nat(const nat_pair_t &pair)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_nats.count(pair) > 0;
+}
+
+void mock_vpp::add_traffic(uint32_t sw_if_index, uint64_t packets)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    if (sw_if_index >= m_traffic.size())
+        m_traffic.resize(sw_if_index + 1);
+    m_traffic[sw_if_index] += packets;
+}
+
+std::vector<uint64_t> mock_vpp::traffic()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_traffic;
+}
+
+uint32_t mock_vpp::max_sw_if_index()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    if (m_interfaces.empty())
+        return 0;
+
+    return m_interfaces.rbegin()->first + 1;
+}
+
+std::map<uint32_t, vapi_payload_sw_interface_details> mock_vpp::dump()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_interfaces;
+}
+
+void mock_vpp::install()
+{
+    vapi::Sw_interface_dump::responder() = [this](vapi::Sw_interface_dump &d) {
+        auto &req = d.get_request().get_payload();
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        for (auto &it : m_interfaces) {
+            if (req.name_filter_valid &&
+                strncmp(req.name_filter.buf, it.second.interface_name,
+                        sizeof(req.name_filter.buf)))
+                continue;
+            d.get_result_set().add() = it.second;
+        }
+    };
+
+    vapi::Sw_interface_set_flags::responder() =
+        [this](vapi::Sw_interface_set_flags &r) {
+        auto &req = r.get_request().get_payload();
+
+        set_admin(req.sw_if_index, req.flags & IF_STATUS_API_FLAG_ADMIN_UP);
+    };
+
+    vapi::Sw_interface_add_del_address::responder() =
+        [this](vapi::Sw_interface_add_del_address &r) {
+        auto &req = r.get_request().get_payload();
+        prefix_t pfx(from_api(req.prefix.address), req.prefix.len);
+
+        if (req.is_add)
+            add_address(req.sw_if_index, pfx);
+        else
+            del_address(req.sw_if_index, pfx);
+    };
+
+    vapi::Ip_address_dump::responder() = [this](vapi::Ip_address_dump &d) {
+        auto &req = d.get_request().get_payload();
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        for (auto &a : m_addresses) {
+            if (a.first != req.sw_if_index ||
+                a.second.first.is_v6() != req.is_ipv6)
+                continue;
+
+            auto &rec = d.get_result_set().add();
+            rec.sw_if_index = a.first;
+            to_api(a.second.first, rec.prefix.address);
+            rec.prefix.len = a.second.second;
+        }
+    };
+
+    vapi::Ip_route_add_del::responder() = [this](vapi::Ip_route_add_del &r) {
+        auto &req = r.get_request().get_payload();
+        prefix_t pfx(from_api(req.route.prefix.address),
+                     req.route.prefix.len);
+
+        if (req.is_add)
+            add_route(pfx, req.route.n_paths);
+        else
+            del_route(pfx);
+    };
+
+    vapi::Nat44_add_del_static_mapping::responder() =
+        [this](vapi::Nat44_add_del_static_mapping &r) {
+        auto &req = r.get_request().get_payload();
+        nat_pair_t pair(v4(req.local_ip_address), v4(req.external_ip_address));
+
+        if (req.is_add)
+            add_nat(pair);
+        else
+            del_nat(pair);
+    };
+
+    vapi::Nat66_add_del_static_mapping::responder() =
+        [this](vapi::Nat66_add_del_static_mapping &r) {
+        auto &req = r.get_request().get_payload();
+        nat_pair_t pair(v6(req.local_ip_address), v6(req.external_ip_address));
+
+        if (req.is_add)
+            add_nat(pair);
+        else
+            del_nat(pair);
+    };
+
+    vapi::Nat44_static_mapping_dump::responder() =
+        [this](vapi::Nat44_static_mapping_dump &d) {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        for (auto &n : m_nats) {
+            if (!n.first.is_v4())
+                continue;
+
+            auto &rec = d.get_result_set().add();
+            auto in = n.first.to_v4().to_bytes();
+            auto out = n.second.to_v4().to_bytes();
+            std::copy(in.begin(), in.end(), rec.local_ip_address);
+            std::copy(out.begin(), out.end(), rec.external_ip_address);
+            rec.flags = NAT_IS_ADDR_ONLY;
+            rec.external_sw_if_index = ~0;
+        }
+    };
+
+    vapi::Nat66_static_mapping_dump::responder() =
+        [this](vapi::Nat66_static_mapping_dump &d) {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        for (auto &n : m_nats) {
+            if (!n.first.is_v6())
+                continue;
+
+            auto &rec = d.get_result_set().add();
+            auto in = n.first.to_v6().to_bytes();
+            auto out = n.second.to_v6().to_bytes();
+            std::copy(in.begin(), in.end(), rec.local_ip_address);
+            std::copy(out.begin(), out.end(), rec.external_ip_address);
+        }
+    };
+
+    vapi::Nat44_user_dump::responder() = [this](vapi::Nat44_user_dump &d) {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        for (auto &u : m_sessions) {
+            auto &rec = d.get_result_set().add();
+            auto ip = address_v4(u.first).to_bytes();
+            std::copy(ip.begin(), ip.end(), rec.ip_address);
+            rec.vrf_id = 0;
+            rec.nsessions = u.second.size();
+            rec.nstaticsessions = 0;
+        }
+    };
+
+    vapi::Nat44_user_session_dump::responder() =
+        [this](vapi::Nat44_user_session_dump &d) {
+        auto &req = d.get_request().get_payload();
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        auto it = m_sessions.find(v4(req.ip_address).to_ulong());
+        if (it == m_sessions.end() || req.vrf_id != 0)
+            return;
+        for (auto &s : it->second)
+            d.get_result_set().add() = s;
+    };
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __MOCK_VPP_H__
+#define __MOCK_VPP_H__
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/ip/address.hpp>
+
+#include <vapi/interface.api.vapi.hpp>
+#include <vapi/nat.api.vapi.hpp>
+
+/*
+ * The VPP that the mock VOM programs and the mock VAPI and stat client read
+ * back. Everything is in memory and answered at once, so that a benchmark
+ * measures sweetcomb and not VPP. Changes of the interface flags and
+ * deletions are sent as interface events, as VPP does.
+ */
+class mock_vpp {
+public:
+    typedef std::pair<boost::asio::ip::address, uint8_t> prefix_t;
+    typedef std::pair<boost::asio::ip::address,
+                      boost::asio::ip::address> nat_pair_t;
+    typedef vapi_payload_nat44_user_session_details session_t;
+
+    static mock_vpp& instance();
+
+    /* Add an interface if it does not exist, return its sw_if_index */
+    uint32_t add_interface(const std::string &name);
+    /* Add VLAN sub_id of interface parent, "<parent>.<sub_id>" */
+    uint32_t add_sub_interface(uint32_t parent, uint32_t sub_id);
+    void del_interface(uint32_t sw_if_index);
+    void set_admin(uint32_t sw_if_index, bool up);
+    /* Carrier of the interface, up when added */
+    void set_link(uint32_t sw_if_index, bool up);
+
+    void add_address(uint32_t sw_if_index, const prefix_t &pfx);
+    void del_address(uint32_t sw_if_index, const prefix_t &pfx);
+
+    /* Add or replace a route of the default table, its paths are only
+     * counted */
+    void add_route(const prefix_t &pfx, size_t paths);
+    void del_route(const prefix_t &pfx);
+
+    void add_nat(const nat_pair_t &pair);
+    void del_nat(const nat_pair_t &pair);
+
+    /* Add a NAT44 session of its inside address in VRF 0 */
+    void add_session(const session_t &s);
+    void clear_sessions();
+
+    /* Number of interfaces, addresses, routes, their paths and NAT
+     * mappings */
+    size_t interfaces();
+    size_t addresses();
+    size_t routes();
+    size_t route_paths();
+    size_t nats();
+
+    /* NAT mapping pair is programmed */
+    bool has_nat(const nat_pair_t &pair);
+
+    /* Number of threads whose counters the stats segment holds */
+    void set_threads(int n) { m_threads = n; }
+    int threads() const { return m_threads; }
+
+    /* Vectors allocated by the stat client and not freed yet */
+    void stat_vector_alloc(int delta) { m_stat_vectors += delta; }
+    long stat_vectors() const { return m_stat_vectors; }
+
+    /* Receive packets of 64 bytes on an interface, counted on thread 0 */
+    void add_traffic(uint32_t sw_if_index, uint64_t packets);
+
+    /* Packets received by each sw_if_index */
+    std::vector<uint64_t> traffic();
+
+    /* Highest sw_if_index in use, plus one */
+    uint32_t max_sw_if_index();
+
+    /* Copy of the interfaces as sw_interface_dump replies them */
+    std::map<uint32_t, vapi_payload_sw_interface_details> dump();
+
+    /* Install the VAPI responders playing this VPP */
+    void install();
+
+private:
+    mock_vpp();
+
+    void set_flags(uint32_t sw_if_index, vapi_enum_if_status_flags flag,
+                   bool set);
+
+    /* Send an sw_interface_event to the registrations */
+    void event(const vapi_payload_sw_interface_details &d, bool deleted);
+
+    std::mutex m_lock;
+    std::map<uint32_t, vapi_payload_sw_interface_details> m_interfaces;
+    std::map<std::string, uint32_t> m_names;
+    std::set<std::pair<uint32_t, prefix_t>> m_addresses;
+    std::map<prefix_t, size_t> m_routes;
+    std::set<nat_pair_t> m_nats;
+    /* sessions by user, the inside address in host order */
+    std::map<uint32_t, std::vector<session_t>> m_sessions;
+    uint32_t m_next;
+    int m_threads;
+    std::atomic<long> m_stat_vectors;
+    std::vector<uint64_t> m_traffic;
+};
+
+#endif /* __MOCK_VPP_H__ */
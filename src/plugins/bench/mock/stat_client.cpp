@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include <vpp-api/client/stat_client.h>
+}
+
+#include "mock_vpp.hpp"
+
+/* Counters served by the segment, as VPP names them */
+static const struct {
+    const char *name;
+    stat_directory_type_t type;
+} directory[] = {
+    { "/if/rx", STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED },
+    { "/if/rx-unicast", STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED },
+    { "/if/rx-multicast", STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED },
+    { "/if/rx-broadcast", STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED },
+    { "/if/tx", STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED },
+    { "/if/tx-unicast", STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED },
+    { "/if/tx-multicast", STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED },
+    { "/if/tx-broadcast", STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED },
+    { "/if/drops", STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE },
+    { "/if/punt", STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE },
+    { "/if/rx-no-buf", STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE },
+    { "/if/rx-miss", STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE },
+    { "/if/rx-error", STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE },
+    { "/if/tx-error", STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE },
+};
+
+#define N_DIRECTORY (sizeof(directory) / sizeof(directory[0]))
+
+/* Vectors are preceded by their length, as VPP vectors are */
+typedef struct {
+    uint64_t len;
+    uint64_t pad;
+} vec_header_t;
+
+static void *vec_new(size_t len, size_t elt_size)
+{
+    vec_header_t *h = (vec_header_t *) calloc(1, sizeof(*h) + len * elt_size);
+
+    h->len = len;
+    mock_vpp::instance().stat_vector_alloc(1);
+    return h + 1;
+}
+
+int stat_segment_vec_len(void *vec)
+{
+    if (vec == NULL)
+        return 0;
+
+    return ((vec_header_t *) vec - 1)->len;
+}
+
+void stat_segment_vec_free(void *vec)
+{
+    if (vec) {
+        free((vec_header_t *) vec - 1);
+        mock_vpp::instance().stat_vector_alloc(-1);
+    }
+}
+
+int stat_segment_connect(const char *socket_name)
+{
+    (void) socket_name;
+    return 0;
+}
+
+void stat_segment_disconnect(void)
+{
+}
+
+uint8_t **stat_segment_string_vector(uint8_t **string_vector,
+                                     const char *string)
+{
+    int len = stat_segment_vec_len(string_vector);
+    uint8_t **v = (uint8_t **) vec_new(len + 1, sizeof(uint8_t *));
+
+    if (len)
+        memcpy(v, string_vector, len * sizeof(uint8_t *));
+    /* each string is a NUL terminated vector, as VPP formats them */
+    v[len] = (uint8_t *) vec_new(strlen(string) + 1, 1);
+    memcpy(v[len], string, strlen(string));
+    stat_segment_vec_free(string_vector);
+
+    return v;
+}
+
+uint32_t *stat_segment_ls(uint8_t **pattern)
+{
+    uint32_t *dir = (uint32_t *) vec_new(N_DIRECTORY, sizeof(uint32_t));
+
+    (void) pattern;
+    for (size_t i = 0; i < N_DIRECTORY; i++)
+        dir[i] = i;
+
+    return dir;
+}
+
+stat_segment_data_t *stat_segment_dump(uint32_t *counter_vec)
+{
+    int n = stat_segment_vec_len(counter_vec);
+    int n_threads = mock_vpp::instance().threads();
+    size_t n_itfs = mock_vpp::instance().max_sw_if_index();
+    std::vector<uint64_t> traffic = mock_vpp::instance().traffic();
+    stat_segment_data_t *res;
+
+    traffic.resize(std::max(n_itfs, traffic.size()));
+
+    res = (stat_segment_data_t *) vec_new(n, sizeof(stat_segment_data_t));
+
+    for (int i = 0; i < n; i++) {
+        stat_segment_data_t &e = res[i];
+
+        e.name = strdup(directory[counter_vec[i]].name);
+        e.type = directory[counter_vec[i]].type;
+
+        if (STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED == e.type) {
+            e.combined_counter_vec = (vlib_counter_t **)
+                vec_new(n_threads, sizeof(vlib_counter_t *));
+            for (int k = 0; k < n_threads; k++) {
+                vlib_counter_t *c = (vlib_counter_t *)
+                    vec_new(n_itfs, sizeof(vlib_counter_t));
+                for (size_t j = 0; j < n_itfs; j++) {
+                    c[j].packets = j + k + (k ? 0 : traffic[j]);
+                    c[j].bytes = c[j].packets * 64;
+                }
+                e.combined_counter_vec[k] = c;
+            }
+        } else {
+            e.simple_counter_vec = (counter_t **)
+                vec_new(n_threads, sizeof(counter_t *));
+            for (int k = 0; k < n_threads; k++) {
+                counter_t *c = (counter_t *) vec_new(n_itfs, sizeof(counter_t));
+                for (size_t j = 0; j < n_itfs; j++)
+                    c[j] = j + k;
+                e.simple_counter_vec[k] = c;
+            }
+        }
+    }
+
+    return res;
+}
+
+void stat_segment_data_free(stat_segment_data_t *res)
+{
+    for (int i = 0; i < stat_segment_vec_len(res); i++) {
+        stat_segment_data_t &e = res[i];
+
+        if (STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED == e.type) {
+            for (int k = 0; k < stat_segment_vec_len(e.combined_counter_vec); k++)
+                stat_segment_vec_free(e.combined_counter_vec[k]);
+            stat_segment_vec_free(e.combined_counter_vec);
+        } else {
+            for (int k = 0; k < stat_segment_vec_len(e.simple_counter_vec); k++)
+                stat_segment_vec_free(e.simple_counter_vec[k]);
+            stat_segment_vec_free(e.simple_counter_vec);
+        }
+        free(e.name);
+    }
+    stat_segment_vec_free(res);
+}
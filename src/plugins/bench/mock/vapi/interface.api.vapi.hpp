@@ -0,0 +1,131 @@
+#ifndef __MOCK_VAPI_INTERFACE_API_H__
+#define __MOCK_VAPI_INTERFACE_API_H__
+
+/*
+ * The interface.api messages used by sweetcomb, as in VPP 19.08
+ */
+
+#include <vapi/vapi.hpp>
+
+typedef enum {
+  IF_STATUS_API_FLAG_ADMIN_UP = 1,
+  IF_STATUS_API_FLAG_LINK_UP = 2,
+} vapi_enum_if_status_flags;
+
+typedef enum {
+  ADDRESS_IP4 = 0,
+  ADDRESS_IP6 = 1,
+} vapi_enum_address_family;
+
+typedef uint8_t vapi_type_ip4_address[4];
+typedef uint8_t vapi_type_ip6_address[16];
+
+typedef union {
+  vapi_type_ip4_address ip4;
+  vapi_type_ip6_address ip6;
+} vapi_union_address_union;
+
+typedef struct {
+  vapi_enum_address_family af;
+  vapi_union_address_union un;
+} vapi_type_address;
+
+typedef struct {
+  vapi_type_address address;
+  uint8_t len;
+} vapi_type_prefix;
+
+typedef vapi_type_prefix vapi_type_address_with_prefix;
+
+typedef struct {
+  uint32_t sw_if_index;
+  uint32_t sup_sw_if_index;
+  uint8_t l2_address[6];
+  vapi_enum_if_status_flags flags;
+  uint32_t type;
+  uint32_t link_duplex;
+  uint32_t link_speed;
+  uint16_t link_mtu;
+  uint32_t mtu[4];
+  uint32_t sub_id;
+  uint8_t sub_number_of_tags;
+  uint16_t sub_outer_vlan_id;
+  uint16_t sub_inner_vlan_id;
+  uint32_t sub_if_flags;
+  uint32_t vtr_op;
+  uint32_t vtr_push_dot1q;
+  uint32_t vtr_tag1;
+  uint32_t vtr_tag2;
+  uint32_t outer_tag;
+  uint8_t b_dmac[6];
+  uint8_t b_smac[6];
+  uint16_t b_vlanid;
+  uint32_t i_sid;
+  char interface_name[64];
+  char interface_dev_type[64];
+  char tag[64];
+} vapi_payload_sw_interface_details;
+
+typedef struct {
+  uint32_t sw_if_index;
+  bool name_filter_valid;
+  struct {
+    uint32_t length;
+    char buf[64];
+  } name_filter;
+} vapi_payload_sw_interface_dump;
+
+typedef struct {
+  uint32_t pid;
+  uint32_t sw_if_index;
+  vapi_enum_if_status_flags flags;
+  bool deleted;
+} vapi_payload_sw_interface_event;
+
+typedef struct {
+  uint32_t enable_disable;
+  uint32_t pid;
+} vapi_payload_want_interface_events;
+
+typedef struct {
+  int32_t retval;
+} vapi_payload_want_interface_events_reply;
+
+typedef struct {
+  uint32_t sw_if_index;
+  bool is_add;
+  bool del_all;
+  vapi_type_address_with_prefix prefix;
+} vapi_payload_sw_interface_add_del_address;
+
+typedef struct {
+  int32_t retval;
+} vapi_payload_sw_interface_add_del_address_reply;
+
+typedef struct {
+  uint32_t sw_if_index;
+  vapi_enum_if_status_flags flags;
+} vapi_payload_sw_interface_set_flags;
+
+typedef struct {
+  int32_t retval;
+} vapi_payload_sw_interface_set_flags_reply;
+
+namespace vapi {
+
+typedef Dump<vapi_payload_sw_interface_dump, vapi_payload_sw_interface_details>
+  Sw_interface_dump;
+typedef Request<vapi_payload_want_interface_events,
+                vapi_payload_want_interface_events_reply>
+  Want_interface_events;
+typedef vapi_payload_sw_interface_event Sw_interface_event;
+typedef Request<vapi_payload_sw_interface_add_del_address,
+                vapi_payload_sw_interface_add_del_address_reply>
+  Sw_interface_add_del_address;
+typedef Request<vapi_payload_sw_interface_set_flags,
+                vapi_payload_sw_interface_set_flags_reply>
+  Sw_interface_set_flags;
+
+} // namespace vapi
+
+#endif
@@ -0,0 +1,82 @@
+#ifndef __MOCK_VAPI_IP_API_H__
+#define __MOCK_VAPI_IP_API_H__
+
+/*
+ * The ip.api messages used by sweetcomb, as in VPP 19.08
+ */
+
+#include <vapi/interface.api.vapi.hpp>
+
+typedef struct {
+  uint32_t sw_if_index;
+  bool is_ipv6;
+} vapi_payload_ip_address_dump;
+
+typedef struct {
+  uint32_t sw_if_index;
+  vapi_type_address_with_prefix prefix;
+} vapi_payload_ip_address_details;
+
+typedef enum {
+  FIB_API_PATH_TYPE_NORMAL = 0,
+  FIB_API_PATH_TYPE_LOCAL = 1,
+  FIB_API_PATH_TYPE_DROP = 2,
+} vapi_enum_fib_path_type;
+
+typedef enum {
+  FIB_API_PATH_NH_PROTO_IP4 = 0,
+  FIB_API_PATH_NH_PROTO_IP6 = 1,
+} vapi_enum_fib_path_nh_proto;
+
+typedef struct {
+  vapi_union_address_union address;
+  uint32_t via_label;
+  uint32_t obj_id;
+  uint32_t classify_table_index;
+} vapi_type_fib_path_nh;
+
+/* without its label stack */
+typedef struct {
+  uint32_t sw_if_index;
+  uint32_t table_id;
+  uint32_t rpf_id;
+  uint8_t weight;
+  uint8_t preference;
+  vapi_enum_fib_path_type type;
+  uint32_t flags;
+  vapi_enum_fib_path_nh_proto proto;
+  vapi_type_fib_path_nh nh;
+  uint8_t n_labels;
+} vapi_type_fib_path;
+
+/* room for the paths of the bench's routes, paths[n_paths] in VPP */
+typedef struct {
+  uint32_t table_id;
+  uint32_t stats_index;
+  vapi_type_prefix prefix;
+  uint8_t n_paths;
+  vapi_type_fib_path paths[16];
+} vapi_type_ip_route;
+
+typedef struct {
+  bool is_add;
+  bool is_multipath;
+  vapi_type_ip_route route;
+} vapi_payload_ip_route_add_del;
+
+typedef struct {
+  int32_t retval;
+  uint32_t stats_index;
+} vapi_payload_ip_route_add_del_reply;
+
+namespace vapi {
+
+typedef Dump<vapi_payload_ip_address_dump, vapi_payload_ip_address_details>
+  Ip_address_dump;
+typedef Request<vapi_payload_ip_route_add_del,
+                vapi_payload_ip_route_add_del_reply, size_t>
+  Ip_route_add_del;
+
+} // namespace vapi
+
+#endif
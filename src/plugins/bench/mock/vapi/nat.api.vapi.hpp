@@ -0,0 +1,125 @@
+#ifndef __MOCK_VAPI_NAT_API_H__
+#define __MOCK_VAPI_NAT_API_H__
+
+/*
+ * The nat.api messages used by sweetcomb, as in VPP 19.08
+ */
+
+#include <vapi/interface.api.vapi.hpp>
+
+typedef enum {
+  NAT_IS_NONE = 0,
+  NAT_IS_TWICE_NAT = 1,
+  NAT_IS_SELF_TWICE_NAT = 2,
+  NAT_IS_OUT2IN_ONLY = 4,
+  NAT_IS_ADDR_ONLY = 8,
+} vapi_enum_nat_config_flags;
+
+typedef struct {
+  bool is_add;
+  vapi_enum_nat_config_flags flags;
+  vapi_type_ip4_address local_ip_address;
+  vapi_type_ip4_address external_ip_address;
+  uint8_t protocol;
+  uint16_t local_port;
+  uint16_t external_port;
+  uint32_t external_sw_if_index;
+  uint32_t vrf_id;
+  uint8_t tag[64];
+} vapi_payload_nat44_add_del_static_mapping;
+
+typedef struct {
+  int32_t retval;
+} vapi_payload_nat44_add_del_static_mapping_reply;
+
+typedef struct {
+} vapi_payload_nat44_static_mapping_dump;
+
+typedef struct {
+  vapi_enum_nat_config_flags flags;
+  vapi_type_ip4_address local_ip_address;
+  vapi_type_ip4_address external_ip_address;
+  uint8_t protocol;
+  uint16_t local_port;
+  uint16_t external_port;
+  uint32_t external_sw_if_index;
+  uint32_t vrf_id;
+  uint8_t tag[64];
+} vapi_payload_nat44_static_mapping_details;
+
+typedef struct {
+  bool is_add;
+  vapi_type_ip6_address local_ip_address;
+  vapi_type_ip6_address external_ip_address;
+  uint32_t vrf_id;
+} vapi_payload_nat66_add_del_static_mapping;
+
+typedef struct {
+  int32_t retval;
+} vapi_payload_nat66_add_del_static_mapping_reply;
+
+typedef struct {
+} vapi_payload_nat66_static_mapping_dump;
+
+typedef struct {
+  vapi_type_ip6_address local_ip_address;
+  vapi_type_ip6_address external_ip_address;
+  uint32_t vrf_id;
+  uint64_t total_bytes;
+  uint64_t total_pkts;
+} vapi_payload_nat66_static_mapping_details;
+
+typedef struct {
+} vapi_payload_nat44_user_dump;
+
+typedef struct {
+  uint32_t vrf_id;
+  vapi_type_ip4_address ip_address;
+  uint32_t nsessions;
+  uint32_t nstaticsessions;
+} vapi_payload_nat44_user_details;
+
+typedef struct {
+  vapi_type_ip4_address ip_address;
+  uint32_t vrf_id;
+} vapi_payload_nat44_user_session_dump;
+
+typedef struct {
+  vapi_type_ip4_address outside_ip_address;
+  uint16_t outside_port;
+  vapi_type_ip4_address inside_ip_address;
+  uint16_t inside_port;
+  uint16_t protocol;
+  vapi_enum_nat_config_flags flags;
+  uint64_t last_heard;
+  uint64_t total_bytes;
+  uint32_t total_pkts;
+  vapi_type_ip4_address ext_host_address;
+  uint16_t ext_host_port;
+  vapi_type_ip4_address ext_host_nat_address;
+  uint16_t ext_host_nat_port;
+} vapi_payload_nat44_user_session_details;
+
+namespace vapi {
+
+typedef Request<vapi_payload_nat44_add_del_static_mapping,
+                vapi_payload_nat44_add_del_static_mapping_reply>
+  Nat44_add_del_static_mapping;
+typedef Dump<vapi_payload_nat44_static_mapping_dump,
+             vapi_payload_nat44_static_mapping_details>
+  Nat44_static_mapping_dump;
+typedef Request<vapi_payload_nat66_add_del_static_mapping,
+                vapi_payload_nat66_add_del_static_mapping_reply>
+  Nat66_add_del_static_mapping;
+typedef Dump<vapi_payload_nat66_static_mapping_dump,
+             vapi_payload_nat66_static_mapping_details>
+  Nat66_static_mapping_dump;
+typedef Dump<vapi_payload_nat44_user_dump, vapi_payload_nat44_user_details>
+  Nat44_user_dump;
+typedef Dump<vapi_payload_nat44_user_session_dump,
+             vapi_payload_nat44_user_session_details>
+  Nat44_user_session_dump;
+
+} // namespace vapi
+
+#endif
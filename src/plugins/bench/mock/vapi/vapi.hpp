@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __MOCK_VAPI_HPP__
+#define __MOCK_VAPI_HPP__
+
+/*
+ * Stand-in for the VAPI C++ binding used by sweetcomb-bench.
+ *
+ * Requests are answered by a responder, which the bench can replace per
+ * message type to play VPP. The reply is handled from execute(), or, with a
+ * latency set, by the next dispatch() of the connection once the latency
+ * has passed, as the RX thread of a real connection would. Events are
+ * delivered to the registrations by the thread changing the mock VPP.
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <utility>
+
+typedef enum {
+  VAPI_OK = 0,
+  VAPI_EINVAL,
+  VAPI_EAGAIN,
+  VAPI_ENOTSUP,
+  VAPI_ENOMEM,
+  VAPI_ENORESP,
+  VAPI_EMAP_FAIL,
+  VAPI_ECON_FAIL,
+  VAPI_EINCOMPATIBLE,
+  VAPI_MUTEX_FAILURE,
+  VAPI_EUSER,
+} vapi_error_e;
+
+namespace vapi {
+
+class Connection
+{
+public:
+  /* round trip of all requests, 0 to handle replies from execute() */
+  static std::chrono::microseconds& latency()
+  {
+    static std::chrono::microseconds l(0);
+    return l;
+  }
+
+  /* handle a reply, now or once the latency has passed */
+  void reply(std::function<void()> handle)
+  {
+    if (0 == latency().count()) {
+      handle();
+      return;
+    }
+
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_replies.emplace_back(std::chrono::steady_clock::now() + latency(),
+                           handle);
+    m_cond.notify_all();
+  }
+
+  /* handle the next reply, waiting a little for one */
+  vapi_error_e dispatch()
+  {
+    std::unique_lock<std::mutex> lk(m_lock);
+
+    if (!m_cond.wait_for(lk, std::chrono::milliseconds(1),
+                         [this]() { return !m_replies.empty(); }))
+      return VAPI_OK;
+
+    /* replies are due in the order of their requests */
+    auto due = m_replies.front().first;
+    while (std::chrono::steady_clock::now() < due)
+      m_cond.wait_until(lk, due);
+
+    std::function<void()> handle = std::move(m_replies.front().second);
+    m_replies.pop_front();
+    lk.unlock();
+
+    handle();
+
+    return VAPI_OK;
+  }
+
+private:
+  typedef std::chrono::steady_clock::time_point due_t;
+
+  std::mutex m_lock;
+  std::condition_variable m_cond;
+  std::deque<std::pair<due_t, std::function<void()>>> m_replies;
+};
+
+template <typename M>
+class Msg
+{
+public:
+  Msg() { memset(&m_payload, 0, sizeof(m_payload)); }
+
+  M& get_payload() { return m_payload; }
+  const M& get_payload() const { return m_payload; }
+
+private:
+  M m_payload;
+};
+
+template <typename M>
+class Result_set
+{
+public:
+  typedef typename std::list<Msg<M>>::const_iterator const_iterator;
+
+  const_iterator begin() const { return m_set.begin(); }
+  const_iterator end() const { return m_set.end(); }
+  size_t size() const { return m_set.size(); }
+  bool is_completed() const { return true; }
+  void free_all_responses() { m_set.clear(); }
+
+  /* add a record, for responders */
+  M& add()
+  {
+    m_set.emplace_back();
+    return m_set.back().get_payload();
+  }
+
+private:
+  std::list<Msg<M>> m_set;
+};
+
+/*
+ * Args are the sizes of the variable length arrays of Req, which the mock
+ * messages declare with a fixed size instead
+ */
+template <typename Req, typename Resp, typename... Args>
+class Request
+{
+public:
+  typedef std::function<void(Request&)> responder_t;
+
+  template <typename F>
+  Request(Connection& con, Args..., F cb)
+    : m_con(con)
+    , m_cb(cb)
+  {
+  }
+
+  Msg<Req>& get_request() { return m_request; }
+  Msg<Resp>& get_response() { return m_response; }
+
+  vapi_error_e execute()
+  {
+    if (responder())
+      responder()(*this);
+    m_con.reply([this]() { m_cb(*this); });
+    return VAPI_OK;
+  }
+
+  /* how the mock VPP answers this request, retval 0 when unset */
+  static responder_t& responder()
+  {
+    static responder_t r;
+    return r;
+  }
+
+private:
+  Connection& m_con;
+  std::function<vapi_error_e(Request&)> m_cb;
+  Msg<Req> m_request;
+  Msg<Resp> m_response;
+};
+
+template <typename Req, typename Resp>
+class Dump
+{
+public:
+  typedef Resp resp_type;
+  typedef std::function<void(Dump&)> responder_t;
+
+  template <typename F>
+  Dump(Connection& con, F cb)
+    : m_con(con)
+    , m_cb(cb)
+  {
+  }
+
+  Msg<Req>& get_request() { return m_request; }
+  Result_set<Resp>& get_result_set() { return m_result; }
+
+  vapi_error_e execute()
+  {
+    if (responder())
+      responder()(*this);
+    m_con.reply([this]() { m_cb(*this); });
+    return VAPI_OK;
+  }
+
+  /* how the mock VPP fills the dump, empty when unset */
+  static responder_t& responder()
+  {
+    static responder_t r;
+    return r;
+  }
+
+private:
+  Connection& m_con;
+  std::function<vapi_error_e(Dump&)> m_cb;
+  Msg<Req> m_request;
+  Result_set<Resp> m_result;
+};
+
+template <typename M>
+class Event_registration
+{
+public:
+  typedef M resp_type;
+
+  template <typename F>
+  Event_registration(Connection&, F cb)
+    : m_cb(cb)
+  {
+    std::lock_guard<std::mutex> lg(lock());
+    registrations().push_back(this);
+  }
+
+  ~Event_registration()
+  {
+    std::lock_guard<std::mutex> lg(lock());
+    registrations().remove(this);
+  }
+
+  Result_set<M>& get_result_set() { return m_result; }
+
+  /* send an event to all the registrations, for the mock VPP */
+  static void deliver(const M& event)
+  {
+    std::lock_guard<std::mutex> lg(lock());
+
+    for (auto r : registrations()) {
+      r->m_result.add() = event;
+      r->m_cb(*r);
+    }
+  }
+
+private:
+  static std::mutex& lock()
+  {
+    static std::mutex l;
+    return l;
+  }
+
+  static std::list<Event_registration*>& registrations()
+  {
+    static std::list<Event_registration*> r;
+    return r;
+  }
+
+  std::function<vapi_error_e(Event_registration&)> m_cb;
+  Result_set<M> m_result;
+};
+
+} // namespace vapi
+
+#endif /* __MOCK_VAPI_HPP__ */
@@ -0,0 +1,400 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <deque>
+#include <thread>
+
+#include <vom/hw.hpp>
+#include <vom/interface.hpp>
+#include <vom/l3_binding.hpp>
+#include <vom/nat_static.hpp>
+#include <vom/om.hpp>
+#include <vom/route.hpp>
+
+#include "mock_vpp.hpp"
+
+namespace VOM {
+
+const rc_t rc_t::UNSET(0, "un-set");
+const rc_t rc_t::NOOP(1, "no-op");
+const rc_t rc_t::OK(2, "ok");
+const rc_t rc_t::INVALID(3, "invalid");
+const rc_t rc_t::TIMEOUT(4, "timeout");
+
+const rc_t&
+rc_t::from_vpp_retval(int32_t rv)
+{
+  return (0 == rv ? OK : INVALID);
+}
+
+const handle_t handle_t::INVALID(~0);
+
+const nh_proto_t nh_proto_t::IPV4(false);
+const nh_proto_t nh_proto_t::IPV6(true);
+
+const route::path::special_t route::path::special_t::STANDARD("standard");
+const route::path::special_t route::path::special_t::LOCAL("local");
+const route::path::special_t route::path::special_t::DROP("drop");
+
+/*
+ * HW: the commands are issued in order by the thread that writes them,
+ * the mock VPP answers from execute() or, with a latency, to the RX thread.
+ */
+static std::mutex hw_lock;
+static std::mutex hw_write_lock;
+static std::deque<std::shared_ptr<cmd>> hw_queue;
+/* left to the RX thread, which runs until exit */
+static connection& hw_conn = *new connection();
+
+void
+HW::init()
+{
+  mock_vpp::instance().install();
+
+  std::thread([]() {
+    for (;;)
+      hw_conn.ctx().dispatch();
+  }).detach();
+}
+
+void
+HW::enqueue(cmd* c)
+{
+  enqueue(std::shared_ptr<cmd>(c));
+}
+
+void
+HW::enqueue(std::shared_ptr<cmd> c)
+{
+  std::lock_guard<std::mutex> lg(hw_lock);
+  hw_queue.push_back(c);
+}
+
+void
+HW::enqueue(std::queue<cmd*>& cmds)
+{
+  while (!cmds.empty()) {
+    enqueue(cmds.front());
+    cmds.pop();
+  }
+}
+
+void
+HW::dequeue(cmd*)
+{
+  /* the mock VPP sends no event, registrations have nothing to cancel */
+}
+
+void
+HW::dequeue(std::shared_ptr<cmd>)
+{
+}
+
+rc_t
+HW::write()
+{
+  std::lock_guard<std::mutex> wlg(hw_write_lock);
+  std::deque<std::shared_ptr<cmd>> cmds;
+  rc_t rc = rc_t::OK;
+
+  {
+    std::lock_guard<std::mutex> lg(hw_lock);
+    cmds.swap(hw_queue);
+  }
+
+  for (auto& c : cmds) {
+    rc_t r = c->issue(hw_conn);
+
+    if (rc_t::OK == rc && rc_t::OK != r)
+      rc = r;
+  }
+
+  return (rc);
+}
+
+bool
+HW::connect()
+{
+  return (true);
+}
+
+void
+HW::disconnect()
+{
+}
+
+bool
+HW::poll()
+{
+  return (true);
+}
+
+/*
+ * OM
+ */
+std::mutex OM::m_lock;
+std::map<client_db::key_t, std::set<std::shared_ptr<object_base>>> OM::m_db;
+
+void
+OM::remove(const client_db::key_t& key)
+{
+  std::set<std::shared_ptr<object_base>> objs;
+
+  {
+    std::lock_guard<std::mutex> lg(m_lock);
+    auto it = m_db.find(key);
+
+    if (it == m_db.end())
+      return;
+    objs.swap(it->second);
+    m_db.erase(it);
+  }
+
+  /* the objects are deleted from the mock VPP as they are released */
+}
+
+void
+OM::clear()
+{
+  std::map<client_db::key_t, std::set<std::shared_ptr<object_base>>> db;
+
+  std::lock_guard<std::mutex> lg(m_lock);
+  db.swap(m_db);
+}
+
+/*
+ * interface
+ */
+const interface::type_t interface::type_t::UNKNOWN("UNKNOWN");
+const interface::type_t interface::type_t::ETHERNET("ETHERNET");
+const interface::type_t interface::type_t::LOOPBACK("LOOPBACK");
+const interface::type_t interface::type_t::AFPACKET("AFPACKET");
+const interface::type_t interface::type_t::TAPV2("TAPV2");
+
+interface::type_t
+interface::type_t::from_string(const std::string& str)
+{
+  for (auto t : { ETHERNET, LOOPBACK, AFPACKET, TAPV2 }) {
+    if (t.to_string() == str)
+      return (t);
+  }
+
+  return (UNKNOWN);
+}
+
+const interface::admin_state_t interface::admin_state_t::DOWN(false);
+const interface::admin_state_t interface::admin_state_t::UP(true);
+
+singular_db<interface::key_t, interface> interface::m_db;
+
+interface::interface(const std::string& name,
+                     type_t type,
+                     admin_state_t state,
+                     const std::string& tag)
+  : m_name(name)
+  , m_type(type)
+  , m_state(state)
+  , m_tag(tag)
+  , m_hdl(handle_t::INVALID)
+  , m_programmed(false)
+{
+}
+
+interface::interface(const interface& o)
+  : object_base()
+  , m_name(o.m_name)
+  , m_type(o.m_type)
+  , m_state(o.m_state)
+  , m_tag(o.m_tag)
+  , m_hdl(o.m_hdl)
+  , m_programmed(false)
+{
+}
+
+interface::~interface()
+{
+  if (m_programmed)
+    mock_vpp::instance().del_interface(m_hdl.value());
+  m_db.release(m_name);
+}
+
+rc_t
+interface::update(const interface& desired)
+{
+  if (!m_programmed) {
+    m_hdl = mock_vpp::instance().add_interface(m_name);
+    m_programmed = true;
+    mock_vpp::instance().set_admin(m_hdl.value(), desired.m_state.m_up);
+  } else if (m_state != desired.m_state) {
+    mock_vpp::instance().set_admin(m_hdl.value(), desired.m_state.m_up);
+  }
+  m_state = desired.m_state;
+
+  return (rc_t::OK);
+}
+
+std::shared_ptr<interface>
+interface::singular() const
+{
+  return (m_db.find_or_add(key(), *this));
+}
+
+std::string
+interface::to_string() const
+{
+  return ("interface:[" + m_name + " type:" + m_type.to_string() +
+          " hdl:" + m_hdl.to_string() + " " + m_state.to_string() + "]");
+}
+
+std::shared_ptr<interface>
+interface::find(const key_t& k)
+{
+  return (m_db.find(k));
+}
+
+std::shared_ptr<interface>
+interface::find(const handle_t& h)
+{
+  return (m_db.find_if([&h](const interface& i) { return i.m_hdl == h; }));
+}
+
+/*
+ * l3_binding
+ */
+singular_db<l3_binding::key_t, l3_binding> l3_binding::m_db;
+
+l3_binding::l3_binding(const interface& itf, const route::prefix_t& pfx)
+  : m_itf(itf.singular())
+  , m_pfx(pfx)
+  , m_programmed(false)
+{
+}
+
+l3_binding::l3_binding(const l3_binding& o)
+  : object_base()
+  , m_itf(o.m_itf)
+  , m_pfx(o.m_pfx)
+  , m_programmed(false)
+{
+}
+
+l3_binding::~l3_binding()
+{
+  if (m_programmed)
+    mock_vpp::instance().del_address(
+      m_itf->handle().value(),
+      mock_vpp::prefix_t(m_pfx.address(), m_pfx.mask_width()));
+  m_db.release(key());
+}
+
+rc_t
+l3_binding::update(const l3_binding&)
+{
+  if (!m_programmed) {
+    mock_vpp::instance().add_address(
+      m_itf->handle().value(),
+      mock_vpp::prefix_t(m_pfx.address(), m_pfx.mask_width()));
+    m_programmed = true;
+  }
+
+  return (rc_t::OK);
+}
+
+std::shared_ptr<l3_binding>
+l3_binding::singular() const
+{
+  return (m_db.find_or_add(key(), *this));
+}
+
+std::string
+l3_binding::to_string() const
+{
+  return ("L3-binding:[" + m_itf->name() + " " + m_pfx.to_string() + "]");
+}
+
+std::shared_ptr<l3_binding>
+l3_binding::find(const key_t& k)
+{
+  return (m_db.find(k));
+}
+
+/*
+ * nat_static
+ */
+singular_db<nat_static::key_t, nat_static> nat_static::m_db;
+
+nat_static::nat_static(const boost::asio::ip::address& inside,
+                       const boost::asio::ip::address_v4& outside)
+  : m_inside(inside)
+  , m_outside(outside)
+  , m_programmed(false)
+{
+}
+
+nat_static::nat_static(const boost::asio::ip::address& inside,
+                       const boost::asio::ip::address& outside)
+  : m_inside(inside)
+  , m_outside(outside)
+  , m_programmed(false)
+{
+}
+
+nat_static::nat_static(const nat_static& o)
+  : object_base()
+  , m_inside(o.m_inside)
+  , m_outside(o.m_outside)
+  , m_programmed(false)
+{
+}
+
+nat_static::~nat_static()
+{
+  if (m_programmed)
+    mock_vpp::instance().del_nat(mock_vpp::nat_pair_t(m_inside, m_outside));
+  m_db.release(key());
+}
+
+rc_t
+nat_static::update(const nat_static& desired)
+{
+  if (m_programmed && m_outside != desired.m_outside) {
+    mock_vpp::instance().del_nat(mock_vpp::nat_pair_t(m_inside, m_outside));
+    m_programmed = false;
+  }
+  m_outside = desired.m_outside;
+
+  if (!m_programmed) {
+    mock_vpp::instance().add_nat(mock_vpp::nat_pair_t(m_inside, m_outside));
+    m_programmed = true;
+  }
+
+  return (rc_t::OK);
+}
+
+std::shared_ptr<nat_static>
+nat_static::singular() const
+{
+  return (m_db.find_or_add(key(), *this));
+}
+
+std::string
+nat_static::to_string() const
+{
+  return ("nat-static:[" + m_inside.to_string() + " " +
+          m_outside.to_string() + "]");
+}
+
+}; // namespace VOM
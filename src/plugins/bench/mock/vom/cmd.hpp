@@ -0,0 +1,43 @@
+#ifndef __MOCK_VOM_CMD_H__
+#define __MOCK_VOM_CMD_H__
+
+#include <string>
+
+#include <vom/connection.hpp>
+#include <vom/types.hpp>
+
+namespace VOM {
+
+/**
+ * A representation of a method call to VPP
+ */
+class cmd
+{
+public:
+  cmd() = default;
+  virtual ~cmd() = default;
+
+  /**
+   * Issue the command to VPP/HW
+   */
+  virtual rc_t issue(connection& con) = 0;
+
+  /**
+   * Retire/cancel a long running command
+   */
+  virtual void retire(connection& con) = 0;
+
+  /**
+   * Invoked on a command when the HW queue is disabled
+   */
+  virtual void succeeded() {}
+
+  /**
+   * convert to string format for debug purposes
+   */
+  virtual std::string to_string() const = 0;
+};
+
+}; // namespace VOM
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef __MOCK_VOM_CONNECTION_H__
+#define __MOCK_VOM_CONNECTION_H__
+
+#include <vapi/vapi.hpp>
+
+namespace VOM {
+
+/**
+ * The connection to the mock VPP, which is always there
+ */
+class connection
+{
+public:
+  int connect() { return 0; }
+  void disconnect() {}
+  vapi::Connection& ctx() { return m_ctx; }
+
+private:
+  vapi::Connection m_ctx;
+};
+
+}; // namespace VOM
+
+#endif
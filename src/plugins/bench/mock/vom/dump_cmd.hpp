@@ -0,0 +1,64 @@
+#ifndef __MOCK_VOM_DUMP_CMD_H__
+#define __MOCK_VOM_DUMP_CMD_H__
+
+#include <future>
+#include <memory>
+
+#include <vom/cmd.hpp>
+#include <vom/hw.hpp>
+
+namespace VOM {
+
+/**
+ * A base class for VPP dump commands
+ */
+template <typename MSG>
+class dump_cmd : public cmd
+{
+public:
+  typedef MSG msg_t;
+  typedef typename MSG::resp_type record_t;
+  typedef typename vapi::Result_set<record_t>::const_iterator const_iterator;
+
+  dump_cmd() = default;
+
+  const_iterator begin() { return (m_dump->get_result_set().begin()); }
+  const_iterator end() { return (m_dump->get_result_set().end()); }
+
+  /**
+   * Wait for the issue of the command to complete
+   */
+  rc_t wait()
+  {
+    std::future_status status;
+    std::future<rc_t> result;
+
+    result = m_promise.get_future();
+    status = result.wait_for(std::chrono::seconds(5));
+
+    if (status != std::future_status::ready)
+      return (rc_t::TIMEOUT);
+
+    return (result.get());
+  }
+
+  /**
+   * Called when the dump is complete
+   */
+  virtual vapi_error_e operator()(MSG&)
+  {
+    m_promise.set_value(rc_t::OK);
+
+    return (VAPI_OK);
+  }
+
+  void retire(connection&) {}
+
+protected:
+  std::unique_ptr<MSG> m_dump;
+  std::promise<rc_t> m_promise;
+};
+
+}; // namespace VOM
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef __MOCK_VOM_EVENT_CMD_H__
+#define __MOCK_VOM_EVENT_CMD_H__
+
+#include <memory>
+#include <mutex>
+
+#include <vom/rpc_cmd.hpp>
+
+namespace VOM {
+
+/**
+ * A base class for VPP event registrations. The mock VPP sends no event:
+ * a registration only has its want_* request answered.
+ */
+template <typename WANT, typename EVENT>
+class event_cmd : public rpc_cmd<HW::item<bool>, WANT>
+{
+public:
+  using rpc_cmd<HW::item<bool>, WANT>::operator();
+
+  typedef vapi::Event_registration<EVENT> reg_t;
+  typedef typename vapi::Result_set<typename reg_t::resp_type>::const_iterator
+    const_iterator;
+
+  event_cmd(HW::item<bool>& b)
+    : rpc_cmd<HW::item<bool>, WANT>(b)
+  {
+  }
+
+  virtual ~event_cmd() = default;
+
+  const_iterator begin() { return (m_reg->get_result_set().begin()); }
+  const_iterator end() { return (m_reg->get_result_set().end()); }
+
+  void lock() { m_mutex.lock(); }
+  void unlock() { m_mutex.unlock(); }
+
+  /**
+   * Called when an event is received
+   */
+  vapi_error_e operator()(reg_t&)
+  {
+    notify();
+
+    return (VAPI_OK);
+  }
+
+  virtual void retire(connection& con) = 0;
+
+  virtual void notify() = 0;
+
+  void flush() { m_reg->get_result_set().free_all_responses(); }
+
+protected:
+  std::unique_ptr<reg_t> m_reg;
+
+private:
+  std::mutex m_mutex;
+};
+
+}; // namespace VOM
+
+#endif
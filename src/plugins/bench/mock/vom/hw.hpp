@@ -0,0 +1,91 @@
+#ifndef __MOCK_VOM_HW_H__
+#define __MOCK_VOM_HW_H__
+
+#include <memory>
+#include <queue>
+#include <string>
+
+#include <vom/cmd.hpp>
+#include <vom/connection.hpp>
+#include <vom/types.hpp>
+
+namespace VOM {
+
+/**
+ * The command queue to the mock VPP. Commands are issued in order, from
+ * the thread calling write(), and answered synchronously.
+ */
+class HW
+{
+public:
+  /**
+   * A HW::item is data that is either to be written to or read from VPP,
+   * with the result of the operation.
+   */
+  template <typename T>
+  class item
+  {
+  public:
+    item()
+      : item_data()
+      , item_rc(rc_t::UNSET)
+    {
+    }
+    item(const T& data)
+      : item_data(data)
+      , item_rc(rc_t::NOOP)
+    {
+    }
+    item(const T& data, rc_t rc)
+      : item_data(data)
+      , item_rc(rc)
+    {
+    }
+    item(rc_t rc)
+      : item_data()
+      , item_rc(rc)
+    {
+    }
+
+    const T& data() const { return item_data; }
+    T& data() { return item_data; }
+    rc_t rc() const { return item_rc; }
+    void set(const rc_t& rc) { item_rc = rc; }
+    void update(const item& desired) { item_data = desired.item_data; }
+    operator bool() const { return rc_t::OK == item_rc; }
+
+    bool operator==(const item<T>& i) const { return item_data == i.item_data; }
+    item& operator=(const T& data)
+    {
+      item_data = data;
+      return *this;
+    }
+
+  private:
+    T item_data;
+    rc_t item_rc;
+  };
+
+  static void init();
+
+  static void enqueue(cmd* c);
+  static void enqueue(std::shared_ptr<cmd> c);
+  static void enqueue(std::queue<cmd*>& cmds);
+  static void dequeue(cmd* c);
+  static void dequeue(std::shared_ptr<cmd> c);
+
+  /**
+   * Issue the queued commands, return the first failure
+   */
+  static rc_t write();
+
+  static bool connect();
+  static void disconnect();
+  static bool poll();
+  static void enable() {}
+  static void disable() {}
+};
+
+}; // namespace VOM
+
+#endif
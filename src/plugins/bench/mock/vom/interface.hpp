@@ -0,0 +1,114 @@
+#ifndef __MOCK_VOM_INTERFACE_H__
+#define __MOCK_VOM_INTERFACE_H__
+
+#include <vom/hw.hpp>
+#include <vom/object_base.hpp>
+
+namespace VOM {
+
+/**
+ * A VPP interface. Only what sweetcomb uses is modelled: the interface is
+ * added to the mock VPP when first written and deleted with its last
+ * reference.
+ */
+class interface : public object_base
+{
+public:
+  typedef std::string key_t;
+
+  struct type_t
+  {
+    static const type_t UNKNOWN;
+    static const type_t ETHERNET;
+    static const type_t LOOPBACK;
+    static const type_t AFPACKET;
+    static const type_t TAPV2;
+
+    static type_t from_string(const std::string& str);
+
+    const std::string& to_string() const { return m_name; }
+    bool operator==(const type_t& o) const { return m_name == o.m_name; }
+
+  private:
+    type_t(const std::string& name)
+      : m_name(name)
+    {
+    }
+
+    std::string m_name;
+  };
+
+  struct admin_state_t
+  {
+    static const admin_state_t DOWN;
+    static const admin_state_t UP;
+
+    static admin_state_t from_int(uint8_t val) { return (val ? UP : DOWN); }
+
+    std::string to_string() const { return (m_up ? "up" : "down"); }
+    bool operator==(const admin_state_t& o) const { return m_up == o.m_up; }
+    bool operator!=(const admin_state_t& o) const { return m_up != o.m_up; }
+
+  private:
+    admin_state_t(bool up)
+      : m_up(up)
+    {
+    }
+
+    friend class interface;
+    bool m_up;
+  };
+
+  interface(const std::string& name,
+            type_t type,
+            admin_state_t state,
+            const std::string& tag = "");
+
+  /**
+   * A copy is the desired state of the interface, never programmed
+   */
+  interface(const interface& o);
+
+  ~interface();
+
+  const key_t& key() const { return m_name; }
+  const std::string& name() const { return m_name; }
+  const handle_t& handle() const { return m_hdl; }
+  const type_t& type() const { return m_type; }
+  const admin_state_t& admin_state() const { return m_state; }
+
+  void set(const admin_state_t& state) { m_state = state; }
+
+  std::shared_ptr<interface> singular() const;
+
+  std::string to_string() const;
+
+  static std::shared_ptr<interface> find(const key_t& k);
+  static std::shared_ptr<interface> find(const handle_t& h);
+
+  /**
+   * Number of interfaces known to VOM
+   */
+  static size_t count() { return m_db.size(); }
+
+private:
+  friend class OM;
+
+  /**
+   * Program the mock VPP to the desired state
+   */
+  rc_t update(const interface& desired);
+
+  std::string m_name;
+  type_t m_type;
+  admin_state_t m_state;
+  std::string m_tag;
+  handle_t m_hdl;
+  bool m_programmed;
+
+  static singular_db<key_t, interface> m_db;
+};
+
+}; // namespace VOM
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef __MOCK_VOM_L3_BINDING_H__
+#define __MOCK_VOM_L3_BINDING_H__
+
+#include <vom/interface.hpp>
+#include <vom/route.hpp>
+
+namespace VOM {
+
+/**
+ * An IP address configured on an interface
+ */
+class l3_binding : public object_base
+{
+public:
+  typedef std::pair<interface::key_t, route::prefix_t> key_t;
+
+  l3_binding(const interface& itf, const route::prefix_t& pfx);
+  l3_binding(const l3_binding& o);
+  ~l3_binding();
+
+  const key_t key() const { return key_t(m_itf->key(), m_pfx); }
+  const route::prefix_t& prefix() const { return m_pfx; }
+  const interface& itf() const { return *m_itf; }
+
+  std::shared_ptr<l3_binding> singular() const;
+
+  std::string to_string() const;
+
+  static std::shared_ptr<l3_binding> find(const key_t& k);
+
+private:
+  friend class OM;
+
+  rc_t update(const l3_binding& desired);
+
+  std::shared_ptr<interface> m_itf;
+  route::prefix_t m_pfx;
+  bool m_programmed;
+
+  static singular_db<key_t, l3_binding> m_db;
+};
+
+}; // namespace VOM
+
+#endif
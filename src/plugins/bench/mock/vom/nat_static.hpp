@@ -0,0 +1,43 @@
+#ifndef __MOCK_VOM_NAT_STATIC_H__
+#define __MOCK_VOM_NAT_STATIC_H__
+
+#include <vom/route.hpp>
+
+namespace VOM {
+
+/**
+ * A static address-only NAT mapping
+ */
+class nat_static : public object_base
+{
+public:
+  typedef std::pair<route::table_id_t, boost::asio::ip::address> key_t;
+
+  nat_static(const boost::asio::ip::address& inside,
+             const boost::asio::ip::address_v4& outside);
+  nat_static(const boost::asio::ip::address& inside,
+             const boost::asio::ip::address& outside);
+  nat_static(const nat_static& o);
+  ~nat_static();
+
+  const key_t key() const { return key_t(route::DEFAULT_TABLE, m_inside); }
+
+  std::shared_ptr<nat_static> singular() const;
+
+  std::string to_string() const;
+
+private:
+  friend class OM;
+
+  rc_t update(const nat_static& desired);
+
+  boost::asio::ip::address m_inside;
+  boost::asio::ip::address m_outside;
+  bool m_programmed;
+
+  static singular_db<key_t, nat_static> m_db;
+};
+
+}; // namespace VOM
+
+#endif
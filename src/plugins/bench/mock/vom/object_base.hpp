@@ -0,0 +1,95 @@
+#ifndef __MOCK_VOM_OBJECT_BASE_H__
+#define __MOCK_VOM_OBJECT_BASE_H__
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <vom/types.hpp>
+
+namespace VOM {
+
+/**
+ * The base class of all objects the OM stores
+ */
+class object_base
+{
+public:
+  virtual ~object_base() = default;
+
+  virtual std::string to_string() const = 0;
+};
+
+/**
+ * The DB of the unique instances of one object type, keyed by the object
+ * key. It does not own the instances: they are gone once the OM and the
+ * dependent objects have released them.
+ */
+template <typename KEY, typename OBJ>
+class singular_db
+{
+public:
+  std::shared_ptr<OBJ> find_or_add(const KEY& key, const OBJ& obj)
+  {
+    std::lock_guard<std::recursive_mutex> lg(m_lock);
+    std::shared_ptr<OBJ> sp = m_map[key].lock();
+
+    if (!sp) {
+      sp = std::make_shared<OBJ>(obj);
+      m_map[key] = sp;
+    }
+
+    return sp;
+  }
+
+  std::shared_ptr<OBJ> find(const KEY& key)
+  {
+    std::lock_guard<std::recursive_mutex> lg(m_lock);
+    auto it = m_map.find(key);
+
+    if (it == m_map.end())
+      return nullptr;
+
+    return it->second.lock();
+  }
+
+  void release(const KEY& key)
+  {
+    std::lock_guard<std::recursive_mutex> lg(m_lock);
+    auto it = m_map.find(key);
+
+    /* expired when called by the destructor of the instance */
+    if (it != m_map.end() && it->second.expired())
+      m_map.erase(it);
+  }
+
+  template <typename F>
+  std::shared_ptr<OBJ> find_if(F f)
+  {
+    std::lock_guard<std::recursive_mutex> lg(m_lock);
+
+    for (auto& it : m_map) {
+      std::shared_ptr<OBJ> sp = it.second.lock();
+      if (sp && f(*sp))
+        return sp;
+    }
+
+    return nullptr;
+  }
+
+  size_t size()
+  {
+    std::lock_guard<std::recursive_mutex> lg(m_lock);
+    return m_map.size();
+  }
+
+private:
+  /* an instance released under the lock locks it again on destruction */
+  std::recursive_mutex m_lock;
+  std::map<KEY, std::weak_ptr<OBJ>> m_map;
+};
+
+}; // namespace VOM
+
+#endif
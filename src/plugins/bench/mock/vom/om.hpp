@@ -0,0 +1,74 @@
+#ifndef __MOCK_VOM_OM_H__
+#define __MOCK_VOM_OM_H__
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include <vom/hw.hpp>
+#include <vom/object_base.hpp>
+
+namespace VOM {
+
+class client_db
+{
+public:
+  typedef std::string key_t;
+};
+
+/**
+ * The object model: the objects written by each client, keyed by the
+ * client key. An object lives as long as a client or another object holds
+ * it.
+ */
+class OM
+{
+public:
+  static void init() {}
+
+  /**
+   * Make the unique instance of obj match obj and hold it under key
+   */
+  template <typename OBJ>
+  static rc_t write(const client_db::key_t& key, const OBJ& obj)
+  {
+    std::shared_ptr<OBJ> inst = obj.singular();
+    rc_t rc = inst->update(obj);
+
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_db[key].insert(inst);
+
+    return (rc);
+  }
+
+  /**
+   * Release all the objects held under key
+   */
+  static void remove(const client_db::key_t& key);
+
+  /**
+   * The mock VPP never loses its state
+   */
+  static void replay() {}
+
+  /**
+   * The mock VPP starts empty
+   */
+  static void populate(const client_db::key_t&) {}
+
+  /**
+   * Release all the objects of all keys
+   */
+  static void clear();
+
+private:
+  static std::mutex m_lock;
+  static std::map<client_db::key_t, std::set<std::shared_ptr<object_base>>>
+    m_db;
+};
+
+}; // namespace VOM
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef __MOCK_VOM_PREFIX_H__
+#define __MOCK_VOM_PREFIX_H__
+
+#include <vom/types.hpp>
+
+namespace VOM {
+namespace route {
+
+typedef uint32_t table_id_t;
+
+static const table_id_t DEFAULT_TABLE = 0;
+
+/**
+ * An IP prefix
+ */
+class prefix_t
+{
+public:
+  prefix_t()
+    : m_len(0)
+  {
+  }
+
+  /**
+   * Throws a boost exception if s is not an IP address
+   */
+  prefix_t(const std::string& s, uint8_t len)
+    : m_addr(boost::asio::ip::address::from_string(s))
+    , m_len(len)
+  {
+  }
+
+  prefix_t(const boost::asio::ip::address& addr, uint8_t len)
+    : m_addr(addr)
+    , m_len(len)
+  {
+  }
+
+  const boost::asio::ip::address& address() const { return m_addr; }
+  uint8_t mask_width() const { return m_len; }
+
+  std::string to_string() const
+  {
+    return (m_addr.to_string() + "/" + std::to_string(m_len));
+  }
+
+  bool operator<(const prefix_t& o) const
+  {
+    if (m_len == o.m_len)
+      return (m_addr < o.m_addr);
+    return (m_len < o.m_len);
+  }
+
+  bool operator==(const prefix_t& o) const
+  {
+    return (m_len == o.m_len && m_addr == o.m_addr);
+  }
+
+private:
+  boost::asio::ip::address m_addr;
+  uint8_t m_len;
+};
+
+}; // namespace route
+}; // namespace VOM
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef __MOCK_VOM_ROUTE_H__
+#define __MOCK_VOM_ROUTE_H__
+
+#include <set>
+#include <tuple>
+
+#include <vom/interface.hpp>
+#include <vom/prefix.hpp>
+#include <vom/route_domain.hpp>
+
+namespace VOM {
+namespace route {
+
+/**
+ * A path of a route: a next-hop through an interface or a table, or a
+ * special one, e.g. drop
+ */
+class path
+{
+public:
+  struct special_t
+  {
+    static const special_t STANDARD;
+    static const special_t LOCAL;
+    static const special_t DROP;
+
+    const std::string& to_string() const { return m_name; }
+    bool operator==(const special_t& o) const { return m_name == o.m_name; }
+    bool operator!=(const special_t& o) const { return m_name != o.m_name; }
+    bool operator<(const special_t& o) const { return m_name < o.m_name; }
+
+  private:
+    special_t(const std::string& name)
+      : m_name(name)
+    {
+    }
+
+    std::string m_name;
+  };
+
+  path(special_t special, const nh_proto_t& proto = nh_proto_t::IPV4)
+    : m_type(special)
+    , m_nh_proto(proto)
+    , m_weight(1)
+    , m_preference(0)
+  {
+  }
+
+  path(const boost::asio::ip::address& nh,
+       const interface& interface,
+       uint8_t weight = 1,
+       uint8_t preference = 0)
+    : m_type(special_t::STANDARD)
+    , m_nh_proto(nh_proto_t::from_address(nh))
+    , m_nh(nh)
+    , m_interface(interface.singular())
+    , m_weight(weight)
+    , m_preference(preference)
+  {
+  }
+
+  path(const route_domain& rd,
+       const boost::asio::ip::address& nh,
+       uint8_t weight = 1,
+       uint8_t preference = 0)
+    : m_type(special_t::STANDARD)
+    , m_nh_proto(nh_proto_t::from_address(nh))
+    , m_nh(nh)
+    , m_rd(rd.singular())
+    , m_weight(weight)
+    , m_preference(preference)
+  {
+  }
+
+  path(const interface& interface,
+       const nh_proto_t& proto,
+       uint8_t weight = 1,
+       uint8_t preference = 0)
+    : m_type(special_t::STANDARD)
+    , m_nh_proto(proto)
+    , m_interface(interface.singular())
+    , m_weight(weight)
+    , m_preference(preference)
+  {
+  }
+
+  const special_t& type() const { return m_type; }
+  const nh_proto_t& nh_proto() const { return m_nh_proto; }
+  const boost::asio::ip::address& nh() const { return m_nh; }
+  std::shared_ptr<route_domain> rd() const { return m_rd; }
+  std::shared_ptr<interface> itf() const { return m_interface; }
+  uint8_t weight() const { return m_weight; }
+  uint8_t preference() const { return m_preference; }
+
+  bool operator<(const path& o) const { return (tie() < o.tie()); }
+  bool operator==(const path& o) const { return (tie() == o.tie()); }
+
+  std::string to_string() const
+  {
+    return ("path:[" + m_type.to_string() + " " + m_nh_proto.to_string() +
+            " " + m_nh.to_string() +
+            (m_interface ? " " + m_interface->name() : "") +
+            (m_rd ? " " + m_rd->to_string() : "") + " weight:" +
+            std::to_string(m_weight) +
+            " preference:" + std::to_string(m_preference) + "]");
+  }
+
+private:
+  std::tuple<special_t, nh_proto_t, boost::asio::ip::address, std::string,
+             route::table_id_t, uint8_t, uint8_t>
+  tie() const
+  {
+    return (std::make_tuple(m_type, m_nh_proto, m_nh,
+                            m_interface ? m_interface->name() : "",
+                            m_rd ? m_rd->table_id() : DEFAULT_TABLE,
+                            m_weight, m_preference));
+  }
+
+  special_t m_type;
+  nh_proto_t m_nh_proto;
+  boost::asio::ip::address m_nh;
+  std::shared_ptr<route_domain> m_rd;
+  std::shared_ptr<interface> m_interface;
+  uint8_t m_weight;
+  uint8_t m_preference;
+};
+
+typedef std::set<path> path_list_t;
+
+}; // namespace route
+}; // namespace VOM
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef __MOCK_VOM_ROUTE_DOMAIN_H__
+#define __MOCK_VOM_ROUTE_DOMAIN_H__
+
+#include <vom/object_base.hpp>
+#include <vom/prefix.hpp>
+
+namespace VOM {
+
+/**
+ * An IP table. Only its id is modelled, the tables of the mock VPP all
+ * exist.
+ */
+class route_domain : public object_base
+{
+public:
+  typedef route::table_id_t key_t;
+
+  route_domain(route::table_id_t id)
+    : m_table_id(id)
+  {
+  }
+
+  route::table_id_t table_id() const { return m_table_id; }
+
+  std::shared_ptr<route_domain> singular() const
+  {
+    return (std::make_shared<route_domain>(*this));
+  }
+
+  std::string to_string() const
+  {
+    return ("route-domain:[" + std::to_string(m_table_id) + "]");
+  }
+
+private:
+  route::table_id_t m_table_id;
+};
+
+}; // namespace VOM
+
+#endif
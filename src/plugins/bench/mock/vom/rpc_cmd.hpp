@@ -0,0 +1,76 @@
+#ifndef __MOCK_VOM_RPC_CMD_H__
+#define __MOCK_VOM_RPC_CMD_H__
+
+#include <future>
+
+#include <vom/cmd.hpp>
+#include <vom/hw.hpp>
+
+namespace VOM {
+
+/**
+ * A base class for all RPC commands to VPP
+ */
+template <typename HWITEM, typename MSG>
+class rpc_cmd : public cmd
+{
+public:
+  typedef MSG msg_t;
+
+  rpc_cmd(HWITEM& item)
+    : cmd()
+    , m_hw_item(item)
+    , m_promise()
+  {
+  }
+
+  virtual ~rpc_cmd() = default;
+
+  HWITEM& item() { return m_hw_item; }
+  const HWITEM& item() const { return m_hw_item; }
+
+  /**
+   * Wait for the issue of the command to complete
+   */
+  virtual rc_t wait()
+  {
+    std::future_status status;
+    std::future<HWITEM> result;
+
+    result = m_promise.get_future();
+    status = result.wait_for(std::chrono::seconds(5));
+
+    if (status != std::future_status::ready)
+      return (rc_t::TIMEOUT);
+
+    return (result.get().rc());
+  }
+
+  virtual void succeeded() { m_hw_item.set(rc_t::OK); }
+
+  virtual void fulfill(const HWITEM& d)
+  {
+    m_hw_item.update(d);
+    m_promise.set_value(m_hw_item);
+  }
+
+  /**
+   * Called by the mock VPP when the reply is received
+   */
+  virtual vapi_error_e operator()(MSG& reply)
+  {
+    int retval = reply.get_response().get_payload().retval;
+    m_hw_item.set(rc_t::from_vpp_retval(retval));
+    m_promise.set_value(m_hw_item);
+
+    return (VAPI_OK);
+  }
+
+protected:
+  HWITEM& m_hw_item;
+  std::promise<HWITEM> m_promise;
+};
+
+}; // namespace VOM
+
+#endif
@@ -0,0 +1,117 @@
+#ifndef __MOCK_VOM_TYPES_H__
+#define __MOCK_VOM_TYPES_H__
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/ip/address.hpp>
+
+#include <vapi/vapi.hpp>
+
+#define VAPI_CALL(_stmt)                                                       \
+  {                                                                            \
+    vapi_error_e _rv;                                                          \
+    do {                                                                       \
+      _rv = (_stmt);                                                           \
+    } while (VAPI_OK != _rv);                                                  \
+  }
+
+namespace VOM {
+
+/**
+ * Return codes of the commands
+ */
+class rc_t
+{
+public:
+  static const rc_t UNSET;
+  static const rc_t NOOP;
+  static const rc_t OK;
+  static const rc_t INVALID;
+  static const rc_t TIMEOUT;
+
+  rc_t()
+    : m_value(0)
+    , m_desc("un-set")
+  {
+  }
+
+  static const rc_t& from_vpp_retval(int32_t rv);
+
+  const std::string& to_string() const { return m_desc; }
+
+  bool operator==(const rc_t& o) const { return m_value == o.m_value; }
+  bool operator!=(const rc_t& o) const { return m_value != o.m_value; }
+
+private:
+  rc_t(int v, const std::string& s)
+    : m_value(v)
+    , m_desc(s)
+  {
+  }
+
+  int m_value;
+  std::string m_desc;
+};
+
+/**
+ * A VPP object index, e.g. a sw_if_index
+ */
+class handle_t
+{
+public:
+  static const handle_t INVALID;
+
+  handle_t()
+    : m_value(~0)
+  {
+  }
+  handle_t(uint32_t value)
+    : m_value(value)
+  {
+  }
+
+  uint32_t value() const { return m_value; }
+  std::string to_string() const { return std::to_string(m_value); }
+
+  bool operator==(const handle_t& o) const { return m_value == o.m_value; }
+  bool operator!=(const handle_t& o) const { return m_value != o.m_value; }
+
+private:
+  uint32_t m_value;
+};
+
+/**
+ * Protocol of a route path next-hop
+ */
+class nh_proto_t
+{
+public:
+  static const nh_proto_t IPV4;
+  static const nh_proto_t IPV6;
+
+  static const nh_proto_t& from_address(const boost::asio::ip::address& a)
+  {
+    return (a.is_v6() ? IPV6 : IPV4);
+  }
+
+  std::string to_string() const { return (m_v6 ? "ipv6" : "ipv4"); }
+
+  bool operator==(const nh_proto_t& o) const { return m_v6 == o.m_v6; }
+  bool operator!=(const nh_proto_t& o) const { return m_v6 != o.m_v6; }
+  bool operator<(const nh_proto_t& o) const { return m_v6 < o.m_v6; }
+
+private:
+  nh_proto_t(bool v6)
+    : m_v6(v6)
+  {
+  }
+
+  bool m_v6;
+};
+
+}; // namespace VOM
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __MOCK_STAT_CLIENT_H__
+#define __MOCK_STAT_CLIENT_H__
+
+/*
+ * Stand-in for the VPP stat client, serving the interface counters of
+ * mock_vpp. Vectors are laid out as VPP ones, after a length header.
+ */
+
+#include <stdint.h>
+
+#define STAT_SEGMENT_SOCKET_FILE "/run/vpp/stats.sock"
+
+typedef uint64_t counter_t;
+
+typedef struct
+{
+  counter_t packets;
+  counter_t bytes;
+} vlib_counter_t;
+
+typedef enum
+{
+  STAT_DIR_TYPE_ILLEGAL = 0,
+  STAT_DIR_TYPE_SCALAR_INDEX,
+  STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE,
+  STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED,
+  STAT_DIR_TYPE_ERROR_INDEX,
+  STAT_DIR_TYPE_NAME_VECTOR,
+} stat_directory_type_t;
+
+typedef struct
+{
+  char *name;
+  stat_directory_type_t type;
+  union
+  {
+    double scalar_value;
+    counter_t *error_vector;
+    counter_t **simple_counter_vec;
+    vlib_counter_t **combined_counter_vec;
+    uint8_t **name_vector;
+  };
+} stat_segment_data_t;
+
+int stat_segment_connect (const char *socket_name);
+void stat_segment_disconnect (void);
+uint8_t **stat_segment_string_vector (uint8_t ** string_vector,
+                                      const char *string);
+int stat_segment_vec_len (void *vec);
+void stat_segment_vec_free (void *vec);
+uint32_t *stat_segment_ls (uint8_t ** pattern);
+stat_segment_data_t *stat_segment_dump (uint32_t * counter_vec);
+void stat_segment_data_free (stat_segment_data_t * res);
+
+#endif /* __MOCK_STAT_CLIENT_H__ */
@@ -0,0 +1,428 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sysrepo_mock.h"
+
+#include <algorithm>
+#include <cstring>
+
+extern "C" {
+#include <sysrepo/values.h>
+}
+
+struct sr_change_iter_s {
+    std::vector<const sysrepo_mock::change_t*> changes;
+    size_t pos;
+};
+
+/* Any non null pointer, the plugin only hands it back */
+static int session_tag;
+/* Session of the commits, sysrepo hands the callbacks of a commit their own */
+static int commit_tag;
+
+static bool under(const std::string &path, const std::string &xpath)
+{
+    return path.compare(0, xpath.size(), xpath) == 0 &&
+           (path.size() == xpath.size() || path[xpath.size()] == '/' ||
+            path[xpath.size()] == '[');
+}
+
+sysrepo_mock& sysrepo_mock::instance()
+{
+    static sysrepo_mock mock;
+
+    return mock;
+}
+
+sr_session_ctx_t *sysrepo_mock::session()
+{
+    return (sr_session_ctx_t *) &session_tag;
+}
+
+std::string sysrepo_mock::schema_path(const std::string &xpath)
+{
+    std::string path;
+    char quote = 0;
+    int depth = 0;
+
+    path.reserve(xpath.size());
+    for (char c : xpath) {
+        if (quote) {
+            if (c == quote)
+                quote = 0;
+        } else if (depth && (c == '\'' || c == '"')) {
+            quote = c;
+        } else if (c == '[') {
+            depth++;
+        } else if (c == ']') {
+            depth--;
+        } else if (!depth) {
+            path += c;
+        }
+    }
+
+    return path;
+}
+
+void sysrepo_mock::change(sr_change_oper_t op, sr_val_t *old_val,
+                          sr_val_t *new_val)
+{
+    change_t c;
+
+    c.op = op;
+    c.old_val = old_val;
+    c.new_val = new_val;
+    c.path = schema_path(new_val ? new_val->xpath : old_val->xpath);
+    m_changes.push_back(c);
+}
+
+void sysrepo_mock::clear()
+{
+    for (auto &c : m_changes) {
+        sr_free_val(c.old_val);
+        sr_free_val(c.new_val);
+    }
+    m_changes.clear();
+}
+
+std::vector<const sysrepo_mock::change_t*>
+sysrepo_mock::changes(const std::string &xpath)
+{
+    std::vector<const change_t*> v;
+    std::string path = schema_path(xpath);
+
+    for (auto &c : m_changes) {
+        if (under(c.path, path))
+            v.push_back(&c);
+    }
+
+    return v;
+}
+
+int sysrepo_mock::commit()
+{
+    std::vector<const subscription_t*> subs, verified;
+    sr_session_ctx_t *session = (sr_session_ctx_t *) &commit_tag;
+    int rc = SR_ERR_OK;
+
+    for (auto &s : m_subscriptions) {
+        if (s.change_cb && !changes(s.xpath).empty())
+            subs.push_back(&s);
+    }
+    std::stable_sort(subs.begin(), subs.end(),
+                     [](const subscription_t *a, const subscription_t *b) {
+                         return a->priority > b->priority;
+                     });
+
+    for (auto s : subs) {
+        rc = s->change_cb(session, s->xpath.c_str(), SR_EV_VERIFY,
+                          s->private_ctx);
+        if (SR_ERR_OK != rc)
+            break;
+        verified.push_back(s);
+    }
+
+    if (SR_ERR_OK != rc) {
+        /* the subscriber that refused gets no abort */
+        for (auto s : verified)
+            s->change_cb(session, s->xpath.c_str(), SR_EV_ABORT,
+                         s->private_ctx);
+    } else {
+        for (auto s : subs) {
+            int r = s->change_cb(session, s->xpath.c_str(), SR_EV_APPLY,
+                                 s->private_ctx);
+            if (SR_ERR_OK == rc)
+                rc = r;
+        }
+    }
+
+    clear();
+
+    return rc;
+}
+
+int sysrepo_mock::get_items(const std::string &xpath, sr_val_t **values,
+                            size_t *values_cnt, uint64_t request_id)
+{
+    const subscription_t *provider = nullptr;
+    std::string path = schema_path(xpath);
+
+    /* the most specific provider, as for nested state data */
+    for (auto &s : m_subscriptions) {
+        if (s.dp_cb && under(path, s.xpath) &&
+            (!provider || provider->xpath.size() < s.xpath.size()))
+            provider = &s;
+    }
+
+    if (!provider)
+        return SR_ERR_NOT_FOUND;
+
+    if (!request_id)
+        request_id = request();
+
+    return provider->dp_cb(xpath.c_str(), values, values_cnt, request_id,
+                           xpath.c_str(), provider->private_ctx);
+}
+
+void sysrepo_mock::running(sr_val_t *val)
+{
+    m_running.push_back(val);
+}
+
+void sysrepo_mock::clear_running()
+{
+    for (auto v : m_running)
+        sr_free_val(v);
+    m_running.clear();
+}
+
+int sysrepo_mock::get_running(const std::string &xpath, sr_val_t **values,
+                              size_t *values_cnt)
+{
+    std::vector<sr_val_t> found;
+    std::string path = xpath;
+
+    /* all the nodes of a module, selected by "/module:" then any path */
+    if (path.size() > 4 && path.compare(path.size() - 4, 4, "*//*") == 0)
+        path.erase(path.size() - 4);
+    path = schema_path(path);
+
+    for (auto v : m_running) {
+        /* a module prefix has no predicate to strip */
+        if (path.back() == ':' ? strncmp(v->xpath, path.c_str(),
+                                         path.size()) == 0
+                               : under(schema_path(v->xpath), path))
+            found.push_back(*v);
+    }
+
+    *values = nullptr;
+    *values_cnt = 0;
+    if (found.empty())
+        return SR_ERR_NOT_FOUND;
+
+    /* copies, the caller frees them */
+    *values_cnt = found.size();
+
+    return sr_dup_values(found.data(), found.size(), values);
+}
+
+void sysrepo_mock::subscribe(const subscription_t &s)
+{
+    m_subscriptions.push_back(s);
+}
+
+void sysrepo_mock::unsubscribe()
+{
+    m_subscriptions.clear();
+}
+
+void sysrepo_mock::notify(const notif_t &n)
+{
+    std::lock_guard<std::mutex> lg(m_notif_lock);
+
+    m_notifications.push_back(n);
+}
+
+std::vector<sysrepo_mock::notif_t> sysrepo_mock::notifications()
+{
+    std::lock_guard<std::mutex> lg(m_notif_lock);
+    std::vector<notif_t> v;
+
+    v.swap(m_notifications);
+
+    return v;
+}
+
+sr_val_t *sysrepo_mock::val(const std::string &xpath, sr_type_t type,
+                            const std::string &str)
+{
+    sr_val_t *v = nullptr;
+
+    sr_new_val(xpath.c_str(), &v);
+    sr_val_set_str_data(v, type, str.c_str());
+
+    return v;
+}
+
+sr_val_t *sysrepo_mock::val(const std::string &xpath, bool b)
+{
+    sr_val_t *v = nullptr;
+
+    sr_new_val(xpath.c_str(), &v);
+    v->type = SR_BOOL_T;
+    v->data.bool_val = b;
+
+    return v;
+}
+
+sr_val_t *sysrepo_mock::val(const std::string &xpath, uint8_t u8)
+{
+    sr_val_t *v = nullptr;
+
+    sr_new_val(xpath.c_str(), &v);
+    v->type = SR_UINT8_T;
+    v->data.uint8_val = u8;
+
+    return v;
+}
+
+sr_val_t *sysrepo_mock::val(const std::string &xpath, uint32_t u32)
+{
+    sr_val_t *v = nullptr;
+
+    sr_new_val(xpath.c_str(), &v);
+    v->type = SR_UINT32_T;
+    v->data.uint32_val = u32;
+
+    return v;
+}
+
+sr_val_t *sysrepo_mock::list(const std::string &xpath)
+{
+    sr_val_t *v = nullptr;
+
+    sr_new_val(xpath.c_str(), &v);
+    v->type = SR_LIST_T;
+
+    return v;
+}
+
+/*
+ * Replacements of libsysrepo functions, which take precedence over the
+ * library ones when linked into the executable.
+ */
+extern "C" {
+
+int sr_subtree_change_subscribe(sr_session_ctx_t *session, const char *xpath,
+                                sr_subtree_change_cb callback,
+                                void *private_ctx, uint32_t priority,
+                                sr_subscr_options_t opts,
+                                sr_subscription_ctx_t **subscription)
+{
+    (void) session; (void) opts;
+    sysrepo_mock::subscription_t s = { xpath, callback, nullptr, private_ctx,
+                                       priority };
+
+    sysrepo_mock::instance().subscribe(s);
+    *subscription = (sr_subscription_ctx_t *) &session_tag;
+
+    return SR_ERR_OK;
+}
+
+int sr_dp_get_items_subscribe(sr_session_ctx_t *session, const char *xpath,
+                              sr_dp_get_items_cb callback, void *private_ctx,
+                              sr_subscr_options_t opts,
+                              sr_subscription_ctx_t **subscription)
+{
+    (void) session; (void) opts;
+    sysrepo_mock::subscription_t s = { xpath, nullptr, callback, private_ctx,
+                                       0 };
+
+    sysrepo_mock::instance().subscribe(s);
+    *subscription = (sr_subscription_ctx_t *) &session_tag;
+
+    return SR_ERR_OK;
+}
+
+int sr_unsubscribe(sr_session_ctx_t *session,
+                   sr_subscription_ctx_t *subscription)
+{
+    (void) session; (void) subscription;
+
+    sysrepo_mock::instance().unsubscribe();
+
+    return SR_ERR_OK;
+}
+
+int sr_get_changes_iter(sr_session_ctx_t *session, const char *xpath,
+                        sr_change_iter_t **iteration)
+{
+    (void) session;
+
+    *iteration = new sr_change_iter_s();
+    (*iteration)->changes = sysrepo_mock::instance().changes(xpath);
+    (*iteration)->pos = 0;
+
+    return SR_ERR_OK;
+}
+
+int sr_get_change_next(sr_session_ctx_t *session, sr_change_iter_t *iter,
+                       sr_change_oper_t *operation, sr_val_t **old_value,
+                       sr_val_t **new_value)
+{
+    (void) session;
+
+    if (iter->pos >= iter->changes.size())
+        return SR_ERR_NOT_FOUND;
+
+    /* values are the caller's to free, as sysrepo hands out copies */
+    const sysrepo_mock::change_t *c = iter->changes[iter->pos++];
+    *operation = c->op;
+    *old_value = nullptr;
+    *new_value = nullptr;
+    if (c->old_val)
+        sr_dup_val(c->old_val, old_value);
+    if (c->new_val)
+        sr_dup_val(c->new_val, new_value);
+
+    return SR_ERR_OK;
+}
+
+void sr_free_change_iter(sr_change_iter_t *iter)
+{
+    delete iter;
+}
+
+int sr_get_items(sr_session_ctx_t *session, const char *xpath,
+                 sr_val_t **values, size_t *value_cnt)
+{
+    (void) session;
+
+    return sysrepo_mock::instance().get_running(xpath, values, value_cnt);
+}
+
+int sr_session_set_options(sr_session_ctx_t *session,
+                           const sr_sess_options_t opts)
+{
+    (void) session; (void) opts;
+
+    return SR_ERR_OK;
+}
+
+int sr_event_notif_send(sr_session_ctx_t *session, const char *xpath,
+                        const sr_val_t *values, const size_t values_cnt,
+                        sr_ev_notif_flag_t opts)
+{
+    (void) session; (void) opts;
+    sysrepo_mock::notif_t n = { xpath, nullptr, values_cnt };
+
+    /* values are the caller's, as sysrepo copies them */
+    if (values_cnt)
+        sr_dup_values(values, values_cnt, &n.values);
+    sysrepo_mock::instance().notify(n);
+
+    return SR_ERR_OK;
+}
+
+int sr_set_error(sr_session_ctx_t *session, const char *message,
+                 const char *xpath)
+{
+    (void) session; (void) message; (void) xpath;
+
+    return SR_ERR_OK;
+}
+
+} /* extern "C" */
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SYSREPO_MOCK_H__
+#define __SYSREPO_MOCK_H__
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <sysrepo.h>
+}
+
+/*
+ * Stand-in for the sysrepo daemon side of the plugin API.
+ *
+ * The subscription and change iteration functions of libsysrepo are
+ * replaced in sweetcomb-bench: subscribing records the callback, and a
+ * commit plays a change stream built by the bench to the subscribers, as
+ * sysrepo does. The running datastore read by the plugin is the one set by
+ * the bench. Notifications sent are kept for the bench to check. The
+ * values and xpath helpers of libsysrepo are used as is.
+ */
+class sysrepo_mock {
+public:
+    static sysrepo_mock& instance();
+
+    /* Session handed to the plugin */
+    sr_session_ctx_t *session();
+
+    /* Append a change to the next commit, the values are taken over */
+    void change(sr_change_oper_t op, sr_val_t *old_val, sr_val_t *new_val);
+
+    /* Number of changes of the next commit */
+    size_t changes() const { return m_changes.size(); }
+
+    /* Play the changes to the subscribers, in priority order, with
+     * SR_EV_VERIFY then SR_EV_APPLY, or SR_EV_ABORT if one refused them.
+     * Return the first error. */
+    int commit();
+
+    /* Drop the changes without playing them */
+    void clear();
+
+    /* Get state data under xpath from the provider subscribed to it, as
+     * part of request request_id, a new request if 0 */
+    int get_items(const std::string &xpath, sr_val_t **values,
+                  size_t *values_cnt, uint64_t request_id = 0);
+
+    /* Identifier of a new request, to share between get_items() calls */
+    uint64_t request() { return ++m_request_id; }
+
+    /* Add a value to the running datastore, it is taken over */
+    void running(sr_val_t *val);
+
+    /* Empty the running datastore */
+    void clear_running();
+
+    /* Copy the running datastore under xpath, as sr_get_items() does */
+    int get_running(const std::string &xpath, sr_val_t **values,
+                    size_t *values_cnt);
+
+    /* A notification sent by the plugin */
+    struct notif_t {
+        std::string xpath;
+        sr_val_t *values;
+        size_t values_cnt;
+    };
+
+    /* Take the notifications sent so far, the values are the caller's to
+     * free */
+    std::vector<notif_t> notifications();
+
+    /* Build values */
+    static sr_val_t *val(const std::string &xpath, sr_type_t type,
+                         const std::string &str);
+    static sr_val_t *val(const std::string &xpath, bool b);
+    static sr_val_t *val(const std::string &xpath, uint8_t u8);
+    static sr_val_t *val(const std::string &xpath, uint32_t u32);
+    static sr_val_t *list(const std::string &xpath);
+
+    /* xpath without its predicates */
+    static std::string schema_path(const std::string &xpath);
+
+    /* Called by the libsysrepo replacements */
+    struct change_t {
+        sr_change_oper_t op;
+        sr_val_t *old_val;
+        sr_val_t *new_val;
+        std::string path; //schema path
+    };
+
+    struct subscription_t {
+        std::string xpath;
+        sr_subtree_change_cb change_cb;
+        sr_dp_get_items_cb dp_cb;
+        void *private_ctx;
+        uint32_t priority;
+    };
+
+    void subscribe(const subscription_t &s);
+    void notify(const notif_t &n);
+    void unsubscribe();
+    std::vector<const change_t*> changes(const std::string &xpath);
+
+private:
+    sysrepo_mock() : m_request_id(0) {}
+
+    std::vector<change_t> m_changes;
+    std::vector<subscription_t> m_subscriptions;
+    std::vector<sr_val_t*> m_running;
+    uint64_t m_request_id;
+    /* sent from threads of the plugin */
+    std::mutex m_notif_lock;
+    std::vector<notif_t> m_notifications;
+};
+
+#endif /* __SYSREPO_MOCK_H__ */
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* utils::schema_dispatch, which the change callbacks find their nodes
+ * with */
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "alloc_count.h"
+#include "bench.h"
+#include "sys_util.h"
+
+using namespace std::chrono;
+
+namespace bench {
+
+/* Expected behavior of utils::schema_dispatch */
+void dispatch_checks()
+{
+    const utils::schema_dispatch d = {
+        { "/m:a/b/c", 1 }, { "/m:a/b/n:d", 2 }, { "/m:a/b", 3 },
+    };
+    const struct {
+        const char *xpath;
+        int id;
+        size_t keys;
+        const char *last;
+    } matches[] = {
+        { "/m:a/b[k='v']/c", 1, 1, "v" },
+        { "/m:a/b[k=\"v\"]/n:d", 2, 1, "v" },
+        { "/m:a/b[k='x/y]z'][l='2']", 3, 2, "2" },
+        { "/m:a/b[k='v']/e", -1, 1, "v" },
+        { "/m:a/b[k='v']/c/e", -1, 1, "v" },
+        { "/m:a/b[k='v']x/c", -1, 1, "v" },
+        { "/m:a/b[k=v]/c", -1, 0, "" },
+        { "/m:a/b[k='v/c", -1, 0, "" },
+        { "/m:a", -1, 0, "" },
+        { "/n:a/b/c", -1, 0, "" },
+        { "", -1, 0, "" },
+    };
+    utils::xpath_keys keys;
+
+    for (auto &t : matches) {
+        int id = d.match(t.xpath, keys);
+        check(id == t.id && keys.size() == t.keys &&
+              keys.value(keys.size() ? keys.size() - 1 : 0) == t.last,
+              std::string("schema dispatch ") + t.xpath, 0);
+    }
+
+    d.match("/m:a/b[k='v'][l='w']/c", keys);
+    check(keys.value("l") == "w" && keys.value("k") == "v" &&
+          keys.value("x").empty() && keys.value(2).empty(),
+          "schema dispatch keys by name", 0);
+}
+
+/* Find the leaf and the interface name of n interface changes */
+void dispatch_bench(size_t n)
+{
+    enum { NAME, TYPE, ENABLED };
+    const utils::schema_dispatch d = {
+        { "/ietf-interfaces:interfaces/interface/name", NAME },
+        { "/ietf-interfaces:interfaces/interface/type", TYPE },
+        { "/ietf-interfaces:interfaces/interface/enabled", ENABLED },
+    };
+    const char *leaves[] = { "name", "type", "enabled" };
+    std::vector<std::string> xpaths;
+    utils::xpath_keys keys;
+    size_t found = 0;
+
+    for (size_t i = 0; i < n; i++)
+        xpaths.push_back(itf_xpath(i) + "/" + leaves[i % 3]);
+
+    uint64_t allocs = alloc_count();
+    steady_clock::time_point start = steady_clock::now();
+    for (auto &x : xpaths) {
+        int leaf = d.match(x.c_str(), keys);
+        found += (leaf >= 0) + (keys.size() == 1);
+    }
+    nanoseconds t = steady_clock::now() - start;
+    record("schema dispatch", n, t, alloc_count() - allocs);
+    check(found == 2 * n, "schema dispatch", n);
+
+    /* what utils::schema_dispatch replaced */
+    found = 0;
+    allocs = alloc_count();
+    start = steady_clock::now();
+    for (auto &x : xpaths) {
+        sr_xpath_ctx_t ctx;
+        char *xpath = &x[0];
+        char *key = sr_xpath_key_value(xpath, "interface", "name", &ctx);
+        found += (key != nullptr);
+        sr_xpath_recover(&ctx);
+        if (sr_xpath_node_name_eq(xpath, "name") ||
+            sr_xpath_node_name_eq(xpath, "type") ||
+            sr_xpath_node_name_eq(xpath, "enabled"))
+            found++;
+    }
+    t = steady_clock::now() - start;
+    record("schema dispatch (sr_xpath)", n, t, alloc_count() - allocs);
+    check(found == 2 * n, "schema dispatch (sr_xpath)", n);
+}
+
+} // namespace bench
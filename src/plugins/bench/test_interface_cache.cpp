@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* interface_cache, kept up to date by the VPP interface events */
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include <vpp-oper/interface_cache.hpp>
+
+#include "bench.h"
+#include "mock_vpp.hpp"
+
+using namespace std::chrono;
+
+namespace bench {
+
+/* Admin status changes of VPP interfaces while two reads dump them at
+ * once: the cache ends with the last status of each */
+void interface_cache_checks()
+{
+    const size_t N_ITFS = 8, ROUNDS = 50;
+    mock_vpp &vpp = mock_vpp::instance();
+    interface_cache &cache = interface_cache::instance();
+    std::map<uint32_t, interface_cache::details_t> dump;
+    std::vector<uint32_t> idx;
+    std::vector<sr::notif_t> all;
+    size_t ok = 0;
+
+    for (size_t i = 0; i < N_ITFS; i++)
+        idx.push_back(vpp.add_interface("sync" + std::to_string(i)));
+    cache.invalidate();
+    cache.read([](const interface_cache::table_t &) {});
+
+    /* dumps slow enough for the events and the other read to overlap them */
+    vapi::Connection::latency() = microseconds(200);
+    for (size_t r = 0; r < ROUNDS; r++) {
+        std::vector<std::thread> readers;
+        std::atomic<int> done(0);
+
+        cache.invalidate();
+        for (int t = 0; t < 2; t++)
+            readers.emplace_back([&cache, &done]() {
+                cache.read([](const interface_cache::table_t &) {});
+                done++;
+            });
+        for (size_t k = 0; done < 2; k++) {
+            vpp.set_admin(idx[k % N_ITFS], (r + k / N_ITFS) % 2);
+            std::this_thread::sleep_for(microseconds(20));
+        }
+        for (auto &t : readers)
+            t.join();
+    }
+    vapi::Connection::latency() = microseconds(0);
+
+    dump = vpp.dump();
+    for (auto sw_if_index : idx) {
+        interface_cache::details_t d;
+
+        ok += (cache.find(sw_if_index, d) &&
+               d.flags == dump[sw_if_index].flags);
+    }
+    check(ok == N_ITFS, "interface events during concurrent syncs", N_ITFS);
+
+    /* the admin state set behind sweetcomb's back is read as soon as VPP
+     * has sent its event */
+    ok = 0;
+    for (bool up : { false, true, false }) {
+        sr_val_t *val = nullptr;
+        size_t cnt = 0;
+
+        vpp.set_admin(idx[0], up);
+        if (SR_ERR_OK != sr::instance().get_items(
+                "/ietf-interfaces:interfaces-state/interface[name='sync0']",
+                &val, &cnt))
+            continue;
+        for (size_t i = 0; i < cnt; i++) {
+            if (strstr(val[i].xpath, "/admin-status") &&
+                !strcmp(val[i].data.enum_val, up ? "up" : "down"))
+                ok++;
+        }
+        sr_free_values(val, cnt);
+    }
+    check(3 == ok, "admin-status read after interface event", 1);
+
+    for (auto sw_if_index : idx)
+        vpp.del_interface(sw_if_index);
+    /* their notifications are not the ones of the runs */
+    all = notifications(STATE_CHANGE, SIZE_MAX, milliseconds(400));
+    free_notifications(all);
+}
+
+} // namespace bench
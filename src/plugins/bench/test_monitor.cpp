@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* sc_vpp_monitor and the health check of the plugin */
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "sc_connection.h"
+#include "sc_plugins.h"
+#include "sc_vpp_monitor.h"
+
+using namespace std::chrono;
+
+namespace bench {
+
+/* Start a process running cmd, which stops itself until killed */
+static pid_t dummy_start(const std::string &cmd)
+{
+    const char *argv0 = cmd.c_str();
+    pid_t pid = fork();
+
+    if (0 == pid) {
+        execl("/bin/sh", argv0, "-c", "kill -STOP $$", (char *) nullptr);
+        _exit(127);
+    }
+
+    return pid;
+}
+
+/* sc_vpp_monitor watches the process it found until it dies, then the
+ * next one. Without VPP process, the health check does not take VPP for
+ * crashed. */
+void monitor_checks()
+{
+    std::string cmd = "sweetcomb-bench-vpp" + std::to_string(getpid());
+    uint32_t connects = sc_connection::instance().stats().connects;
+    sc_vpp_monitor monitor(cmd);
+
+    check(monitor.attach() < 0 && !monitor.alive(), "monitor without process",
+          0);
+
+    for (size_t i = 0; i < 2; i++) {
+        pid_t pid = dummy_start(cmd);
+        int found = -1;
+
+        /* the child runs cmd once it has called exec */
+        for (int t = 0; t < 200 && found != pid; t++) {
+            found = monitor.attach();
+            if (found != pid)
+                std::this_thread::sleep_for(milliseconds(5));
+        }
+        check(pid > 0 && found == pid && monitor.alive(), "monitor attach",
+              i);
+
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+        check(!monitor.alive() && monitor.pid() == pid,
+              "monitor sees process killed", i);
+    }
+    monitor.detach();
+
+    /* the bench is not VPP, the monitor of the plugin found no process */
+    for (int i = 0; i < 3; i++)
+        sr_plugin_health_check_cb(sr::instance().session(), nullptr);
+    check(sc_connection::instance().is_connected() &&
+          sc_connection::instance().stats().connects == connects,
+          "health check without VPP process", 0);
+}
+
+} // namespace bench
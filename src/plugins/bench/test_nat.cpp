@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* NAT static mappings, their bulk load and the NAT state read from VPP */
+
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <arpa/inet.h>
+
+#include "bench.h"
+#include "mock_vpp.hpp"
+#include "sc_dispatcher.h"
+
+using namespace std::chrono;
+
+namespace bench {
+
+static std::string nat_xpath(size_t i)
+{
+    return "/ietf-nat:nat/instances/instance[id='1']/mapping-table/"
+           "mapping-entry[index='" + std::to_string(i) + "']";
+}
+
+static const std::string NAT_STATE =
+    "/ietf-nat:nat/instances/instance[id='1']/sweetcomb-nat:nat-state";
+
+/* Sessions or static mappings replied at most by one get, as in
+ * ietf_nat.cpp */
+static const size_t NAT_ENTRIES_MAX = 16384;
+
+/* Sessions of a mock NAT user */
+static const size_t NAT_USER_SESSIONS = 100;
+
+/* Queue the creation of NAT mapping i of in to out */
+static void nat_create(size_t i, const std::string &in, const std::string &out)
+{
+    std::string x = nat_xpath(i);
+
+    sr::instance().change(SR_OP_CREATED, nullptr, sr::list(x));
+    sr::instance().change(SR_OP_CREATED, nullptr,
+                          sr::val(x + "/index", (uint32_t) i));
+    sr::instance().change(SR_OP_CREATED, nullptr,
+                          sr::val(x + "/type", SR_ENUM_T, "static"));
+    sr::instance().change(SR_OP_CREATED, nullptr,
+                          sr::val(x + "/internal-src-address", SR_STRING_T,
+                                  in));
+    sr::instance().change(SR_OP_CREATED, nullptr,
+                          sr::val(x + "/external-src-address", SR_STRING_T,
+                                  out));
+}
+
+/* Queue the deletion of NAT mapping i */
+static void nat_delete(size_t i)
+{
+    std::string x = nat_xpath(i);
+
+    sr::instance().change(SR_OP_DELETED, sr::list(x), nullptr);
+    sr::instance().change(SR_OP_DELETED, sr::val(x + "/index", (uint32_t) i),
+                          nullptr);
+}
+
+/* Static mappings of the n bench addresses, created, read back and
+ * deleted */
+void nat_mappings(size_t n)
+{
+    mock_vpp &vpp = mock_vpp::instance();
+
+    for (size_t i = 0; i < n; i++)
+        nat_create(i, ip4(10, i) + "/32", ip4(192, i) + "/32");
+    commit("nat mapping create", n);
+    check(vpp.nats() == n, "NAT mappings in VPP", n);
+    if (n <= NAT_ENTRIES_MAX)
+        check(get("nat static-mapping state", n,
+                  { NAT_STATE + "/static-mapping" }) == 3 * n,
+              "NAT static-mapping state", n);
+    else
+        check(get_count(NAT_STATE + "/static-mapping") < 0,
+              "NAT static mappings beyond the bound", n);
+
+    for (size_t i = 0; i < n; i++)
+        nat_delete(i);
+    commit("nat mapping delete", n);
+    check(vpp.nats() == 0, "NAT mappings left in VPP", n);
+}
+
+/* Add n NAT44 sessions to VPP, NAT_USER_SESSIONS per inside address */
+static void session_add(size_t n)
+{
+    mock_vpp::session_t s;
+
+    memset(&s, 0, sizeof(s));
+    for (size_t i = 0; i < n; i++) {
+        size_t user = i / NAT_USER_SESSIONS;
+
+        inet_pton(AF_INET, ip4(10, user).c_str(), s.inside_ip_address);
+        inet_pton(AF_INET, ip4(192, user).c_str(), s.outside_ip_address);
+        inet_pton(AF_INET, "8.8.8.8", s.ext_host_address);
+        s.inside_port = 1024 + i % NAT_USER_SESSIONS;
+        s.outside_port = 1024 + i % NAT_USER_SESSIONS;
+        s.ext_host_port = 443;
+        s.protocol = 6;
+        s.total_bytes = i;
+        s.total_pkts = i;
+        mock_vpp::instance().add_session(s);
+    }
+}
+
+/* NAT44 sessions read from VPP, NAT_USER_SESSIONS per inside address */
+void nat_sessions(size_t n)
+{
+    mock_vpp &vpp = mock_vpp::instance();
+    size_t one = std::min(n, NAT_USER_SESSIONS);
+    std::string key;
+
+    session_add(n);
+
+    if (n <= NAT_ENTRIES_MAX)
+        check(get("nat sessions all", n, { NAT_STATE + "/session" }) ==
+              6 * n, "NAT sessions", n);
+    else
+        check(get_count(NAT_STATE + "/session") < 0,
+              "NAT sessions beyond the bound", n);
+
+    key = "/session[inside-address='" + ip4(10, 0) + "']";
+    check(get("nat sessions of one address", one, { NAT_STATE + key }) ==
+          6 * one, "NAT sessions of one address", n);
+
+    key += "[protocol='6'][inside-port='1024']";
+    check(get("nat session by key", 1, { NAT_STATE + key }) == 6,
+          "NAT session by key", n);
+
+    check(get("nat state counters", n, { NAT_STATE }) == 2, "NAT counters",
+          n);
+
+    vpp.clear_sessions();
+}
+
+/* Reads selecting more sessions or static mappings than a reply holds
+ * fail rather than reply part of them, reads by address still work */
+void nat_bound_checks()
+{
+    static const size_t N = NAT_ENTRIES_MAX + 1;
+    mock_vpp &vpp = mock_vpp::instance();
+    std::vector<mock_vpp::nat_pair_t> pairs;
+    std::string key = "[inside-address='" + ip4(10, 1) + "']";
+
+    session_add(N);
+    check(get_count(NAT_STATE + "/session") < 0,
+          "NAT sessions beyond the bound", N);
+    check(get_count(NAT_STATE + "/session[protocol='6']") < 0,
+          "NAT sessions of a protocol beyond the bound", N);
+    check(get_count(NAT_STATE + "/session" + key) ==
+          (long) (6 * NAT_USER_SESSIONS),
+          "NAT sessions of one address beyond the bound", N);
+    vpp.clear_sessions();
+
+    /* mappings only read back, not configured */
+    for (size_t i = 0; i < N; i++) {
+        pairs.emplace_back(boost::asio::ip::address::from_string(ip4(10, i)),
+                           boost::asio::ip::address::from_string(
+                               ip4(192, i)));
+        vpp.add_nat(pairs.back());
+    }
+    key = "[internal-address='" + ip4(10, 1) + "']";
+    check(get_count(NAT_STATE + "/static-mapping") < 0,
+          "NAT static mappings beyond the bound", N);
+    check(get_count(NAT_STATE + "/static-mapping" + key) == 3,
+          "NAT static mapping by address beyond the bound", N);
+    for (auto &p : pairs)
+        vpp.del_nat(p);
+}
+
+/* Load of a large NAT mapping table in one commit, then commits that
+ * conflict with it */
+void nat_bulk(size_t n)
+{
+    mock_vpp &vpp = mock_vpp::instance();
+
+    for (size_t i = 0; i < n; i++)
+        nat_create(i, ip4(10, i) + "/32", ip4(192, i) + "/32");
+    /* reads are served while the workers program VPP, and dump it on
+     * connections of their own */
+    commit("nat bulk load", n, []() {
+        get("nat state read during nat load", 1, { NAT_STATE });
+    });
+    check(vpp.nats() == n, "NAT bulk load in VPP", n);
+
+    /* an inside, an outside address already mapped, one mapped twice */
+    nat_create(n, ip4(10, 0) + "/32", ip4(172, 0) + "/32");
+    check(SR_ERR_OK != sr::instance().commit(), "NAT inside conflict", n);
+    nat_create(n, ip4(172, 0) + "/32", ip4(192, 0) + "/32");
+    check(SR_ERR_OK != sr::instance().commit(), "NAT outside conflict", n);
+    nat_create(n, ip4(172, 0) + "/32", ip4(172, 1) + "/32");
+    nat_create(n + 1, ip4(172, 0) + "/32", ip4(172, 2) + "/32");
+    check(SR_ERR_OK != sr::instance().commit(), "NAT duplicate in commit", n);
+    sc_dispatcher::instance().wait();
+    check(vpp.nats() == n, "NAT mappings after conflicts", n);
+
+    /* an address freed by the same commit can be mapped again */
+    nat_delete(0);
+    nat_create(n, ip4(10, 0) + "/32", ip4(172, 0) + "/32");
+    check(SR_ERR_OK == sr::instance().commit(), "NAT address reuse", n);
+    sc_dispatcher::instance().wait();
+    check(vpp.nats() == n, "NAT mappings after reuse", n);
+
+    /* one leaf created in, then one changed in an existing entry */
+    std::string x = nat_xpath(1);
+    sr::instance().change(SR_OP_CREATED, nullptr,
+                          sr::val(x + "/external-dst-address", SR_STRING_T,
+                                  ip4(172, 1) + "/32"));
+    check(SR_ERR_OK == sr::instance().commit(), "NAT leaf created", n);
+    sr::instance().change(SR_OP_MODIFIED,
+                          sr::val(x + "/external-src-address", SR_STRING_T,
+                                  ip4(192, 1) + "/32"),
+                          sr::val(x + "/external-src-address", SR_STRING_T,
+                                  ip4(172, 2) + "/32"));
+    check(SR_ERR_OK == sr::instance().commit(), "NAT leaf modified", n);
+    sc_dispatcher::instance().wait();
+    check(vpp.nats() == n &&
+          vpp.has_nat({ boost::asio::ip::address::from_string(ip4(10, 1)),
+                        boost::asio::ip::address::from_string(
+                            ip4(172, 2)) }), "NAT mapping of leaf changed", n);
+
+    for (size_t i = 1; i <= n; i++)
+        nat_delete(i);
+    commit("nat bulk delete", n);
+    check(vpp.nats() == 0, "NAT bulk mappings left in VPP", n);
+}
+
+} // namespace bench
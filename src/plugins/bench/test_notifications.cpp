@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Notifications of the interface state changes and of the counters
+ * telemetry */
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <vpp-oper/interface_cache.hpp>
+
+#include "alloc_count.h"
+#include "bench.h"
+#include "mock_vpp.hpp"
+#include "sys_util.h"
+
+using namespace std::chrono;
+
+namespace bench {
+
+static const std::string COUNTERS = "/sweetcomb-interfaces:interface-counters";
+static const std::string TELEMETRY = "/sweetcomb-interfaces:counters-telemetry";
+
+/* Link flaps of the first interface in state_changes() */
+static const uint32_t LINK_FLAPS = 3;
+/* Interval of interface-counters set by telemetry(), in ms */
+static const uint32_t TELEMETRY_INTERVAL = 100;
+
+/* Leaf of a notification, nullptr if missing */
+static const sr_val_t *notif_leaf(const sr::notif_t &notif, const char *leaf)
+{
+    for (size_t i = 0; i < notif.values_cnt; i++) {
+        if (sr_xpath_node_name_eq(notif.values[i].xpath, leaf))
+            return &notif.values[i];
+    }
+
+    return nullptr;
+}
+
+/* Links of the n bench interfaces going down as reported by VPP, the first
+ * one flapping meanwhile: one interface-state-change each is expected, the
+ * flaps coalesced */
+void state_changes(size_t n)
+{
+    mock_vpp &vpp = mock_vpp::instance();
+    std::vector<uint32_t> idx;
+    std::vector<sr::notif_t> all;
+
+    /* events reach the cache for the interfaces it knows */
+    interface_cache::instance().read([](const interface_cache::table_t &) {});
+    all = notifications(STATE_CHANGE, 0, milliseconds(0));
+    free_notifications(all);
+
+    for (size_t i = 0; i < n; i++)
+        idx.push_back(vpp.add_interface("bench" + std::to_string(i)));
+
+    uint64_t allocs = alloc_count();
+    steady_clock::time_point start = steady_clock::now();
+    for (uint32_t f = 0; f < LINK_FLAPS; f++) {
+        vpp.set_link(idx[0], false);
+        vpp.set_link(idx[0], true);
+    }
+    for (size_t i = 0; i < n; i++)
+        vpp.set_link(idx[i], false);
+    nanoseconds t = steady_clock::now() - start;
+    record("interface link events", n, t, alloc_count() - allocs);
+
+    all = notifications(STATE_CHANGE, n,
+                        milliseconds(NOTIF_DEBOUNCE * 10 + n / 10));
+    check(all.size() == n, "interface-state-change sent", n);
+
+    size_t ok = 0;
+    for (auto &notif : all) {
+        const sr_val_t *name = notif_leaf(notif, "name");
+        const sr_val_t *oper = notif_leaf(notif, "oper-status");
+        const sr_val_t *tr = notif_leaf(notif, "transitions");
+        uint32_t expected = 1;
+
+        if (!name || !oper || !tr)
+            continue;
+        if (0 == strcmp(name->data.string_val, "bench0"))
+            expected += 2 * LINK_FLAPS;
+        ok += (0 == strcmp(oper->data.enum_val, "down") &&
+               expected == tr->data.uint32_val);
+    }
+    check(ok == n, "interface-state-change coalesced", n);
+    free_notifications(all);
+}
+
+/* Set or, with interval 0, remove the counters telemetry configuration */
+static void telemetry_config(uint32_t interval, bool changed_only)
+{
+    if (interval) {
+        sr::instance().change(SR_OP_CREATED, nullptr,
+                              sr::val(TELEMETRY + "/interval", interval));
+        sr::instance().change(SR_OP_CREATED, nullptr,
+                              sr::val(TELEMETRY + "/changed-only",
+                                      changed_only));
+    } else {
+        sr::instance().change(SR_OP_DELETED,
+                              sr::val(TELEMETRY + "/interval",
+                                      TELEMETRY_INTERVAL), nullptr);
+        sr::instance().change(SR_OP_DELETED,
+                              sr::val(TELEMETRY + "/changed-only", true),
+                              nullptr);
+    }
+
+    check(SR_ERR_OK == sr::instance().commit(), "telemetry configuration", 0);
+}
+
+/* Counters of all the interfaces sent periodically, then, in changed-only
+ * mode, those of the one interface receiving traffic */
+void telemetry(size_t n)
+{
+    mock_vpp &vpp = mock_vpp::instance();
+    uint32_t bench0 = vpp.add_interface("bench0");
+    size_t itfs = vpp.interfaces();
+    milliseconds timeout(TELEMETRY_INTERVAL * 10);
+    std::vector<sr::notif_t> all;
+    sr_val_t *values = nullptr;
+    size_t cnt = 0;
+
+    telemetry_config(TELEMETRY_INTERVAL, false);
+    all = notifications(COUNTERS, 1, timeout);
+    check(all.size() == 1 && all[0].values_cnt == itfs * 8,
+          "interface-counters of all interfaces", n);
+    free_notifications(all);
+
+    /* cost of a sample, as published by the plugin */
+    if (SR_ERR_OK == sr::instance().get_items(TELEMETRY + "-state",
+                                              &values, &cnt)) {
+        for (size_t i = 0; i < cnt; i++) {
+            if (sr_xpath_node_name_eq(values[i].xpath, "last-sample-time"))
+                record("interface-counters sample", n,
+                       microseconds(values[i].data.uint64_val), 0);
+        }
+        sr_free_values(values, cnt);
+    }
+
+    /* sent in full once, then only what changed */
+    telemetry_config(TELEMETRY_INTERVAL, true);
+    all = notifications(COUNTERS, 1, timeout);
+    free_notifications(all);
+    vpp.add_traffic(bench0, 10);
+    all = notifications(COUNTERS, 1, timeout);
+
+    size_t others = 0;
+    for (auto &notif : all) {
+        for (size_t i = 0; i < notif.values_cnt; i++)
+            others += (nullptr == strstr(notif.values[i].xpath, "'bench0'"));
+    }
+    check(all.size() == 1 && all[0].values_cnt == 8 && 0 == others,
+          "interface-counters changed only", n);
+    free_notifications(all);
+
+    telemetry_config(0, false);
+}
+
+} // namespace bench
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* State of openconfig-interfaces */
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "mock_vpp.hpp"
+#include "sc_request.h"
+
+using namespace std::chrono;
+
+namespace bench {
+
+/* Counters and subinterfaces of openconfig-interfaces, each get of the n
+ * interfaces as one request, as a collector polling them makes */
+void openconfig_state(size_t n)
+{
+    const std::string OC_INTERFACE =
+        "/openconfig-interfaces:interfaces/interface";
+    mock_vpp &vpp = mock_vpp::instance();
+    std::vector<std::string> xpaths;
+    std::vector<uint32_t> subs;
+    uint64_t taken;
+
+    for (size_t i = 0; i < n; i++)
+        xpaths.push_back(OC_INTERFACE + "[name='bench" + std::to_string(i) +
+                         "']/state/counters");
+    taken = sc_request::taken();
+    check(get("oc counters, 1 request", n, xpaths,
+              sr::instance().request()) == 13 * n,
+          "openconfig counters", n);
+    check(sc_request::taken() - taken == 1, "snapshots of one request", n);
+
+    /* VLAN 100 on each interface, VPP does not signal its creation */
+    for (size_t i = 0; i < n; i++)
+        subs.push_back(vpp.add_sub_interface(
+            vpp.add_interface("bench" + std::to_string(i)), 100));
+    interface_cache::instance().invalidate();
+    /* nor will a stats snapshot taken before have their counters */
+    std::this_thread::sleep_for(interface_stats::MAX_AGE);
+
+    /* state of subinterface 0, the interface itself, and of 100 */
+    xpaths.clear();
+    for (size_t i = 0; i < n; i++) {
+        std::string subif = OC_INTERFACE + "[name='bench" +
+                            std::to_string(i) +
+                            "']/subinterfaces/subinterface";
+
+        xpaths.push_back(subif + "[index='0']/state");
+        xpaths.push_back(subif + "[index='100']/state");
+        xpaths.push_back(subif + "[index='100']/state/counters");
+    }
+    check(get("oc subif state, 1 request", n, xpaths,
+              sr::instance().request()) == (6 + 6 + 13) * n,
+          "openconfig subinterface state", n);
+
+    for (auto sw_if_index : subs)
+        vpp.del_interface(sw_if_index);
+}
+
+} // namespace bench
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Requests pipelined on a VAPI connection by cmd_window */
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <vpp-oper/cmd_window.hpp>
+#include <vpp-oper/ip.hpp>
+#include <vpp-oper/read_pool.hpp>
+
+#include "alloc_count.h"
+#include "bench.h"
+
+using namespace std::chrono;
+
+namespace bench {
+
+/* n address dumps against a VPP that takes vapi_latency to reply, waiting
+ * for each reply in turn, then pipelined in the default window */
+void pipeline_bench(size_t n)
+{
+    std::vector<size_t> windows = { 1, cmd_window::default_window() };
+
+    if (0 == vapi_latency.count())
+        return;
+
+    vapi::Connection::latency() = vapi_latency;
+
+    for (size_t w : windows) {
+        auto pipeline = std::make_shared<pipeline_cmd>("bench", w);
+        std::string name = "address dumps, window " + std::to_string(w);
+
+        for (size_t i = 0; i < n; i++)
+            pipeline->add(std::make_shared<ip_address_dump>(i, false));
+
+        uint64_t allocs = alloc_count();
+        steady_clock::time_point start = steady_clock::now();
+        VOM::rc_t rc = read_pool::instance().issue(pipeline);
+        nanoseconds t = steady_clock::now() - start;
+
+        record(name, n, t, alloc_count() - allocs);
+        check(VOM::rc_t::OK == rc && 0 == pipeline->failed(), name, n);
+    }
+
+    vapi::Connection::latency() = microseconds(0);
+}
+
+} // namespace bench
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* utils::prefix, checked then timed on its own */
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "alloc_count.h"
+#include "bench.h"
+#include "sys_util.h"
+
+using namespace std::chrono;
+
+namespace bench {
+
+/* Expected behavior of utils::prefix */
+void prefix_checks()
+{
+    using utils::prefix;
+    const struct {
+        const char *str;
+        bool valid;
+    } parses[] = {
+        { "10.0.0.1/24", true }, { "0.0.0.0/0", true },
+        { "255.255.255.255/32", true }, { "2001:db8::1/64", true },
+        { "::/0", true }, { "::ffff:10.0.0.1/128", true },
+        { "10.0.0.1", false }, { "10.0.0.1/", false }, { "10.0.0.1/33", false },
+        { "10.0.0/8", false }, { "10.0.0.256/8", false },
+        { "10.0.0.1.1/8", false }, { "2001:db8::1/129", false },
+        { "2001:db8:::1/64", false }, { "10.0.0.1/24x", false }, { "", false },
+    };
+    const struct {
+        const char *netmask;
+        int len;
+    } netmasks[] = {
+        { "255.255.255.0", 24 }, { "0.0.0.0", 0 }, { "255.255.255.255", 32 },
+        { "255.255.240.0", 20 }, { "255.0.255.0", -1 }, { "255.255.255.1", -1 },
+        { "ffff:ffff:ffff:ffff::", 64 }, { "ffff:fe00::", 23 }, { "::", 0 },
+        { "ffff:0:ffff::", -1 }, { "junk", -1 },
+    };
+    prefix p, q;
+    char buf[prefix::STRLEN];
+
+    for (auto &t : parses) {
+        bool ok = prefix::parse(t.str, p);
+        check(ok == t.valid, std::string("prefix parse ") + t.str, 0);
+        if (ok) {
+            /* formatting gives back what was parsed */
+            p.format(buf);
+            check(prefix::parse(buf, q) && p == q,
+                  std::string("prefix format ") + t.str, 0);
+            check(p.address() == boost::asio::ip::address::from_string(
+                      std::string(t.str, strchr(t.str, '/'))),
+                  std::string("prefix address ") + t.str, 0);
+        } else {
+            check(p.empty(), std::string("prefix left empty ") + t.str, 0);
+        }
+    }
+
+    for (auto &t : netmasks) {
+        check(utils::netmask_to_plen(t.netmask) == t.len,
+              std::string("netmask ") + t.netmask, 0);
+        if (t.len < 0)
+            continue;
+        prefix::parse(t.netmask, t.len, p);
+        check(p.netmask().to_string() == t.netmask,
+              std::string("netmask of ") + p.to_string(), 0);
+    }
+
+    prefix::parse("10.1.0.0/16", p);
+    check(p.contains(prefix::make_prefix("10.1.2.3/32")) &&
+          p.contains(p) &&
+          !p.contains(prefix::make_prefix("10.0.0.0/8")) &&
+          !p.contains(prefix::make_prefix("10.2.0.0/24")) &&
+          !p.contains(prefix::make_prefix("::a01:0/112")),
+          "prefix contains", 0);
+    check(p.overlaps(prefix::make_prefix("10.0.0.0/8")) &&
+          p.overlaps(prefix::make_prefix("10.1.255.0/24")) &&
+          !p.overlaps(prefix::make_prefix("10.2.0.0/15")) &&
+          !p.overlaps(prefix()),
+          "prefix overlaps", 0);
+    check(prefix::make_prefix("10.1.2.3/12").network() ==
+          prefix::make_prefix("10.0.0.0/12") &&
+          prefix::make_prefix("2001:db8::ffff/120").network() ==
+          prefix::make_prefix("2001:db8::ff00/120"),
+          "prefix network", 0);
+}
+
+/* Parse, format and test n prefixes */
+void prefix_bench(size_t n)
+{
+    std::vector<std::string> strs;
+    std::vector<utils::prefix> prefixes(n);
+    utils::prefix net = utils::prefix::make_prefix("10.0.0.0/9");
+    char buf[utils::prefix::STRLEN];
+    size_t ok = 0;
+
+    for (size_t i = 0; i < n; i++) {
+        char ip6[sizeof("2001:db8::ffff:ffff")];
+
+        snprintf(ip6, sizeof(ip6), "2001:db8::%zx:%zx", (i >> 16) & 0xffff,
+                 i & 0xffff);
+        strs.push_back((i % 4 ? ip4(10, i) : ip6) + std::string("/") +
+                       std::to_string(i % 4 ? 24 : 64));
+    }
+
+    uint64_t allocs = alloc_count();
+    steady_clock::time_point start = steady_clock::now();
+    for (size_t i = 0; i < n; i++)
+        ok += utils::prefix::parse(strs[i].c_str(), prefixes[i]);
+    nanoseconds t = steady_clock::now() - start;
+    record("prefix parse", n, t, alloc_count() - allocs);
+    check(ok == n, "prefix parse", n);
+
+    /* what utils::prefix replaced */
+    allocs = alloc_count();
+    start = steady_clock::now();
+    for (size_t i = 0; i < n; i++) {
+        size_t slash = strs[i].find_last_of('/');
+        boost::asio::ip::address a =
+            boost::asio::ip::address::from_string(strs[i].substr(0, slash));
+        ok += a.is_v4() + std::stoi(strs[i].substr(slash + 1));
+    }
+    t = steady_clock::now() - start;
+    record("prefix parse (boost)", n, t, alloc_count() - allocs);
+
+    ok = 0;
+    allocs = alloc_count();
+    start = steady_clock::now();
+    for (auto &p : prefixes)
+        ok += p.format(buf) > 0;
+    t = steady_clock::now() - start;
+    record("prefix format", n, t, alloc_count() - allocs);
+    check(ok == n, "prefix format", n);
+
+    ok = 0;
+    allocs = alloc_count();
+    start = steady_clock::now();
+    for (auto &p : prefixes)
+        ok += net.contains(p) + net.overlaps(p);
+    t = steady_clock::now() - start;
+    record("prefix contains+overlaps", n, t, alloc_count() - allocs);
+    check(ok > 0, "prefix contains+overlaps", n);
+}
+
+} // namespace bench
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* OpenConfig static routes and their bulk load */
+
+#include <string>
+
+#include "bench.h"
+#include "mock_vpp.hpp"
+#include "sc_dispatcher.h"
+
+using namespace std::chrono;
+
+namespace bench {
+
+static std::string route_xpath(const std::string &prefix)
+{
+    return "/openconfig-local-routing:local-routes/static-routes/"
+           "static[prefix='" + prefix + "']";
+}
+
+static std::string next_hop_xpath(const std::string &prefix,
+                                  const std::string &index)
+{
+    return route_xpath(prefix) + "/next-hops/next-hop[index='" + index + "']";
+}
+
+/* Queue the creation of next-hop index of route prefix, through itf if it
+ * is not empty */
+static void next_hop_create(const std::string &prefix,
+                            const std::string &index, sr_type_t type,
+                            const std::string &nh,
+                            const std::string &itf = "")
+{
+    std::string x = next_hop_xpath(prefix, index);
+
+    sr::instance().change(SR_OP_CREATED, nullptr, sr::list(x));
+    sr::instance().change(SR_OP_CREATED, nullptr,
+                          sr::val(x + "/index", SR_STRING_T, index));
+    sr::instance().change(SR_OP_CREATED, nullptr,
+                          sr::val(x + "/config/next-hop", type, nh));
+    if (!itf.empty())
+        sr::instance().change(SR_OP_CREATED, nullptr,
+                              sr::val(x + "/interface-ref/config/interface",
+                                      SR_STRING_T, itf));
+}
+
+/* Queue the creation of route prefix with next-hop "0" to nh */
+static void route_create(const std::string &prefix, const std::string &nh,
+                         const std::string &itf = "")
+{
+    std::string x = route_xpath(prefix);
+
+    sr::instance().change(SR_OP_CREATED, nullptr, sr::list(x));
+    sr::instance().change(SR_OP_CREATED, nullptr,
+                          sr::val(x + "/prefix", SR_STRING_T, prefix));
+    next_hop_create(prefix, "0", SR_STRING_T, nh, itf);
+}
+
+/* Queue the deletion of route prefix */
+static void route_delete(const std::string &prefix)
+{
+    std::string x = route_xpath(prefix);
+
+    sr::instance().change(SR_OP_DELETED, sr::list(x), nullptr);
+    sr::instance().change(SR_OP_DELETED,
+                          sr::val(x + "/prefix", SR_STRING_T, prefix),
+                          nullptr);
+}
+
+/* Load of a large static route table in one commit, with the interface of
+ * its next-hops, then a change of every route and commits that conflict
+ * with the table */
+void route_bulk(size_t n)
+{
+    mock_vpp &vpp = mock_vpp::instance();
+    std::string itf = itf_xpath(0, "route");
+    std::string x;
+    size_t paths = 0;
+
+    sr::instance().change(SR_OP_CREATED, nullptr, sr::list(itf));
+    sr::instance().change(SR_OP_CREATED, nullptr,
+                          sr::val(itf + "/name", SR_STRING_T, "route0"));
+    sr::instance().change(SR_OP_CREATED, nullptr,
+                          sr::val(itf + "/type", SR_IDENTITYREF_T,
+                                  "iana-if-type:ethernetCsmacd"));
+    sr::instance().change(SR_OP_CREATED, nullptr,
+                          sr::val(itf + "/enabled", true));
+
+    /* every fourth route has a second, dropping next-hop */
+    for (size_t i = 0; i < n; i++) {
+        std::string pfx = ip4(20, i) + "/32";
+
+        route_create(pfx, "10.255.0.1", "route0");
+        paths++;
+        if (i % 4)
+            continue;
+        next_hop_create(pfx, "1", SR_IDENTITYREF_T,
+                        "openconfig-local-routing:DROP");
+        sr::instance().change(SR_OP_CREATED, nullptr,
+                              sr::val(next_hop_xpath(pfx, "1") +
+                                      "/config/metric", (uint32_t) 10));
+        paths++;
+    }
+    commit("static route bulk load", n);
+    check(vpp.routes() == n && vpp.route_paths() == paths,
+          "static routes in VPP", n);
+
+    x = route_xpath(ip4(20, 0) + "/32");
+    check(get("static route state", 1, { x + "/state" }) == 1 &&
+          get("static route next-hop state", 1,
+              { next_hop_xpath(ip4(20, 0) + "/32", "1") + "/state" }) == 3,
+          "static route state", n);
+
+    /* one request per route, whatever the leaves changed */
+    for (size_t i = 0; i < n; i++) {
+        x = next_hop_xpath(ip4(20, i) + "/32", "0") + "/config/next-hop";
+        sr::instance().change(SR_OP_MODIFIED,
+                              sr::val(x, SR_STRING_T, "10.255.0.1"),
+                              sr::val(x, SR_STRING_T, "10.255.0.2"));
+    }
+    commit("static route modify", n);
+    check(vpp.routes() == n && vpp.route_paths() == paths,
+          "static routes after modify", n);
+
+    /* a prefix only differing from a route by its host bits, an unknown
+     * interface, a next-hop of another family */
+    route_create(ip4(20, 0) + "/24", "10.255.0.1");
+    check(SR_ERR_OK == sr::instance().commit(), "static route /24", n);
+    route_create(ip4(20, 1) + "/24", "10.255.0.1");
+    check(SR_ERR_OK != sr::instance().commit(), "static route host bits", n);
+    route_create(ip4(30, 0) + "/32", "10.255.0.1", "nonexistent");
+    check(SR_ERR_OK != sr::instance().commit(), "static route interface", n);
+    route_create(ip4(30, 0) + "/32", "2001:db8::1");
+    check(SR_ERR_OK != sr::instance().commit(), "static route family", n);
+    sc_dispatcher::instance().wait();
+    check(vpp.routes() == n + 1, "static routes after conflicts", n);
+
+    /* the network of a route deleted by the same commit can be reused */
+    route_delete(ip4(20, 0) + "/24");
+    route_create(ip4(20, 1) + "/24", "10.255.0.1");
+    check(SR_ERR_OK == sr::instance().commit(), "static route reuse", n);
+    sc_dispatcher::instance().wait();
+    check(vpp.routes() == n + 1, "static routes after reuse", n);
+
+    route_delete(ip4(20, 1) + "/24");
+    for (size_t i = 0; i < n; i++)
+        route_delete(ip4(20, i) + "/32");
+    commit("static route bulk delete", n);
+    check(vpp.routes() == 0, "static routes left in VPP", n);
+
+    sr::instance().change(SR_OP_DELETED, sr::list(itf), nullptr);
+    sr::instance().change(SR_OP_DELETED,
+                          sr::val(itf + "/name", SR_STRING_T, "route0"),
+                          nullptr);
+    check(SR_ERR_OK == sr::instance().commit(), "static route interface "
+          "delete", n);
+    sc_dispatcher::instance().wait();
+}
+
+} // namespace bench
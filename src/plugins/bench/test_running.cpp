@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Running datastore applied at plugin start */
+
+#include <cstdio>
+#include <string>
+
+#include "bench.h"
+#include "sc_dispatcher.h"
+#include "sc_startup.h"
+
+using namespace std::chrono;
+
+namespace bench {
+
+/* Phases of the plugin start, as published in sweetcomb-stats */
+void print_startup()
+{
+    printf("\n%-40s %10s %12s\n", "startup phase", "start us", "duration us");
+    for (auto &ph : sc_startup::instance().phases())
+        printf("%-40s %10lld %12lld\n", ph.name.c_str(),
+               (long long) ph.start.count(), (long long) ph.duration.count());
+}
+
+/* The plugin is connected to VPP and has programmed it */
+bool startup_done()
+{
+    sr_val_t *values = nullptr;
+    size_t cnt = 0;
+
+    if (SR_ERR_OK != sr::instance().get_items("/sweetcomb-stats:startup/"
+                                              "phase[name='total']",
+                                              &values, &cnt))
+        return false;
+    sr_free_values(values, cnt);
+
+    return cnt > 0;
+}
+
+/* Interfaces in the running datastore at plugin start, named boot<i>,
+ * each with one address */
+void running_config(size_t n)
+{
+    sr::instance().running(sr::list("/ietf-interfaces:interfaces"));
+    for (size_t i = 0; i < n; i++) {
+        std::string x = itf_xpath(i, "boot");
+        std::string a = x + "/ietf-ip:ipv4/address[ip='" + ip4(11, i) + "']";
+
+        sr::instance().running(sr::list(x));
+        sr::instance().running(sr::val(x + "/name", SR_STRING_T,
+                                       "boot" + std::to_string(i)));
+        sr::instance().running(sr::val(x + "/type", SR_IDENTITYREF_T,
+                                       "iana-if-type:ethernetCsmacd"));
+        sr::instance().running(sr::val(x + "/enabled", true));
+        sr::instance().running(sr::list(a));
+        sr::instance().running(sr::val(a + "/ip", SR_STRING_T, ip4(11, i)));
+        sr::instance().running(sr::val(a + "/prefix-length", (uint8_t) 24));
+    }
+}
+
+/* Create or delete the address of boot<i> in a commit of its own */
+int running_address_commit(size_t i, sr_change_oper_t op)
+{
+    std::string x = itf_xpath(i, "boot");
+    std::string a = x + "/ietf-ip:ipv4/address[ip='" + ip4(11, i) + "']";
+    bool del = SR_OP_DELETED == op;
+
+    sr::instance().change(op, del ? sr::list(a) : nullptr,
+                          del ? nullptr : sr::list(a));
+    sr_val_t *ip = sr::val(a + "/ip", SR_STRING_T, ip4(11, i));
+    sr_val_t *len = sr::val(a + "/prefix-length", (uint8_t) 24);
+    sr::instance().change(op, del ? ip : nullptr, del ? nullptr : ip);
+    sr::instance().change(op, del ? len : nullptr, del ? nullptr : len);
+
+    return sr::instance().commit();
+}
+
+/* Remove the running datastore programmed at plugin start, so that the
+ * benchmarks start from the VPP they expect */
+void running_config_delete(size_t n)
+{
+    if (0 == n)
+        return;
+
+    for (size_t i = 0; i < n; i++) {
+        std::string x = itf_xpath(i, "boot");
+        std::string a = x + "/ietf-ip:ipv4/address[ip='" + ip4(11, i) + "']";
+
+        sr::instance().change(SR_OP_DELETED, sr::list(a), nullptr);
+        sr::instance().change(SR_OP_DELETED,
+                              sr::val(a + "/ip", SR_STRING_T, ip4(11, i)),
+                              nullptr);
+        sr::instance().change(SR_OP_DELETED,
+                              sr::val(a + "/prefix-length", (uint8_t) 24),
+                              nullptr);
+    }
+    check(SR_ERR_OK == sr::instance().commit(), "running addresses delete",
+          n);
+    sc_dispatcher::instance().wait();
+
+    for (size_t i = 0; i < n; i++) {
+        std::string x = itf_xpath(i, "boot");
+
+        sr::instance().change(SR_OP_DELETED, sr::list(x), nullptr);
+        sr::instance().change(SR_OP_DELETED,
+                              sr::val(x + "/name", SR_STRING_T,
+                                      "boot" + std::to_string(i)),
+                              nullptr);
+    }
+    check(SR_ERR_OK == sr::instance().commit(), "running interfaces delete",
+          n);
+    sc_dispatcher::instance().wait();
+    sr::instance().clear_running();
+}
+
+} // namespace bench
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* Interface counters read from the stats segment */
+
+#include <chrono>
+#include <cstdint>
+
+#include <vpp-oper/stats.hpp>
+
+#include "alloc_count.h"
+#include "bench.h"
+#include "mock_vpp.hpp"
+
+using namespace std::chrono;
+
+namespace bench {
+
+/* Fold of a stats segment dump into the snapshot the statistics callbacks
+ * index into, and the vectors of the stat client freed on disconnect */
+void stats_segment(size_t n)
+{
+    mock_vpp &vpp = mock_vpp::instance();
+
+    /* folding of a stats segment dump, without the segment read: the stat
+     * client is played in memory, the read of a real segment is left to
+     * libvppapiclient and not timed here */
+    {
+        uint32_t *dir = stat_segment_ls(nullptr);
+        stat_segment_data_t *res = stat_segment_dump(dir);
+        interface_stats::snapshot_t snap;
+
+        uint64_t allocs = alloc_count();
+        steady_clock::time_point start = steady_clock::now();
+        snap.fill(res);
+        nanoseconds t = steady_clock::now() - start;
+        record("stats snapshot fill", n, t, alloc_count() - allocs);
+        check(snap.size() >= n, "stats snapshot fill", n);
+
+        stat_segment_data_free(res);
+        stat_segment_vec_free(dir);
+    }
+
+    /* the directory and its patterns are listed again on reconnect */
+    {
+        long vectors;
+
+        interface_stats::instance().disconnect();
+        vectors = vpp.stat_vectors();
+        check(interface_stats::instance().snapshot(milliseconds(0)) &&
+              vpp.stat_vectors() > vectors, "stats segment read", n);
+        interface_stats::instance().disconnect();
+        check(vpp.stat_vectors() == vectors,
+              "stats segment vectors freed on disconnect", n);
+    }
+}
+
+} // namespace bench
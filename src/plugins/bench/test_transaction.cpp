@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* sc_transaction: commits of concurrent sessions, failures and their
+ * repair */
+
+#include <memory>
+#include <string>
+
+#include "bench.h"
+#include "mock_vpp.hpp"
+#include "sc_dispatcher.h"
+#include "sc_transaction.h"
+
+using namespace std::chrono;
+
+namespace bench {
+
+/* Two commits staged at once only commit or abort their own changes */
+void transaction_checks()
+{
+    static int tag[2];
+    sr_session_ctx_t *one = (sr_session_ctx_t *) &tag[0];
+    sr_session_ctx_t *two = (sr_session_ctx_t *) &tag[1];
+    std::shared_ptr<sc_transaction> tx = sc_transaction::of(one);
+    auto nothing = []() { return VOM::rc_t::OK; };
+
+    tx->program("bench-one", sc_transaction::STAGE_L3, nothing);
+    sc_transaction::of(two)->program("bench-two", sc_transaction::STAGE_L3,
+                                     nothing);
+    check(sc_transaction::of(one) == tx && tx->size() == 1 &&
+          sc_transaction::of(two)->size() == 1, "transaction of a session", 0);
+
+    sc_transaction::of(two)->abort();
+    check(sc_transaction::of(one)->size() == 1 &&
+          sc_transaction::of(two)->size() == 0,
+          "transaction kept by the abort of another", 0);
+
+    sc_transaction::of(two)->abort();
+    tx->abort();
+    check(sc_transaction::of(one) != tx &&
+          sc_transaction::of(one)->size() == 0, "transaction aborted", 0);
+    sc_transaction::of(one)->abort();
+}
+
+/* Addresses VPP refuses stay committed: they are counted as failed, then
+ * repaired by a reconcile of the objects they concern */
+void repair_checks()
+{
+    static const size_t N = 4;
+    mock_vpp &vpp = mock_vpp::instance();
+    auto respond = vapi::Sw_interface_add_del_address::responder();
+    sc_transaction::failures_t before = sc_transaction::failures();
+    sc_transaction::failures_t after;
+    size_t refused = 0;
+    sr_val_t *val = nullptr;
+    size_t cnt = 0;
+
+    interface_changes(N, SR_OP_CREATED);
+    check(SR_ERR_OK == sr::instance().commit(), "repair interfaces", N);
+    sc_dispatcher::instance().wait();
+
+    /* the batch of the commit is refused, the repair is not */
+    vapi::Sw_interface_add_del_address::responder() =
+        [&](vapi::Sw_interface_add_del_address &r) {
+        if (r.get_request().get_payload().is_add && refused < N) {
+            r.get_response().get_payload().retval = -1;
+            refused++;
+            return;
+        }
+        respond(r);
+    };
+    address_changes(N, SR_OP_CREATED);
+    check(SR_ERR_OK == sr::instance().commit(), "refused addresses commit", N);
+    sc_dispatcher::instance().wait();
+    vapi::Sw_interface_add_del_address::responder() = respond;
+
+    after = sc_transaction::failures();
+    check(refused == N && after.failed > before.failed &&
+          !after.last.empty(), "failed changes counted", N);
+    check(after.repaired - before.repaired == after.failed - before.failed &&
+          vpp.addresses() == N, "failed changes repaired", N);
+    check(SR_ERR_OK == sr::instance().get_items("/sweetcomb-stats:"
+                                                "vpp-connection/"
+                                                "failed-changes",
+                                                &val, &cnt) && 1 == cnt &&
+          val[0].data.uint64_val == after.failed,
+          "failed-changes leaf", N);
+    sr_free_values(val, cnt);
+
+    address_changes(N, SR_OP_DELETED);
+    check(SR_ERR_OK == sr::instance().commit(), "repaired addresses delete",
+          N);
+    interface_changes(N, SR_OP_DELETED);
+    check(SR_ERR_OK == sr::instance().commit(), "repair interfaces delete",
+          N);
+    sc_dispatcher::instance().wait();
+    check(vpp.addresses() == 0, "repaired addresses left in VPP", N);
+}
+
+} // namespace bench
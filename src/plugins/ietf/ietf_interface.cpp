@@ -25,15 +25,26 @@
 #include <string>
 #include <exception>
 #include <memory>
+#include <map>
+#include <mutex>
+#include <set>
+#include <vector>
 
 #include <vom/interface.hpp>
 #include <vom/om.hpp>
-#include <vom/l3_binding.hpp>
 #include <vom/route.hpp>
 
 #include <vpp-oper/interface.hpp>
+#include <vpp-oper/interface_cache.hpp>
+#include <vpp-oper/ip.hpp>
+#include <vpp-oper/stats.hpp>
 
+#include "sc_latency.h"
+#include "sc_interfaces.h"
 #include "sc_plugins.h"
+#include "sc_request.h"
+#include "sc_running.h"
+#include "sc_transaction.h"
 #include "sys_util.h"
 
 using namespace std;
@@ -41,55 +52,19 @@ using namespace std;
 using VOM::interface;
 using VOM::OM;
 using VOM::HW;
-using VOM::l3_binding;
 using VOM::rc_t;
 
-using type_t = VOM::interface::type_t;
-using admin_state_t = VOM::interface::admin_state_t;
-
-class interface_builder {
-    public:
-        interface_builder() {}
-
-        shared_ptr<VOM::interface> build() {
-            if (m_name.empty() || m_type.empty())
-                return nullptr;
-            return make_shared<interface>(m_name, type_t::from_string(m_type),
-                                          admin_state_t::from_int(m_state));
-        }
-
-        /* Getters */
-        string name() {
-            return m_name;
-        }
-
-        /* Setters */
-        interface_builder& set_name(string n) {
-            m_name = n;
-            return *this;
-        }
-
-        interface_builder& set_type(string t) {
-            if (t == "iana-if-type:ethernetCsmacd")
-                m_type = "ETHERNET";
-            return *this;
-        }
-
-        interface_builder& set_state(bool enable) {
-            m_state = enable;
-            return *this;
-        }
-
-        std::string to_string() {
-            std::ostringstream os;
-            os << m_name << "," << m_type << "," << m_state;
-            return os.str();
-        }
+/* Leaves of an interface handled by ietf_interface_create_cb */
+enum interface_leaf_t {
+    INTERFACE_NAME,
+    INTERFACE_TYPE,
+    INTERFACE_ENABLED,
+};
 
-    private:
-        string m_name;
-        string m_type;
-        bool m_state;
+static const utils::schema_dispatch interface_leaves = {
+    { "/ietf-interfaces:interfaces/interface/name", INTERFACE_NAME },
+    { "/ietf-interfaces:interfaces/interface/type", INTERFACE_TYPE },
+    { "/ietf-interfaces:interfaces/interface/enabled", INTERFACE_ENABLED },
 };
 
 /* @brief creation of ethernet devices */
@@ -98,66 +73,78 @@ ietf_interface_create_cb(sr_session_ctx_t *session, const char *xpath,
                          sr_notif_event_t event, void *private_ctx)
 {
     UNUSED(private_ctx);
-    shared_ptr<VOM::interface> intf;
-    interface_builder builder;
+    std::shared_ptr<sc_transaction> tx = sc_transaction::of(session);
+    sc_interfaces::changes changes(*tx);
+    utils::xpath_keys keys;
     string if_name;
-    sr_change_iter_t *iter = nullptr;
-    sr_xpath_ctx_t xpath_ctx;
+    int leaf;
+    sc_change_iter_t *iter = nullptr;
     sr_val_t *old_val = nullptr;
     sr_val_t *new_val = nullptr;
     sr_change_oper_t op;
-    bool create, remove, modify;
     int rc;
 
     SRP_LOG_INF("In %s", __FUNCTION__);
 
-    /* no-op for apply, we only care about SR_EV_{ENABLED,VERIFY,ABORT} */
+    /* changes of the whole commit are pushed to VPP at once on apply */
+    if (SR_EV_APPLY == event)
+        return tx->commit();
+
+    if (SR_EV_ABORT == event) {
+        tx->abort();
+        return SR_ERR_OK;
+    }
+
     if (SR_EV_VERIFY != event)
         return SR_ERR_OK;
 
     SRP_LOG_DBG("'%s' modified, event=%d", xpath, event);
 
     /* get changes iterator */
-    rc = sr_get_changes_iter(session, xpath, &iter);
+    rc = sc_get_changes_iter(session, xpath, &iter);
     if (SR_ERR_OK != rc) {
-        sr_free_change_iter(iter);
+        sc_free_change_iter(iter);
         SRP_LOG_ERR("Unable to retrieve change iterator: %s", sr_strerror(rc));
+        tx->abort();
         return SR_ERR_OPERATION_FAILED;
     }
 
     foreach_change (session, iter, op, old_val, new_val) {
         SRP_LOG_INF("Change xpath: %s",
                     old_val ? old_val->xpath : new_val->xpath);
+
+        leaf = interface_leaves.match(new_val ? new_val->xpath
+                                              : old_val->xpath, keys);
+        if_name = keys.value(0);
+
         switch (op) {
             case SR_OP_MODIFIED:
                 SRP_LOG_INF_MSG("Modified");
-                if (sr_xpath_node_name_eq(new_val->xpath, "enabled")) {
-                    string n = sr_xpath_key_value(new_val->xpath, "interface",
-                                                  "name", &xpath_ctx);
-                    intf = interface::find(n);
-                    if (!intf) {
-                        rc = SR_ERR_OPERATION_FAILED;
+                if (INTERFACE_ENABLED == leaf) {
+                    rc = changes.enable(if_name, new_val->data.bool_val);
+                    if (SR_ERR_OK != rc)
                         goto nothing_todo;
-                    }
-                    intf->set(admin_state_t::from_int(new_val->data.bool_val));
-                    modify = true;
                 }
                 break;
             case SR_OP_CREATED:
-                if (sr_xpath_node_name_eq(new_val->xpath, "name")) {
-                    builder.set_name(new_val->data.string_val);
-                    create = true;
-                } else if (sr_xpath_node_name_eq(new_val->xpath, "type")) {
-                    builder.set_type(new_val->data.string_val);
-                } else if (sr_xpath_node_name_eq(new_val->xpath, "enabled")) {
-                    builder.set_state(new_val->data.bool_val);
+                switch (leaf) {
+                    case INTERFACE_NAME:
+                        changes.create(if_name).set_name(
+                            new_val->data.string_val);
+                        break;
+                    case INTERFACE_TYPE:
+                        changes.create(if_name).set_type(
+                            new_val->data.string_val);
+                        break;
+                    case INTERFACE_ENABLED:
+                        changes.create(if_name).set_enabled(
+                            new_val->data.bool_val);
+                        break;
                 }
                 break;
             case SR_OP_DELETED:
-                if (sr_xpath_node_name_eq(old_val->xpath, "name")) {
-                    builder.set_name(old_val->data.string_val);
-                    remove = true;
-                }
+                if (INTERFACE_NAME == leaf)
+                    changes.remove(old_val->data.string_val);
                 break;
             default:
                 rc = SR_ERR_UNSUPPORTED;
@@ -168,75 +155,112 @@ ietf_interface_create_cb(sr_session_ctx_t *session, const char *xpath,
         sr_free_val(new_val);
     }
 
-    if (create) {
-        SRP_LOG_INF("creating interface '%s'", builder.name().c_str());
-        intf = builder.build();
-        if (nullptr == intf) {
-            SRP_LOG_ERR_MSG("Interface does not exist");
-            rc = SR_ERR_INVAL_ARG;
-            goto nothing_todo;
-        }
-    }
+    sc_free_change_iter(iter);
 
-    if (create || modify) {
-        /* Commit the changes to VOM DB and VPP with interface name as key.
-         * Work for modifications too, because OM::write() check for existing
-         * l3 bindings. */
-        if ( OM::write(intf->key(), *intf) != rc_t::OK ) {
-            SRP_LOG_ERR("Fail writing changes to VPP for: %s",
-                        builder.to_string().c_str());
-            rc = SR_ERR_OPERATION_FAILED;
-            goto nothing_todo;
-        }
+    rc = changes.stage();
+    if (SR_ERR_OK != rc)
+        tx->abort();
 
-    } else if (remove) {
-        SRP_LOG_INF("deleting interface '%s'", builder.name().c_str());
-        OM::remove(builder.name());
-    }
-
-    sr_free_change_iter(iter);
-
-    return SR_ERR_OK;
+    return rc;
 
 nothing_todo:
     sr_free_val(old_val);
     sr_free_val(new_val);
-    sr_free_change_iter(iter);
+    sc_free_change_iter(iter);
+    tx->abort();
     return rc;
 }
 
 
-static int
-ipv46_config_add_remove(const string &if_name, const string &addr,
-                        uint8_t prefix, bool add)
+/* Addresses of interfaces, by interface name */
+typedef vector<pair<string, VOM::route::prefix_t>> ipv46_list_t;
+
+/*
+ * Addresses programmed on the interfaces. They are programmed outside of
+ * VOM, with one batch of pipelined requests per commit, and described to a
+ * reconcile from this table.
+ */
+class ipv46_table {
+public:
+    void add(const string &itf, const VOM::route::prefix_t &pfx)
+    {
+        lock_guard<mutex> lg(m_lock);
+        m_addresses[itf].insert(pfx);
+    }
+
+    void remove(const string &itf, const VOM::route::prefix_t &pfx)
+    {
+        lock_guard<mutex> lg(m_lock);
+        auto it = m_addresses.find(itf);
+
+        if (it == m_addresses.end())
+            return;
+        it->second.erase(pfx);
+        if (it->second.empty())
+            m_addresses.erase(it);
+    }
+
+    void describe(reconcile &r)
+    {
+        lock_guard<mutex> lg(m_lock);
+
+        for (auto &a : m_addresses) {
+            for (auto &pfx : a.second)
+                r.address(a.first, pfx);
+        }
+    }
+
+private:
+    mutex m_lock;
+    map<string, set<VOM::route::prefix_t>> m_addresses;
+};
+
+static ipv46_table ipv46_addresses;
+
+/* Add or delete addresses with one batch of requests, hw_lock() held. The
+ * addresses of an interface deleted went with it. */
+static rc_t
+ipv46_program(const ipv46_list_t &addrs, bool add)
 {
-    shared_ptr<l3_binding> l3;
-    shared_ptr<interface> intf;
-    rc_t rc = rc_t::OK;
+    address_batch batch(add);
+    size_t missing = 0;
+
+    for (auto &a : addrs) {
+        shared_ptr<interface> itf = interface::find(a.first);
+
+        if (!itf || VOM::handle_t::INVALID == itf->handle()) {
+            missing += add;
+            continue;
+        }
+        batch.add(itf->handle().value(), a.second);
+    }
+
+    batch.enqueue();
+    HW::write();
+
+    if (missing || batch.failed()) {
+        SRP_LOG_ERR("Fail %s addresses: %zu of %zu failed, %zu on no "
+                    "interface", add ? "adding" : "deleting", batch.failed(),
+                    batch.size(), missing);
+        return rc_t::INVALID;
+    }
 
-    intf = interface::find(if_name);
-    if (nullptr == intf) {
+    return rc_t::OK;
+}
+
+static int
+ipv46_config_add_remove(sc_transaction &tx, const string &if_name,
+                        const utils::prefix &prefix, ipv46_list_t &list)
+{
+    if (nullptr == tx.find_interface(if_name)) {
         SRP_LOG_ERR_MSG("Interface does not exist");
         return SR_ERR_INVAL_ARG;
     }
 
     try {
-        VOM::route::prefix_t pfx(addr, prefix);
-        l3 = make_shared<l3_binding>(*intf, pfx);
-
-        #define KEY(l3) "l3_" + l3->itf().name() + "_" + l3->prefix().to_string()
-        if (add) {
-            /* Commit the changes to VOM DB and VPP */
-            if ( OM::write(KEY(l3), *l3) != rc_t::OK ) {
-                SRP_LOG_ERR_MSG("Fail writing changes to VPP");
-                return SR_ERR_OPERATION_FAILED;
-            }
-        } else {
-            /* Remove l3 thanks to its unique identifier */
-            OM::remove(KEY(l3));
-        }
-        #undef KEY
-
+        list.push_back(make_pair(if_name,
+                                 VOM::route::prefix_t(prefix.address(),
+                                                      prefix.prefix_length())));
     } catch (std::exception &exc) {  //catch boost exception from prefix_t
         SRP_LOG_ERR("Error: %s", exc.what());
         return SR_ERR_OPERATION_FAILED;
@@ -245,32 +269,65 @@ ipv46_config_add_remove(const string &if_name, const string &addr,
     return SR_ERR_OK;
 }
 
-static void
-parse_interface_ipv46_address(sr_val_t *val, string &addr,
-                              uint8_t &prefix)
+/* Changes of one address of one interface within a commit */
+struct ipv46_change_t {
+    ipv46_change_t() : old_len(-1), new_len(-1), del(false), add(false) {}
+
+    /* prefix length before and after the commit, -1 if unknown */
+    int old_len;
+    int new_len;
+    bool del;
+    bool add;
+};
+
+/* Changes by (interface name, address) */
+typedef map<pair<string, string>, ipv46_change_t> ipv46_changes_t;
+
+/* Nodes of an address handled by ietf_interface_ipv46_address_change_cb */
+enum address_node_t {
+    ADDRESS_ENTRY,
+    ADDRESS_IP,
+    ADDRESS_PREFIX_LENGTH,
+    ADDRESS_NETMASK,
+};
+
+#define IPV4_ADDRESS "/ietf-interfaces:interfaces/interface/ietf-ip:ipv4/address"
+#define IPV6_ADDRESS "/ietf-interfaces:interfaces/interface/ietf-ip:ipv6/address"
+
+static const utils::schema_dispatch address_nodes = {
+    { IPV4_ADDRESS, ADDRESS_ENTRY },
+    { IPV4_ADDRESS "/ip", ADDRESS_IP },
+    { IPV4_ADDRESS "/prefix-length", ADDRESS_PREFIX_LENGTH },
+    { IPV4_ADDRESS "/netmask", ADDRESS_NETMASK },
+    { IPV6_ADDRESS, ADDRESS_ENTRY },
+    { IPV6_ADDRESS "/ip", ADDRESS_IP },
+    { IPV6_ADDRESS "/prefix-length", ADDRESS_PREFIX_LENGTH },
+};
+
+/* Read the prefix length set by val of address node, if it is the
+ * prefix-length or the netmask leaf */
+static int
+parse_interface_ipv46_length(int node, const sr_val_t *val, int &len)
 {
-    if (val == nullptr)
-        throw std::runtime_error("Null pointer");
-
-    if (SR_LIST_T == val->type) {
-        /* create on list item - reset state vars */
-        addr.clear();
-    } else {
-        if (sr_xpath_node_name_eq(val->xpath, "ip")) {
-            addr = val->data.string_val;
-        } else if (sr_xpath_node_name_eq(val->xpath, "prefix-length")) {
-            prefix = val->data.uint8_val;
-        } else if (sr_xpath_node_name_eq(val->xpath, "netmask")) {
-            prefix = utils::netmask_to_plen(
-                    boost::asio::ip::address::from_string(val->data.string_val));
+    if (ADDRESS_PREFIX_LENGTH == node) {
+        len = val->data.uint8_val;
+    } else if (ADDRESS_NETMASK == node) {
+        len = utils::netmask_to_plen(val->data.string_val);
+        if (len < 0) {
+            SRP_LOG_ERR("Invalid netmask %s", val->data.string_val);
+            return SR_ERR_INVAL_ARG;
         }
     }
+
+    return SR_ERR_OK;
 }
 
 /**
  * @brief Callback to be called by any config change in subtrees
  * "/ietf-interfaces:interfaces/interface/ietf-ip:ipv4/address"
  * or "/ietf-interfaces:interfaces/interface/ietf-ip:ipv6/address".
+ * The address is the key of its list entry, the leaves changed are gathered
+ * per entry so that each address is staged once, with its final length.
  */
 static int
 ietf_interface_ipv46_address_change_cb(sr_session_ctx_t *session,
@@ -279,112 +336,245 @@ ietf_interface_ipv46_address_change_cb(sr_session_ctx_t *session,
                                        void *private_ctx)
 {
     UNUSED(private_ctx);
-    sr_change_iter_t *iter = nullptr;
+    std::shared_ptr<sc_transaction> tx = sc_transaction::of(session);
+    shared_ptr<ipv46_list_t> dels = make_shared<ipv46_list_t>();
+    shared_ptr<ipv46_list_t> adds = make_shared<ipv46_list_t>();
+    sc_change_iter_t *iter = nullptr;
     sr_change_oper_t op = SR_OP_CREATED;
     sr_val_t *old_val = nullptr;
     sr_val_t *new_val = nullptr;
-    sr_xpath_ctx_t xpath_ctx;
-    string new_addr, old_addr;
-    string if_name;
-    uint8_t new_prefix = 0;
-    uint8_t old_prefix = 0;
-    int rc = SR_ERR_OK, op_rc = SR_ERR_OK;
-    bool create = false;
-    bool del = false;
+    ipv46_changes_t changes;
+    utils::xpath_keys keys;
+    utils::prefix prefix;
+    string if_name, addr;
+    int node;
+    int rc = SR_ERR_OK;
 
     SRP_LOG_INF("In %s", __FUNCTION__);
 
-    /* no-op for apply, we only care about SR_EV_{ENABLED,VERIFY,ABORT} */
+    /* changes of the whole commit are pushed to VPP at once on apply */
     if (SR_EV_APPLY == event)
+        return tx->commit();
+
+    if (SR_EV_ABORT == event) {
+        tx->abort();
+        return SR_ERR_OK;
+    }
+
+    if (SR_EV_VERIFY != event)
         return SR_ERR_OK;
 
     SRP_LOG_DBG("'%s' modified, event=%d", xpath, event);
 
     /* get changes iterator */
-    rc = sr_get_changes_iter(session, xpath, &iter);
+    rc = sc_get_changes_iter(session, xpath, &iter);
     if (SR_ERR_OK != rc) {
-        sr_free_change_iter(iter);
+        sc_free_change_iter(iter);
         SRP_LOG_ERR("Unable to retrieve change iterator: %s", sr_strerror(rc));
+        tx->abort();
         return rc;
     }
 
     foreach_change(session, iter, op, old_val, new_val) {
+        char *val_xpath = new_val ? new_val->xpath : old_val->xpath;
 
-        SRP_LOG_DBG("A change detected in '%s', op=%d",
-                    new_val ? new_val->xpath : old_val->xpath, op);
+        SRP_LOG_DBG("A change detected in '%s', op=%d", val_xpath, op);
 
-        if_name = sr_xpath_key_value(new_val ? new_val->xpath : old_val->xpath,
-                                     "interface", "name", &xpath_ctx);
-        if (if_name.empty()) {
+        /* interface name then address are the keys of the path */
+        node = address_nodes.match(val_xpath, keys);
+        if_name = keys.value(0);
+        addr = keys.value(1);
+        if (node < 0 || if_name.empty() || addr.empty()) {
             rc = SR_ERR_OPERATION_FAILED;
             goto nothing_todo;
         }
-        sr_xpath_recover(&xpath_ctx);
-
-        try {
-            switch (op) {
-                case SR_OP_CREATED:
-                    create = true;
-                    parse_interface_ipv46_address(new_val, new_addr, new_prefix);
-                    break;
-                case SR_OP_MODIFIED:
-                    create = true;
-                    del = true;
-                    parse_interface_ipv46_address(old_val, old_addr, old_prefix);
-                    parse_interface_ipv46_address(new_val, new_addr, new_prefix);
-                    break;
-                case SR_OP_DELETED:
-                    del = true;
-                    parse_interface_ipv46_address(old_val, old_addr, old_prefix);
-                    break;
-                default:
-                    break;
-            }
-        } catch (std::exception &exc) {
-            SRP_LOG_ERR("Error: %s", exc.what());
+
+        ipv46_change_t &change = changes[make_pair(if_name, addr)];
+
+        switch (op) {
+            case SR_OP_CREATED:
+                change.add = true;
+                rc = parse_interface_ipv46_length(node, new_val,
+                                                  change.new_len);
+                break;
+            case SR_OP_MODIFIED:
+                change.add = change.del = true;
+                rc = parse_interface_ipv46_length(node, old_val,
+                                                  change.old_len);
+                if (SR_ERR_OK == rc)
+                    rc = parse_interface_ipv46_length(node, new_val,
+                                                      change.new_len);
+                break;
+            case SR_OP_DELETED:
+                change.del = true;
+                rc = parse_interface_ipv46_length(node, old_val,
+                                                  change.old_len);
+                break;
+            default:
+                break;
         }
+        if (SR_ERR_OK != rc)
+            goto nothing_todo;
+
         sr_free_val(old_val);
         sr_free_val(new_val);
-
-        if (del && !old_addr.empty()) {
-            op_rc = ipv46_config_add_remove(if_name, old_addr, old_prefix,
-                                            false /* del */);
+    }
+    sc_free_change_iter(iter);
+
+    for (auto &c : changes) {
+        const string &name = c.first.first;
+        const string &ip = c.first.second;
+
+        /* an address moved, or deleted then created, within the commit
+         * is staged for removal with its old length first */
+        if (c.second.del && c.second.old_len >= 0) {
+            if (!utils::prefix::parse(ip.c_str(), c.second.old_len, prefix)) {
+                SRP_LOG_ERR("Invalid address %s", ip.c_str());
+                rc = SR_ERR_INVAL_ARG;
+                break;
+            }
+            rc = ipv46_config_add_remove(*tx, name, prefix, *dels);
+            if (SR_ERR_OK != rc)
+                break;
+        } else if (c.second.del) {
+            SRP_LOG_WRN("No prefix length removed with %s of %s",
+                        ip.c_str(), name.c_str());
         }
 
-        if (create && !new_addr.empty()) {
-            op_rc = ipv46_config_add_remove(if_name, new_addr, new_prefix,
-                                            true /* add */);
+        if (c.second.add) {
+            if (c.second.new_len < 0 ||
+                !utils::prefix::parse(ip.c_str(), c.second.new_len, prefix)) {
+                SRP_LOG_ERR("Invalid address %s", ip.c_str());
+                rc = SR_ERR_INVAL_ARG;
+                break;
+            }
+            rc = ipv46_config_add_remove(*tx, name, prefix, *adds);
+            if (SR_ERR_OK != rc)
+                break;
         }
+    }
 
+    /* this subscriber gets no SR_EV_ABORT when its own verify fails */
+    if (SR_ERR_OK != rc) {
+        tx->abort();
+        return rc;
     }
-    sr_free_change_iter(iter);
 
-    return op_rc;
+    if (dels->empty() && adds->empty())
+        return SR_ERR_OK;
+
+    /* after the commits before on the interfaces, deletions before the
+     * removal of an interface, additions after its creation */
+    for (auto &c : changes)
+        tx->depends(c.first.first);
+
+    if (!dels->empty())
+        tx->unprogram(string("delete ") + xpath, sc_transaction::STAGE_L3,
+                      [dels]() { return ipv46_program(*dels, false); },
+                      xpath);
+
+    /* the table describes all the addresses, whichever commit made them */
+    if (!adds->empty())
+        tx->program(xpath, sc_transaction::STAGE_L3,
+                    [adds]() { return ipv46_program(*adds, true); },
+                    [](reconcile &r) { ipv46_addresses.describe(r); });
+
+    tx->on_apply([dels, adds]() {
+        for (auto &d : *dels)
+            ipv46_addresses.remove(d.first, d.second);
+        for (auto &a : *adds)
+            ipv46_addresses.add(a.first, a.second);
+    });
+
+    return SR_ERR_OK;
 
 nothing_todo:
     sr_free_val(old_val);
     sr_free_val(new_val);
-    sr_free_change_iter(iter);
+    sc_free_change_iter(iter);
+    tx->abort();
     return rc;
 }
 
+/* Leaves replied by ietf_interface_state_cb for each interface */
+static const vector<string> state_leaves = {
+    "admin-status", "oper-status", "phys-address", "if-index", "speed"
+};
+
+/* Fill val with the leaves of one interface selected by filter */
+static void
+ietf_interface_state_build(const char *xpath,
+                           const utils::xpath_filter &filter,
+                           const vapi_payload_sw_interface_details &interface,
+                           sr_val_t *val, int &cnt)
+{
+    /* kept from one interface and one call to the next */
+    static thread_local utils::xpath_builder path;
+    sc_interfaces::state st(interface);
+    char mac[sc_interfaces::state::MAC_STRLEN];
+
+    SRP_LOG_DBG("State of interface %s", st.name());
+
+    path.entry(xpath, "name", st.name());
+
+    /* it needs if-mib YANG feature to work !
+     * admin-state: state as required by configuration */
+    if (filter.wants("admin-status")) {
+        path.set(&val[cnt], "admin-status");
+        sr_val_set_str_data(&val[cnt], SR_ENUM_T,
+                            st.admin_up() ? "up" : "down");
+        cnt++;
+    }
+
+    /* oper-state: effective state. can differ from admin-state */
+    if (filter.wants("oper-status")) {
+        path.set(&val[cnt], "oper-status");
+        sr_val_set_str_data(&val[cnt], SR_ENUM_T,
+                            st.oper_up() ? "up" : "down");
+        cnt++;
+    }
+
+    if (filter.wants("phys-address")) {
+        path.set(&val[cnt], "phys-address");
+        st.phys_address(mac);
+        sr_val_set_str_data(&val[cnt], SR_STRING_T, mac);
+        cnt++;
+    }
+
+    if (filter.wants("if-index")) {
+        path.set(&val[cnt], "if-index");
+        val[cnt].type = SR_INT32_T;
+        val[cnt].data.int32_val = st.index();
+        cnt++;
+    }
+
+    if (filter.wants("speed")) {
+        path.set(&val[cnt], "speed");
+        val[cnt].type = SR_UINT64_T;
+        val[cnt].data.uint64_val = st.speed();
+        cnt++;
+    }
+}
+
 /**
  * @brief Callback to be called by any request for state data under "/ietf-interfaces:interfaces-state/interface" path.
- * Here we reply systematically with all interfaces, it the responsability of
- * sysrepo apply a filter not to answer undesired interfaces.
+ * Interfaces are served from the interface cache, which is kept up to date
+ * by VPP interface events, instead of dumping them from VPP on each request.
+ * The interface name predicate and the leaf requested in original_xpath are
+ * honored, so that a get of one leaf of one interface costs one lookup.
  */
 static int
 ietf_interface_state_cb(const char *xpath, sr_val_t **values,
                         size_t *values_cnt, uint64_t request_id,
                         const char *original_xpath, void *private_ctx)
 {
-    UNUSED(request_id); UNUSED(original_xpath); UNUSED(private_ctx);
-    vapi_payload_sw_interface_details interface;
-    shared_ptr<interface_dump> dump;
+    UNUSED(request_id); UNUSED(private_ctx);
+    utils::xpath_filter filter(original_xpath, "interface", state_leaves);
+    interface_cache::details_t interface;
+    string if_name;
     sr_val_t *val = nullptr;
-    int vc = 6; //number of answer per interfaces
+    size_t vc = filter.count(state_leaves); //number of answer per interfaces
     int cnt = 0; //value counter
-    int interface_num = 0;
     int rc = SR_ERR_OK;
 
     SRP_LOG_INF("In %s", __FUNCTION__);
@@ -392,63 +582,38 @@ ietf_interface_state_cb(const char *xpath, sr_val_t **values,
     if (!sr_xpath_node_name_eq(xpath, "interface"))
         goto nothing_todo; //no interface field specified
 
-    dump = make_shared<interface_dump>();
-    HW::enqueue(dump);
-    HW::write();
-
-    interface_num = std::distance((*dump).begin(), (*dump).end());
-
-    /* allocate array of values to be returned */
-    SRP_LOG_DBG("number of interfaces: %d",  interface_num + 1);
-    rc = sr_new_values((interface_num + 1)* vc, &val);
-    if (0 != rc)
-        goto nothing_todo;
-
-    for (auto &it : *dump) {
-        interface = it.get_payload();
-
-        SRP_LOG_DBG("State of interface %s", interface.interface_name);
-
-        /* it needs if-mib YANG feature to work !
-         * admin-state: state as required by configuration */
-        sr_val_build_xpath(&val[cnt], "%s[name='%s']/admin-status", xpath,
-                           interface.interface_name);
-        sr_val_set_str_data(&val[cnt], SR_ENUM_T,
-                            (interface.flags == vapi_enum_if_status_flags::IF_STATUS_API_FLAG_ADMIN_UP) ?
-                            "up" : "down");
-        cnt++;
+    if_name = filter.key("name");
+    if (!if_name.empty()) {
+        /* a single interface is requested */
+        if (!interface_cache::instance().find(if_name, interface))
+            goto nothing_todo;
 
-        /* oper-state: effective state. can differ from admin-state */
-        sr_val_build_xpath(&val[cnt], "%s[name='%s']/oper-status", xpath,
-                           interface.interface_name);
-        sr_val_set_str_data(&val[cnt], SR_ENUM_T,
-                            (interface.flags == vapi_enum_if_status_flags::IF_STATUS_API_FLAG_LINK_UP) ?
-                            "up" : "down");
-        cnt++;
+        rc = sr_new_values(vc, &val);
+        if (SR_ERR_OK != rc)
+            goto nothing_todo;
 
-        sr_val_build_xpath(&val[cnt], "%s[name='%s']/phys-address", xpath,
-                           interface.interface_name);
-        sr_val_build_str_data(&val[cnt], SR_STRING_T,
-                              "%02x:%02x:%02x:%02x:%02x:%02x",
-                              interface.l2_address[0], interface.l2_address[1],
-                              interface.l2_address[2], interface.l2_address[3],
-                              interface.l2_address[4], interface.l2_address[5]);
-        cnt++;
+        ietf_interface_state_build(xpath, filter, interface, val, cnt);
 
-        sr_val_build_xpath(&val[cnt], "%s[name='%s']/if-index", xpath,
-                           interface.interface_name);
-        val[cnt].type = SR_INT32_T;
-        val[cnt].data.int32_val = interface.sw_if_index;
-        cnt++;
+    } else if (interface_cache::instance().read(
+        [&](const interface_cache::table_t &table) {
 
-        sr_val_build_xpath(&val[cnt], "%s[name='%s']/speed", xpath,
-                           interface.interface_name);
-        val[cnt].type = SR_UINT64_T;
-        val[cnt].data.uint64_val = interface.link_speed;
-        cnt++;
+        /* allocate array of values to be returned */
+        SRP_LOG_DBG("number of interfaces: %zu", table.size());
+        rc = sr_new_values(table.size() * vc, &val);
+        if (SR_ERR_OK != rc)
+            return;
 
+        for (auto &it : table)
+            ietf_interface_state_build(xpath, filter, it.second, val, cnt);
+    }) != rc_t::OK) {
+        SRP_LOG_ERR_MSG("Fail reading interfaces from VPP");
+        rc = SR_ERR_OPERATION_FAILED;
+        goto nothing_todo;
     }
 
+    if (SR_ERR_OK != rc)
+        goto nothing_todo;
+
     *values = val;
     *values_cnt = cnt;
 
@@ -460,21 +625,34 @@ nothing_todo:
     return rc;
 }
 
+/* Leaves replied by interface_statistics_cb */
+static const vector<string> statistics_leaves = {
+    "in-octets", "in-unicast-pkts", "in-broadcast-pkts", "in-multicast-pkts",
+    "out-octets", "out-unicast-pkts", "out-broadcast-pkts", "out-multicast-pkts"
+};
+
 /**
  * @brief Callback to be called by any request for state data under
  * "/ietf-interfaces:interfaces-state/interface/statistics" path.
+ * Only the counter requested in original_xpath, if any, is replied.
+ * sysrepo calls it once per interface: the interfaces and their counters
+ * are read on the first call of the request, the next calls reuse them.
  */
 static int
 interface_statistics_cb(const char *xpath, sr_val_t **values,
                         size_t *values_cnt, uint64_t request_id,
                         const char *original_xpath, void *private_ctx)
 {
-    UNUSED(request_id); UNUSED(original_xpath); UNUSED(private_ctx);
-    shared_ptr<interface> interface;
-    interface::stats_t stats;
+    UNUSED(private_ctx);
+    utils::xpath_filter filter(original_xpath, "statistics",
+                               statistics_leaves);
+    static thread_local utils::xpath_builder path;
+    shared_ptr<const sc_request> snapshot;
+    const interface_cache::details_t *details;
+    const if_counters_t *stats;
     string intf_name;
     sr_val_t *val = NULL;
-    int vc = 8;
+    int vc = filter.count(statistics_leaves);
     int cnt = 0; //value counter
     sr_xpath_ctx_t state;
     int rc = SR_ERR_OK;
@@ -489,9 +667,16 @@ interface_statistics_cb(const char *xpath, sr_val_t **values,
     }
     sr_xpath_recover(&state);
 
-    interface = interface::find(intf_name);
-    if (interface == nullptr) {
-        SRP_LOG_WRN("interface %s not found in VOM", intf_name.c_str());
+    snapshot = sc_request::get(request_id);
+    details = snapshot->find(intf_name);
+    if (!details) {
+        SRP_LOG_WRN("interface %s not found in VPP", intf_name.c_str());
+        goto nothing_todo;
+    }
+
+    stats = snapshot->counters(details->sw_if_index);
+    if (stats == nullptr) {
+        SRP_LOG_WRN("no counters for interface %s", intf_name.c_str());
         goto nothing_todo;
     }
 
@@ -500,55 +685,29 @@ interface_statistics_cb(const char *xpath, sr_val_t **values,
     if (0 != rc)
         goto nothing_todo;
 
-    stats = interface->get_stats();
-
-    //if/rx
-    sr_val_build_xpath(&val[cnt], "%s/in-octets", xpath, 5);
-    val[cnt].type = SR_UINT64_T;
-    val[cnt].data.uint64_val = stats.m_rx.bytes;
-    cnt++;
-
-    //if/rx-unicast
-    sr_val_build_xpath(&val[cnt], "%s/in-unicast-pkts", xpath, 5);
-    val[cnt].type = SR_UINT64_T;
-    val[cnt].data.uint64_val = stats.m_rx_unicast.packets;
-    cnt++;
-
-    //if/rx-broadcast
-    sr_val_build_xpath(&val[cnt], "%s/in-broadcast-pkts", xpath, 5);
-    val[cnt].type = SR_UINT64_T;
-    val[cnt].data.uint64_val = stats.m_rx_broadcast.packets;
-    cnt++;
-
-    //if/rx-multicast
-    sr_val_build_xpath(&val[cnt], "%s/in-multicast-pkts", xpath, 5);
-    val[cnt].type = SR_UINT64_T;
-    val[cnt].data.uint64_val = stats.m_rx_multicast.packets;
-    cnt++;
-
-    //if/tx
-    sr_val_build_xpath(&val[cnt], "%s/out-octets", xpath, 5);
-    val[cnt].type = SR_UINT64_T;
-    val[cnt].data.uint64_val = stats.m_tx.bytes;
-    cnt++;
-
-    //if/tx-unicast
-    sr_val_build_xpath(&val[cnt], "%s/out-unicast-pkts", xpath, 5);
-    val[cnt].type = SR_UINT64_T;
-    val[cnt].data.uint64_val = stats.m_tx_unicast.packets;
-    cnt++;
-
-    //if/tx-broadcast
-    sr_val_build_xpath(&val[cnt], "%s/out-broadcast-pkts", xpath, 5);
-    val[cnt].type = SR_UINT64_T;
-    val[cnt].data.uint64_val = stats.m_tx_broadcast.packets;
-    cnt++;
-
-    //if/tx-multicast
-    sr_val_build_xpath(&val[cnt], "%s/out-multicast-pkts", xpath, 5);
-    val[cnt].type = SR_UINT64_T;
-    val[cnt].data.uint64_val = stats.m_tx_multicast.packets;
-    cnt++;
+    {
+        const pair<const char *, uint64_t> counters[] = {
+            { "in-octets", stats->rx.bytes },
+            { "in-unicast-pkts", stats->rx_unicast.packets },
+            { "in-broadcast-pkts", stats->rx_broadcast.packets },
+            { "in-multicast-pkts", stats->rx_multicast.packets },
+            { "out-octets", stats->tx.bytes },
+            { "out-unicast-pkts", stats->tx_unicast.packets },
+            { "out-broadcast-pkts", stats->tx_broadcast.packets },
+            { "out-multicast-pkts", stats->tx_multicast.packets },
+        };
+
+        path.entry(xpath);
+        for (auto &counter : counters) {
+            if (!filter.wants(counter.first))
+                continue;
+
+            path.set(&val[cnt], counter.first);
+            val[cnt].type = SR_UINT64_T;
+            val[cnt].data.uint64_val = counter.second;
+            cnt++;
+        }
+    }
 
     *values = val;
     *values_cnt = cnt;
@@ -568,31 +727,31 @@ ietf_interface_init(sc_plugin_main_t *pm)
     int rc = SR_ERR_OK;
     SRP_LOG_DBG_MSG("Initializing ietf-interface plugin.");
 
-    rc = sr_subtree_change_subscribe(pm->session, "/ietf-interfaces:interfaces/interface",
+    rc = sc_subtree_change_subscribe(pm->session, "/ietf-interfaces:interfaces/interface",
             ietf_interface_create_cb, nullptr, 100, SR_SUBSCR_CTX_REUSE, &pm->subscription);
     if (SR_ERR_OK != rc) {
         goto error;
     }
 
-    rc = sr_subtree_change_subscribe(pm->session, "/ietf-interfaces:interfaces/interface/ietf-ip:ipv4/address",
+    rc = sc_subtree_change_subscribe(pm->session, IPV4_ADDRESS,
             ietf_interface_ipv46_address_change_cb, nullptr, 99, SR_SUBSCR_CTX_REUSE, &pm->subscription);
     if (SR_ERR_OK != rc) {
         goto error;
     }
 
-    rc = sr_subtree_change_subscribe(pm->session, "/ietf-interfaces:interfaces/interface/ietf-ip:ipv6/address",
+    rc = sc_subtree_change_subscribe(pm->session, IPV6_ADDRESS,
             ietf_interface_ipv46_address_change_cb, nullptr, 98, SR_SUBSCR_CTX_REUSE, &pm->subscription);
     if (SR_ERR_OK != rc) {
         goto error;
     }
 
-    rc = sr_dp_get_items_subscribe(pm->session, "/ietf-interfaces:interfaces-state",
+    rc = sc_dp_get_items_subscribe(pm->session, "/ietf-interfaces:interfaces-state",
             ietf_interface_state_cb, nullptr, SR_SUBSCR_CTX_REUSE, &pm->subscription);
     if (SR_ERR_OK != rc) {
         goto error;
     }
 
-    rc = sr_dp_get_items_subscribe(pm->session, "/ietf-interfaces:interfaces-state/interface/statistics",
+    rc = sc_dp_get_items_subscribe(pm->session, "/ietf-interfaces:interfaces-state/interface/statistics",
             interface_statistics_cb, NULL, SR_SUBSCR_CTX_REUSE, &pm->subscription);
     if (SR_ERR_OK != rc) {
         goto error;
@@ -31,27 +31,57 @@
  * NAT instance policies:
  * ======================
  *
- * VOM NAT
+ * VPP NAT
  * ========
  * -Support NAT44/NAT66 static mapping (IP by IP) without transport protocol (NAT_IS_ADDR_ONLY)
- * -Support declaration of an interface as an INSIDE/OUTSIDE interface.
+ * -Static mappings of a commit are programmed with pipelined requests rather
+ *  than one VOM object each, so that large tables load fast.
+ * -Mappings are indexed by inside and outside address: a mapping reusing an
+ *  address of another one is rejected on verify, before VPP is programmed.
+ * -Changing a leaf of a programmed mapping deletes it and adds it again with
+ *  its other leaves unchanged.
+ *
+ * NAT state
+ * =========
+ * sweetcomb-nat augments instances with the static mappings and NAT44
+ * sessions read from VPP. Sessions are dumped one inside address at a time,
+ * and a reply holds at most NAT_ENTRIES_MAX sessions or static mappings:
+ * sysrepo wants a reply in a single array, while VPP may hold millions of
+ * sessions. A request selecting more fails rather than reply part of them,
+ * larger tables are read by inside or internal address. The dumps go
+ * through the read connections, so they neither wait for nor delay commits.
  *
  * TODO ideas of new features which can be supported
  * -Support for internal/external port in VOM and sweetcomb
  * -Support for dynamic NAT in VOM and sweetcomb
  */
 
+#include <algorithm>
 #include <string>
 #include <exception>
 #include <memory>
+#include <map>
+#include <mutex>
+#include <cstdio>
+#include <cstdlib>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <vom/hw.hpp>
+#include <vpp-oper/cmd_window.hpp>
+#include <vpp-oper/nat.hpp>
+#include <vpp-oper/read_pool.hpp>
 
-#include <vom/om.hpp>
-#include <vom/nat_static.hpp>
+#include <arpa/inet.h>
 
+#include "sc_latency.h"
 #include "sc_plugins.h"
+#include "sc_running.h"
+#include "sc_transaction.h"
 #include "sys_util.h"
 
-using VOM::OM;
+using VOM::HW;
 using VOM::rc_t;
 
 /* Just to intercept request trying to create nat instances */
@@ -66,10 +96,8 @@ nat_instance_config_cb(sr_session_ctx_t *ds, const char *xpath,
     return SR_ERR_OK;
 }
 
-typedef std::pair<boost::asio::ip::address, boost::asio::ip::address> nat_pair_t;
-typedef std::map<uint32_t, nat_pair_t> nat_table_t;
-
-static nat_table_t static_mapping_table;
+/* (inside, outside) addresses of a static mapping */
+typedef std::pair<utils::prefix, utils::prefix> nat_pair_t;
 
 /*
  * Valid pairs for static NAT are:
@@ -86,125 +114,382 @@ public:
     /* Default constructor */
     nat_static_builder() {}
 
-    shared_ptr<VOM::nat_static> build() {
+    /* Fill pair with the mapping, false if it is not a valid one */
+    bool build(nat_pair_t &pair) {
 
         if (m_type != "static") //only static is supported for now
-            return nullptr;
+            return false;
 
         if (! m_internal_src.empty() && ! m_external_src.empty() ) {
-            m_inside = m_internal_src.address();
-            m_outside = m_external_src.address();
+            pair = nat_pair_t(m_internal_src, m_external_src);
         } else if (! m_internal_dest.empty() && ! m_external_dest.empty() ) {
-            m_inside = m_internal_dest.address();
-            m_outside = m_external_dest.address();
+            pair = nat_pair_t(m_internal_dest, m_external_dest);
         } else
-            return nullptr;
+            return false;
 
-        return make_shared<VOM::nat_static>(m_inside, m_outside);
+        return pair.first.family() == pair.second.family();
     }
 
-    /* Getters */
-    boost::asio::ip::address inside ()
-    { return m_inside; }
-    boost::asio::ip::address outside()
-    { return m_outside; }
-
-    /* Setters */
+    /* Setters, the address ones return false if p is not a prefix, and
+     * unset the address if p is null, e.g. for a leaf deleted */
     nat_static_builder& set_type(std::string t)
     {
         m_type = t;
         return *this;
     }
-    nat_static_builder& set_internal_src(std::string p)
+    bool set_internal_src(const char *p)
     {
-        m_internal_src = utils::prefix::make_prefix(p);
-        return *this;
+        return assign(p, m_internal_src);
     }
-    nat_static_builder& set_external_src(std::string p)
+    bool set_external_src(const char *p)
     {
-        m_external_src = utils::prefix::make_prefix(p);
-        return *this;
+        return assign(p, m_external_src);
     }
-    nat_static_builder& set_internal_dest(std::string p)
+    bool set_internal_dest(const char *p)
     {
-        m_internal_dest = utils::prefix::make_prefix(p);
-        return *this;
+        return assign(p, m_internal_dest);
     }
-    nat_static_builder& set_external_dest(std::string p)
+    bool set_external_dest(const char *p)
     {
-        m_external_dest = utils::prefix::make_prefix(p);
-        return *this;
+        return assign(p, m_external_dest);
     }
 
 private:
+    static bool assign(const char *p, utils::prefix &addr)
+    {
+        if (!p) {
+            addr = utils::prefix();
+            return true;
+        }
+
+        return utils::prefix::parse(p, addr);
+    }
+
     std::string m_type;
     utils::prefix m_internal_src;
     utils::prefix m_external_src;
     utils::prefix m_internal_dest;
     utils::prefix m_external_dest;
-    boost::asio::ip::address m_inside;
-    boost::asio::ip::address m_outside;
 };
 
+/*
+ * Static mappings pushed to VPP, by index and by inside and outside address
+ * so that a mapping reusing an address is found without a scan. The leaves
+ * configured for each are kept, for an entry changed one leaf at a time.
+ */
+class nat_mapping_table {
+public:
+    /* Index of the mapping with this inside address, false if none */
+    bool find_inside(const utils::prefix &in, uint32_t &index)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        return find(m_by_inside, in, index);
+    }
+
+    /* Index of the mapping with this outside address, false if none */
+    bool find_outside(const utils::prefix &out, uint32_t &index)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        return find(m_by_outside, out, index);
+    }
+
+    /* Mapping of index, false if none */
+    bool get(uint32_t index, nat_pair_t &pair)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        auto it = m_by_index.find(index);
+        if (it == m_by_index.end())
+            return false;
+        pair = it->second.pair;
+
+        return true;
+    }
+
+    /* Mapping of index and the leaves it was built from, false if none */
+    bool get(uint32_t index, nat_pair_t &pair, nat_static_builder &config)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        auto it = m_by_index.find(index);
+        if (it == m_by_index.end())
+            return false;
+        pair = it->second.pair;
+        config = it->second.config;
+
+        return true;
+    }
+
+    void add(uint32_t index, const nat_pair_t &pair,
+             const nat_static_builder &config)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        m_by_index[index] = { pair, config };
+        m_by_inside[pair.first] = index;
+        m_by_outside[pair.second] = index;
+    }
+
+    void remove(uint32_t index)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        auto it = m_by_index.find(index);
+        if (it == m_by_index.end())
+            return;
+        m_by_inside.erase(it->second.pair.first);
+        m_by_outside.erase(it->second.pair.second);
+        m_by_index.erase(it);
+    }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        return m_by_index.size();
+    }
+
+    /* Declare all the mappings to a reconcile */
+    void describe(reconcile &r)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        for (auto &m : m_by_index)
+            r.nat_static(m.second.pair.first.address(),
+                         m.second.pair.second.address());
+    }
+
+private:
+    struct entry_t {
+        nat_pair_t pair;
+        nat_static_builder config;
+    };
+
+    typedef std::unordered_map<utils::prefix, uint32_t> index_t;
+
+    static bool find(const index_t &idx, const utils::prefix &p,
+                     uint32_t &index)
+    {
+        auto it = idx.find(p);
+        if (it == idx.end())
+            return false;
+        index = it->second;
+
+        return true;
+    }
+
+    std::mutex m_lock;
+    std::unordered_map<uint32_t, entry_t> m_by_index;
+    index_t m_by_inside;
+    index_t m_by_outside;
+};
+
+static nat_mapping_table mapping_table;
+
+typedef std::map<uint32_t, nat_pair_t> nat_changes_t;
+
+/*
+ * Return true if a mapping added reuses the inside or outside address of
+ * another one, whether already pushed to VPP and kept by this commit or
+ * added by this commit too.
+ */
+static bool
+nat_mapping_conflict(const nat_changes_t &dels, const nat_changes_t &adds)
+{
+    std::unordered_set<utils::prefix> inside, outside;
+    uint32_t other;
+
+    inside.reserve(adds.size());
+    outside.reserve(adds.size());
+
+    for (auto &a : adds) {
+        const nat_pair_t &pair = a.second;
+
+        if (mapping_table.find_inside(pair.first, other) && !dels.count(other)) {
+            SRP_LOG_ERR("Mapping %u: inside address %s already mapped by %u",
+                        a.first, pair.first.to_string().c_str(), other);
+            return true;
+        }
+        if (mapping_table.find_outside(pair.second, other) && !dels.count(other)) {
+            SRP_LOG_ERR("Mapping %u: outside address %s already mapped by %u",
+                        a.first, pair.second.to_string().c_str(), other);
+            return true;
+        }
+        if (!inside.insert(pair.first).second ||
+            !outside.insert(pair.second).second) {
+            SRP_LOG_ERR("Mapping %u: addresses %s %s mapped twice", a.first,
+                        pair.first.to_string().c_str(),
+                        pair.second.to_string().c_str());
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Delete then add the mappings with one batch of requests each */
+static rc_t
+nat_mapping_program(const nat_changes_t &dels, const nat_changes_t &adds)
+{
+    nat_static_batch del(false);
+    nat_static_batch add(true);
+
+    for (auto &d : dels)
+        del.add(d.second.first.address(), d.second.second.address());
+    for (auto &a : adds)
+        add.add(a.second.first.address(), a.second.second.address());
+
+    del.enqueue();
+    add.enqueue();
+    HW::write();
+
+    if (del.failed() || add.failed()) {
+        SRP_LOG_ERR("Fail programming NAT static mappings: %zu of %zu "
+                    "removals, %zu of %zu additions", del.failed(), del.size(),
+                    add.failed(), add.size());
+        return rc_t::INVALID;
+    }
+
+    return rc_t::OK;
+}
+
+/* Leaves of a mapping entry handled by nat_mapping_table_config_cb */
+enum mapping_leaf_t {
+    MAPPING_INDEX,
+    MAPPING_TYPE,
+    MAPPING_INTERNAL_SRC,
+    MAPPING_EXTERNAL_SRC,
+    MAPPING_INTERNAL_DST,
+    MAPPING_EXTERNAL_DST,
+};
+
+#define MAPPING_ENTRY \
+    "/ietf-nat:nat/instances/instance/mapping-table/mapping-entry"
+
+static const utils::schema_dispatch mapping_entry_leaves = {
+    { MAPPING_ENTRY "/index", MAPPING_INDEX },
+    { MAPPING_ENTRY "/type", MAPPING_TYPE },
+    { MAPPING_ENTRY "/internal-src-address", MAPPING_INTERNAL_SRC },
+    { MAPPING_ENTRY "/external-src-address", MAPPING_EXTERNAL_SRC },
+    { MAPPING_ENTRY "/internal-dst-address", MAPPING_INTERNAL_DST },
+    { MAPPING_ENTRY "/external-dst-address", MAPPING_EXTERNAL_DST },
+};
+
+/* Changes of one mapping entry within a commit */
+struct nat_entry_edit_t {
+    nat_entry_edit_t() : created(false), deleted(false) {}
+
+    /* the entry itself is created, or deleted */
+    bool created;
+    bool deleted;
+    /* leaves set with their value, and leaves deleted */
+    std::vector<std::pair<int, std::string>> set;
+    std::vector<int> unset;
+};
+
+/* Set leaf of b to value, unset it if value is null. Return false if value
+ * is not valid */
+static bool
+nat_leaf_set(nat_static_builder &b, int leaf, const char *value)
+{
+    switch (leaf) {
+    case MAPPING_TYPE:
+        /* For configuration only "static" can be supported */
+        b.set_type(value ? value : "");
+        break;
+    case MAPPING_INTERNAL_SRC:
+        /* source IP on NAT internal network src address */
+        return b.set_internal_src(value);
+    case MAPPING_EXTERNAL_SRC:
+        /* source IP on NAT external network src address */
+        return b.set_external_src(value);
+    case MAPPING_INTERNAL_DST:
+        /* destination IP on NAT internal network src address */
+        return b.set_internal_dest(value);
+    case MAPPING_EXTERNAL_DST:
+        /* destination IP on NAT internal network src address */
+        return b.set_external_dest(value);
+    }
+
+    return true;
+}
+
 /*
  * /ietf-nat:nat/instances/instance[id='%s']/mapping-table/mapping-entry[index='%s']/
+ *
+ * An entry created in the commit is built from its leaves alone. Leaves
+ * changed in an entry kept are applied to the ones it was built from, and
+ * the mapping is deleted then added again.
  */
 static int
 nat_mapping_table_config_cb(sr_session_ctx_t *ds, const char *xpath,
                             sr_notif_event_t event, void *private_ctx)
 {
     UNUSED(private_ctx);
-    nat_static_builder builder;
-    std::shared_ptr<VOM::nat_static> ns = nullptr;
+    std::shared_ptr<sc_transaction> tx = sc_transaction::of(ds);
+    std::map<uint32_t, nat_entry_edit_t> edits;
+    typedef std::map<uint32_t, nat_static_builder> configs_t;
+    std::shared_ptr<configs_t> configs = std::make_shared<configs_t>();
+    std::shared_ptr<nat_changes_t> dels = std::make_shared<nat_changes_t>();
+    std::shared_ptr<nat_changes_t> adds = std::make_shared<nat_changes_t>();
+    nat_pair_t pair;
     sr_val_t *ol = nullptr;
     sr_val_t *ne = nullptr;
-    sr_change_iter_t *it;
+    sc_change_iter_t *it = nullptr;
     sr_change_oper_t oper;
+    utils::xpath_keys keys;
+    std::string key;
+    int leaf;
     uint32_t xindex; // mapping entry index from xpath
-    bool create, remove;
     int rc;
 
     ARG_CHECK2(SR_ERR_INVAL_ARG, ds, xpath);
 
+    /* changes of the whole commit are pushed to VPP at once on apply */
+    if (event == SR_EV_APPLY)
+        return tx->commit();
+
+    if (event == SR_EV_ABORT) {
+        tx->abort();
+        return SR_ERR_OK;
+    }
+
     if (event != SR_EV_VERIFY)
         return SR_ERR_OK;
 
     SRP_LOG_INF("In %s", __FUNCTION__);
 
-    rc = sr_get_changes_iter(ds, (char *)xpath, &it);
+    rc = sc_get_changes_iter(ds, (char *)xpath, &it);
     if (rc != SR_ERR_OK)
         goto error;
 
     foreach_change(ds, it, oper, ol, ne) {
 
+        /* instance id then mapping entry index are the keys of the path */
+        leaf = mapping_entry_leaves.match(ne ? ne->xpath : ol->xpath, keys);
+        key = keys.value(1);
+        if (key.empty()) {
+            rc = SR_ERR_INVAL_ARG;
+            goto error;
+        }
+        xindex = std::stoul(key);
+
         switch (oper) {
         case SR_OP_CREATED:
-            if (sr_xpath_node_name_eq(ne->xpath, "index")) {
-                xindex = ne->data.uint32_val;
-                create = true;
-            } else if (sr_xpath_node_name_eq(ne->xpath, "type")) {
-                /* For configuration only "static" can be supported */
-                builder.set_type(string(ne->data.string_val));
-            } else if (sr_xpath_node_name_eq(ne->xpath, "internal-src-address")) {
-                /* source IP on NAT internal network src address */
-                builder.set_internal_src(string(ne->data.string_val));
-            } else if (sr_xpath_node_name_eq(ne->xpath, "external-src-address")) {
-                /* source IP on NAT external network src address */
-                builder.set_external_src(string(ne->data.string_val));
-            } else if (sr_xpath_node_name_eq(ne->xpath, "internal-dst-address")) {
-                /* destination IP on NAT internal network src address */
-                builder.set_internal_dest(string(ne->data.string_val));
-            } else if (sr_xpath_node_name_eq(ne->xpath, "external-dst-address")) {
-                /* destination IP on NAT internal network src address */
-                builder.set_external_dest(string(ne->data.string_val));
-            }
+        case SR_OP_MODIFIED:
+            if (MAPPING_INDEX == leaf)
+                edits[xindex].created = true;
+            else if (leaf >= 0)
+                edits[xindex].set.emplace_back(leaf, ne->data.string_val);
             break;
 
         case SR_OP_DELETED:
-            if (sr_xpath_node_name_eq(ol->xpath, "index")) {
-                xindex = ol->data.uint32_val;
-                remove = true;
-            }
+            if (MAPPING_INDEX == leaf)
+                edits[xindex].deleted = true;
+            else if (leaf >= 0)
+                edits[xindex].unset.push_back(leaf);
             break;
 
         default:
@@ -217,42 +502,74 @@ nat_mapping_table_config_cb(sr_session_ctx_t *ds, const char *xpath,
         sr_free_val(ol);
     }
 
-    sr_free_change_iter(it);
+    sc_free_change_iter(it);
 
-    if (create) {
-        ns = builder.build();
-        if (ns == nullptr) {
-            SRP_LOG_ERR("Fail building nat %s %s",
-                        builder.inside().to_string().c_str(),
-                        builder.outside().to_string().c_str());
-            rc = SR_ERR_INVAL_ARG;
-            goto error;
+    for (auto &e : edits) {
+        const nat_entry_edit_t &edit = e.second;
+        nat_static_builder b;
+        bool exists = mapping_table.get(e.first, pair, b);
+
+        if (exists)
+            (*dels)[e.first] = pair;
+
+        if (edit.created) {
+            b = nat_static_builder();
+        } else if (edit.deleted) {
+            continue;
+        } else if (!exists) {
+            SRP_LOG_WRN("Mapping %u changed but not programmed, left out",
+                        e.first);
+            continue;
+        } else {
+            for (int l : edit.unset)
+                nat_leaf_set(b, l, nullptr);
         }
-    }
 
-    if (create) {
-        #define KEY(xindex) to_string(xindex)
-        if (OM::write(KEY(xindex), *ns) != rc_t::OK) {
-            SRP_LOG_ERR("Fail writing changes for nat: %s",
-                        ns->to_string().c_str());
-            rc = SR_ERR_OPERATION_FAILED;
-            goto error;
+        for (auto &l : edit.set) {
+            if (!nat_leaf_set(b, l.first, l.second.c_str())) {
+                SRP_LOG_ERR("Invalid prefix %s", l.second.c_str());
+                tx->abort();
+                return SR_ERR_INVAL_ARG;
+            }
         }
-        static_mapping_table[xindex] =  nat_pair_t(builder.inside(),
-                                                   builder.outside());
-        SRP_LOG_INF_MSG("Sucess creating nat static entry");
-    } else if (remove) {
-        OM::remove(KEY(xindex));
-        static_mapping_table.erase(xindex);
-        #undef KEY
+
+        if (!b.build(pair)) {
+            SRP_LOG_ERR("Fail building nat mapping %u", e.first);
+            tx->abort();
+            return SR_ERR_INVAL_ARG;
+        }
+        (*adds)[e.first] = pair;
+        (*configs)[e.first] = b;
+    }
+
+    if (nat_mapping_conflict(*dels, *adds)) {
+        tx->abort();
+        return SR_ERR_INVAL_ARG;
     }
 
+    if (dels->empty() && adds->empty())
+        return SR_ERR_OK;
+
+    /* the table describes all the mappings, whichever commit made them */
+    tx->program("nat-static-mappings", sc_transaction::STAGE_NAT,
+                [dels, adds]() { return nat_mapping_program(*dels, *adds); },
+                [](reconcile &r) { mapping_table.describe(r); });
+
+    /* at once, for the next commits to be verified against */
+    tx->on_apply([dels, adds, configs]() {
+        for (auto &d : *dels)
+            mapping_table.remove(d.first);
+        for (auto &a : *adds)
+            mapping_table.add(a.first, a.second, (*configs)[a.first]);
+    });
+
     return SR_ERR_OK;
 
 error:
     sr_free_val(ol);
     sr_free_val(ne);
-    sr_free_change_iter(it);
+    sc_free_change_iter(it);
+    tx->abort();
     return rc;
 }
 
@@ -295,30 +612,536 @@ nothing_todo:
 }
 
 
+/* Bound of the sessions or static mappings in one reply, beyond it they
+ * have to be read by inside or internal address */
+static const size_t NAT_ENTRIES_MAX = 16384;
+
+/* Users whose sessions are dumped at once */
+static const size_t NAT_USERS_PIPELINED = 32;
+
+/* Leaves replied for each static mapping and each session, their keys are
+ * part of the entry xpath */
+static const std::vector<std::string> mapping_leaves = {
+    "external-address", "external-port", "vrf-id"
+};
+static const std::vector<std::string> session_leaves = {
+    "outside-address", "outside-port", "vrf-id", "last-heard", "total-bytes",
+    "total-packets"
+};
+
+/*
+ * Key predicates of a request for a nat-state list, in the form the keys of
+ * the entries are formatted in, so that entries are selected by comparing
+ * strings. A predicate which is not a valid value selects nothing.
+ */
+class nat_key_filter {
+public:
+    nat_key_filter(const utils::xpath_filter &filter,
+                   const std::vector<std::string> &addresses,
+                   const std::vector<std::string> &numbers)
+        : m_valid(true)
+    {
+        unsigned char bytes[sizeof(struct in6_addr)];
+        char buf[INET6_ADDRSTRLEN];
+        std::string key;
+        char *end;
+
+        for (auto &name : addresses) {
+            key = filter.key(name);
+            if (key.empty())
+                continue;
+            if (inet_pton(AF_INET, key.c_str(), bytes) == 1)
+                inet_ntop(AF_INET, bytes, buf, sizeof(buf));
+            else if (inet_pton(AF_INET6, key.c_str(), bytes) == 1)
+                inet_ntop(AF_INET6, bytes, buf, sizeof(buf));
+            else {
+                m_valid = false;
+                continue;
+            }
+            m_keys.emplace_back(name, buf);
+        }
+
+        for (auto &name : numbers) {
+            key = filter.key(name);
+            if (key.empty())
+                continue;
+            unsigned long n = strtoul(key.c_str(), &end, 10);
+            if (*end != '\0') {
+                m_valid = false;
+                continue;
+            }
+            m_keys.emplace_back(name, std::to_string(n));
+        }
+    }
+
+    /* Return false if no entry can be selected */
+    bool valid() const { return m_valid; }
+
+    /* Return true if no key but name has a predicate */
+    bool only(const char *name) const
+    {
+        for (auto &k : m_keys) {
+            if (k.first != name)
+                return false;
+        }
+
+        return true;
+    }
+
+    /* Return false if key has a predicate for another value */
+    bool wants(const char *key, const char *value) const
+    {
+        for (auto &k : m_keys) {
+            if (k.first == key)
+                return k.second == value;
+        }
+
+        return true;
+    }
+
+private:
+    bool m_valid;
+    std::vector<std::pair<std::string, std::string>> m_keys;
+};
+
+/* Run dump in VPP, on a read connection: not behind the commits */
+template <typename DUMP>
+static bool
+nat_hw_read(const std::shared_ptr<DUMP> &dump)
+{
+    return rc_t::OK == read_pool::instance().issue(dump);
+}
+
+/* Make room for n values after the cnt ones of val, which has size ones */
+static int
+nat_values_reserve(sr_val_t **val, size_t cnt, size_t n, size_t &size)
+{
+    size_t want = cnt + n;
+
+    if (want <= size)
+        return SR_ERR_OK;
+
+    want = std::max(want, 2 * size);
+    if (0 != sr_realloc_values(size, want, val))
+        return SR_ERR_NOMEM;
+    size = want;
+
+    return SR_ERR_OK;
+}
+
+static void
+nat_val_set_uint(sr_val_t *val, sr_type_t type, uint64_t n)
+{
+    val->type = type;
+    switch (type) {
+    case SR_UINT8_T:
+        val->data.uint8_val = n;
+        break;
+    case SR_UINT16_T:
+        val->data.uint16_val = n;
+        break;
+    case SR_UINT32_T:
+        val->data.uint32_val = n;
+        break;
+    default:
+        val->data.uint64_val = n;
+        break;
+    }
+}
+
+/* Append one static mapping, keys are selected by keys and leaves by
+ * filter; mappings counts those appended so far, at most NAT_ENTRIES_MAX */
+static int
+nat_mapping_append(const char *xpath, const utils::xpath_filter &filter,
+                   const nat_key_filter &keys, int family, const uint8_t *in,
+                   uint8_t protocol, uint16_t in_port, const uint8_t *out,
+                   uint16_t out_port, uint32_t vrf_id, sr_val_t **val,
+                   size_t &cnt, size_t &size, size_t &mappings)
+{
+    static thread_local utils::xpath_builder path;
+    static thread_local std::string entry;
+    char inside[INET6_ADDRSTRLEN], outside[INET6_ADDRSTRLEN];
+    char proto[4], port[6];
+    int rc;
+
+    inet_ntop(family, in, inside, sizeof(inside));
+    snprintf(proto, sizeof(proto), "%u", protocol);
+    snprintf(port, sizeof(port), "%u", in_port);
+    if (!keys.wants("internal-address", inside) ||
+        !keys.wants("protocol", proto) ||
+        !keys.wants("internal-port", port))
+        return SR_ERR_OK;
+
+    if (++mappings > NAT_ENTRIES_MAX) {
+        SRP_LOG_ERR("More than %zu NAT static mappings, read them by "
+                    "internal-address", NAT_ENTRIES_MAX);
+        return SR_ERR_OPERATION_FAILED;
+    }
+
+    rc = nat_values_reserve(val, cnt, filter.count(mapping_leaves), size);
+    if (SR_ERR_OK != rc)
+        return rc;
+
+    entry.assign(xpath).append("[internal-address='").append(inside);
+    entry.append("'][protocol='").append(proto);
+    entry.append("'][internal-port='").append(port).append("']");
+    path.entry(entry.c_str());
+
+    if (filter.wants("external-address")) {
+        inet_ntop(family, out, outside, sizeof(outside));
+        path.set(&(*val)[cnt], "external-address");
+        sr_val_set_str_data(&(*val)[cnt], SR_STRING_T, outside);
+        cnt++;
+    }
+    if (filter.wants("external-port")) {
+        path.set(&(*val)[cnt], "external-port");
+        nat_val_set_uint(&(*val)[cnt], SR_UINT16_T, out_port);
+        cnt++;
+    }
+    if (filter.wants("vrf-id")) {
+        path.set(&(*val)[cnt], "vrf-id");
+        nat_val_set_uint(&(*val)[cnt], SR_UINT32_T, vrf_id);
+        cnt++;
+    }
+
+    return SR_ERR_OK;
+}
+
+/* Static mappings, NAT44 ones then NAT66 ones, each dump is released
+ * before the next is read. Fail if more than NAT_ENTRIES_MAX are
+ * selected. */
+static int
+nat_mappings_get(const char *xpath, const char *original_xpath,
+                 sr_val_t **val, size_t &cnt)
+{
+    utils::xpath_filter filter(original_xpath, "static-mapping",
+                               mapping_leaves);
+    nat_key_filter keys(filter, { "internal-address" },
+                        { "protocol", "internal-port" });
+    size_t size = 0, mappings = 0;
+    int rc = SR_ERR_OK;
+
+    if (!keys.valid() || 0 == filter.count(mapping_leaves))
+        return SR_ERR_OK;
+
+    {
+        auto dump = std::make_shared<nat44_static_mapping_dump>();
+
+        if (!nat_hw_read(dump))
+            return SR_ERR_OPERATION_FAILED;
+
+        for (auto &it : *dump) {
+            const auto &m = it.get_payload();
+
+            rc = nat_mapping_append(xpath, filter, keys, AF_INET,
+                                    m.local_ip_address, m.protocol,
+                                    m.local_port, m.external_ip_address,
+                                    m.external_port, m.vrf_id, val, cnt,
+                                    size, mappings);
+            if (SR_ERR_OK != rc)
+                return rc;
+        }
+    }
+
+    /* NAT66 mappings are address only */
+    if (!keys.wants("protocol", "0") || !keys.wants("internal-port", "0"))
+        return SR_ERR_OK;
+
+    {
+        auto dump = std::make_shared<nat66_static_mapping_dump>();
+
+        if (!nat_hw_read(dump))
+            return SR_ERR_OPERATION_FAILED;
+
+        for (auto &it : *dump) {
+            const auto &m = it.get_payload();
+
+            rc = nat_mapping_append(xpath, filter, keys, AF_INET6,
+                                    m.local_ip_address, 0, 0,
+                                    m.external_ip_address, 0, m.vrf_id, val,
+                                    cnt, size, mappings);
+            if (SR_ERR_OK != rc)
+                return rc;
+        }
+    }
+
+    return rc;
+}
+
+/* Append the leaves of one session selected by filter, its keys have been
+ * formatted in entry */
+static void
+nat_session_build(const char *entry, const utils::xpath_filter &filter,
+                  uint32_t vrf_id,
+                  const vapi_payload_nat44_user_session_details &s,
+                  sr_val_t *val, size_t &cnt)
+{
+    static thread_local utils::xpath_builder path;
+    char outside[INET_ADDRSTRLEN];
+    const std::pair<const char *, uint64_t> counters[] = {
+        { "last-heard", s.last_heard },
+        { "total-bytes", s.total_bytes },
+        { "total-packets", s.total_pkts },
+    };
+
+    path.entry(entry);
+
+    if (filter.wants("outside-address")) {
+        inet_ntop(AF_INET, s.outside_ip_address, outside, sizeof(outside));
+        path.set(&val[cnt], "outside-address");
+        sr_val_set_str_data(&val[cnt], SR_STRING_T, outside);
+        cnt++;
+    }
+    if (filter.wants("outside-port")) {
+        path.set(&val[cnt], "outside-port");
+        nat_val_set_uint(&val[cnt], SR_UINT16_T, s.outside_port);
+        cnt++;
+    }
+    if (filter.wants("vrf-id")) {
+        path.set(&val[cnt], "vrf-id");
+        nat_val_set_uint(&val[cnt], SR_UINT32_T, vrf_id);
+        cnt++;
+    }
+    for (auto &c : counters) {
+        if (!filter.wants(c.first))
+            continue;
+        path.set(&val[cnt], c.first);
+        nat_val_set_uint(&val[cnt], SR_UINT64_T, c.second);
+        cnt++;
+    }
+}
+
+/* Append the sessions of one user selected by keys; sessions counts those
+ * appended so far, fail beyond NAT_ENTRIES_MAX */
+static int
+nat_sessions_append(const char *xpath, const utils::xpath_filter &filter,
+                    const nat_key_filter &keys, nat44_user_session_dump &dump,
+                    sr_val_t **val, size_t &cnt, size_t &size,
+                    size_t &sessions)
+{
+    static thread_local std::string entry;
+    size_t leaves = filter.count(session_leaves);
+    std::string inside = dump.user().to_string();
+    char host[INET_ADDRSTRLEN];
+    char proto[6], port[6], host_port[6];
+    int rc;
+
+    for (auto &it : dump) {
+        const auto &s = it.get_payload();
+
+        snprintf(proto, sizeof(proto), "%u", s.protocol);
+        snprintf(port, sizeof(port), "%u", s.inside_port);
+        snprintf(host_port, sizeof(host_port), "%u", s.ext_host_port);
+        inet_ntop(AF_INET, s.ext_host_address, host, sizeof(host));
+        if (!keys.wants("protocol", proto) ||
+            !keys.wants("inside-port", port) ||
+            !keys.wants("external-host-address", host) ||
+            !keys.wants("external-host-port", host_port))
+            continue;
+
+        if (sessions == NAT_ENTRIES_MAX) {
+            SRP_LOG_ERR("More than %zu NAT sessions, read them by "
+                        "inside-address", NAT_ENTRIES_MAX);
+            return SR_ERR_OPERATION_FAILED;
+        }
+
+        rc = nat_values_reserve(val, cnt, leaves, size);
+        if (SR_ERR_OK != rc)
+            return rc;
+
+        entry.assign(xpath).append("[protocol='").append(proto);
+        entry.append("'][inside-address='").append(inside);
+        entry.append("'][inside-port='").append(port);
+        entry.append("'][external-host-address='").append(host);
+        entry.append("'][external-host-port='").append(host_port);
+        entry.append("']");
+
+        nat_session_build(entry.c_str(), filter, dump.vrf_id(), s, *val, cnt);
+        sessions++;
+    }
+
+    return SR_ERR_OK;
+}
+
+/* NAT44 sessions, dumped NAT_USERS_PIPELINED users (inside addresses) at a
+ * time: their dumps are pipelined, and only their sessions are held besides
+ * the reply. With an inside-address predicate, only the sessions of that
+ * user are dumped. The users dump tells how many sessions each has: with
+ * no other predicate, a selection of more than NAT_ENTRIES_MAX fails
+ * before they are dumped. */
+static int
+nat_sessions_get(const char *xpath, const char *original_xpath,
+                 sr_val_t **val, size_t &cnt)
+{
+    utils::xpath_filter filter(original_xpath, "session", session_leaves);
+    nat_key_filter keys(filter, { "inside-address", "external-host-address" },
+                        { "protocol", "inside-port", "external-host-port" });
+    std::vector<std::shared_ptr<nat44_user_session_dump>> dumps;
+    char inside[INET_ADDRSTRLEN];
+    size_t size = 0, sessions = 0;
+    uint64_t selected = 0;
+    int rc;
+
+    if (!keys.valid() || 0 == filter.count(session_leaves))
+        return SR_ERR_OK;
+
+    auto users = std::make_shared<nat44_user_dump>();
+    if (!nat_hw_read(users))
+        return SR_ERR_OPERATION_FAILED;
+
+    for (auto &u : *users) {
+        const auto &user = u.get_payload();
+        boost::asio::ip::address_v4::bytes_type bytes;
+
+        inet_ntop(AF_INET, user.ip_address, inside, sizeof(inside));
+        if (!keys.wants("inside-address", inside))
+            continue;
+
+        std::copy(user.ip_address, user.ip_address + bytes.size(),
+                  bytes.begin());
+        dumps.push_back(std::make_shared<nat44_user_session_dump>(
+            boost::asio::ip::address_v4(bytes), user.vrf_id));
+        selected += user.nsessions + user.nstaticsessions;
+    }
+
+    if (selected > NAT_ENTRIES_MAX && keys.only("inside-address")) {
+        SRP_LOG_ERR("%llu NAT sessions, more than %zu, read them by "
+                    "inside-address", (unsigned long long) selected,
+                    NAT_ENTRIES_MAX);
+        return SR_ERR_OPERATION_FAILED;
+    }
+
+    for (size_t first = 0; first < dumps.size();
+         first += NAT_USERS_PIPELINED) {
+        size_t last = std::min(dumps.size(), first + NAT_USERS_PIPELINED);
+        auto pipeline = std::make_shared<pipeline_cmd>("nat44-user-session");
+
+        for (size_t i = first; i < last; i++)
+            pipeline->add(dumps[i]);
+        if (!nat_hw_read(pipeline))
+            return SR_ERR_OPERATION_FAILED;
+
+        for (size_t i = first; i < last; i++) {
+            rc = nat_sessions_append(xpath, filter, keys, *dumps[i], val, cnt,
+                                     size, sessions);
+            if (SR_ERR_OK != rc)
+                return rc;
+            dumps[i].reset();
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+/* Number of users and of sessions, from the users dump only */
+static int
+nat_counters_get(const char *xpath, const char *original_xpath,
+                 sr_val_t **val, size_t &cnt)
+{
+    static const std::vector<std::string> leaves = { "users", "sessions" };
+    utils::xpath_filter filter(original_xpath, "nat-state", leaves);
+    uint64_t users = 0, sessions = 0;
+    int rc;
+
+    if (0 == filter.count(leaves))
+        return SR_ERR_OK;
+
+    auto dump = std::make_shared<nat44_user_dump>();
+    if (!nat_hw_read(dump))
+        return SR_ERR_OPERATION_FAILED;
+
+    for (auto &u : *dump) {
+        const auto &user = u.get_payload();
+
+        users++;
+        sessions += user.nsessions + user.nstaticsessions;
+    }
+
+    rc = sr_new_values(filter.count(leaves), val);
+    if (0 != rc)
+        return SR_ERR_NOMEM;
+
+    if (filter.wants("users")) {
+        sr_val_build_xpath(&(*val)[cnt], "%s/users", xpath);
+        nat_val_set_uint(&(*val)[cnt], SR_UINT32_T, users);
+        cnt++;
+    }
+    if (filter.wants("sessions")) {
+        sr_val_build_xpath(&(*val)[cnt], "%s/sessions", xpath);
+        nat_val_set_uint(&(*val)[cnt], SR_UINT64_T, sessions);
+        cnt++;
+    }
+
+    return SR_ERR_OK;
+}
+
+/*
+ * /ietf-nat:nat/instances/instance/sweetcomb-nat:nat-state
+ * Called for the container, then for each of its lists.
+ */
+static int
+nat_state_cb(const char *xpath, sr_val_t **values, size_t *values_cnt,
+             uint64_t request_id, const char *original_xpath,
+             void *private_ctx)
+{
+    UNUSED(request_id); UNUSED(private_ctx);
+    sr_val_t *val = nullptr;
+    size_t cnt = 0;
+    int rc = SR_ERR_OK;
+
+    SRP_LOG_INF("In %s", __FUNCTION__);
+
+    ARG_CHECK3(SR_ERR_INVAL_ARG, xpath, values, values_cnt);
+
+    if (sr_xpath_node_name_eq(xpath, "session"))
+        rc = nat_sessions_get(xpath, original_xpath, &val, cnt);
+    else if (sr_xpath_node_name_eq(xpath, "static-mapping"))
+        rc = nat_mappings_get(xpath, original_xpath, &val, cnt);
+    else if (sr_xpath_node_name_eq(xpath, "nat-state"))
+        rc = nat_counters_get(xpath, original_xpath, &val, cnt);
+
+    if (SR_ERR_OK != rc || 0 == cnt) {
+        sr_free_values(val, cnt);
+        val = nullptr;
+        cnt = 0;
+    }
+
+    *values = val;
+    *values_cnt = cnt;
+
+    return rc;
+}
+
 int
 ietf_nat_init(sc_plugin_main_t *pm)
 {
     int rc = SR_ERR_OK;
     SRP_LOG_DBG_MSG("Initializing ietf-nat plugin.");
 
-    rc = sr_subtree_change_subscribe(pm->session, "/ietf-nat:nat/instances/instance",
+    rc = sc_subtree_change_subscribe(pm->session, "/ietf-nat:nat/instances/instance",
             nat_instance_config_cb, NULL, 1, SR_SUBSCR_CTX_REUSE, &pm->subscription);
     if (rc != SR_ERR_OK) {
         goto error;
     }
 
-    rc = sr_subtree_change_subscribe(pm->session, "/ietf-nat:nat/instances/instance/mapping-table/mapping-entry",
+    rc = sc_subtree_change_subscribe(pm->session, MAPPING_ENTRY,
             nat_mapping_table_config_cb, NULL, 10, SR_SUBSCR_CTX_REUSE, &pm->subscription);
     if (rc != SR_ERR_OK) {
         goto error;
     }
 
-    rc = sr_dp_get_items_subscribe(pm->session, "/ietf-nat:nat/instances/instance/capabilities",
+    rc = sc_dp_get_items_subscribe(pm->session, "/ietf-nat:nat/instances/instance/capabilities",
                                    nat_cap_state_cb, NULL, SR_SUBSCR_CTX_REUSE, &pm->subscription);
     if (SR_ERR_OK != rc) {
         goto error;
     }
 
+    rc = sc_dp_get_items_subscribe(pm->session, "/ietf-nat:nat/instances/instance/sweetcomb-nat:nat-state",
+                                   nat_state_cb, NULL, SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
     SRP_LOG_DBG_MSG("ietf-nat plugin initialized successfully.");
     return SR_ERR_OK;
 
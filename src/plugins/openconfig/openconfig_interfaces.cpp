@@ -20,133 +20,106 @@
 #include <vom/interface.hpp>
 #include <vom/om.hpp>
 
-#include <vpp-oper/interface.hpp>
+#include <vpp-oper/interface_cache.hpp>
 
+#include <sc_interfaces.h>
+#include <sc_latency.h>
 #include <sc_plugins.h>
+#include <sc_request.h>
+#include <sc_running.h>
+#include <sc_transaction.h>
+
+/* Leaves of an interface config handled by oc_interfaces_config_cb */
+enum config_leaf_t {
+    CONFIG_NAME,
+    CONFIG_TYPE,
+    CONFIG_ENABLED,
+};
 
-using VOM::interface;
-using VOM::OM;
-using VOM::HW;
-using VOM::rc_t;
-
-using type_t = VOM::interface::type_t;
-using admin_state_t = VOM::interface::admin_state_t;
-
-class interface_builder {
-    public:
-        interface_builder() {}
-
-        shared_ptr<VOM::interface> build() {
-            if (m_name.empty() || m_type.empty())
-                return nullptr;
-            return make_shared<interface>(m_name, type_t::from_string(m_type),
-                                          admin_state_t::from_int(m_state));
-        }
-
-        /* Getters */
-        string name() {
-            return m_name;
-        }
-
-        /* Setters */
-        interface_builder& set_name(string n) {
-            m_name = n;
-            return *this;
-        }
-
-        interface_builder& set_type(string t) {
-            if (t == "iana-if-type:ethernetCsmacd")
-                m_type = "ETHERNET";
-            return *this;
-        }
-
-        interface_builder& set_state(bool enable) {
-            m_state = enable;
-            return *this;
-        }
-
-        std::string to_string() {
-            std::ostringstream os;
-            os << m_name << "," << m_type << "," << m_state;
-            return os.str();
-        }
+#define OC_CONFIG "/openconfig-interfaces:interfaces/interface/config"
 
-    private:
-        string m_name;
-        string m_type;
-        bool m_state;
+static const utils::schema_dispatch config_leaves = {
+    { OC_CONFIG "/name", CONFIG_NAME },
+    { OC_CONFIG "/type", CONFIG_TYPE },
+    { OC_CONFIG "/enabled", CONFIG_ENABLED },
 };
 
-
 // XPATH: /openconfig-interfaces:interfaces/interface[name='%s']/config/
 static int
 oc_interfaces_config_cb(sr_session_ctx_t *ds, const char *xpath,
                         sr_notif_event_t event, void *private_ctx)
 {
     UNUSED(private_ctx);
-    interface_builder builder;
-    shared_ptr<VOM::interface> intf;
+    std::shared_ptr<sc_transaction> tx = sc_transaction::of(ds);
+    sc_interfaces::changes changes(*tx);
+    utils::xpath_keys keys;
     string intf_name;
-    sr_change_iter_t *it = nullptr;
-    sr_xpath_ctx_t state;
+    int leaf;
+    sc_change_iter_t *it = nullptr;
     sr_val_t *ol = nullptr;
     sr_val_t *ne = nullptr;
     sr_change_oper_t oper;
-    bool create, remove, modify;
     int rc;
 
     SRP_LOG_INF("In %s", __FUNCTION__);
 
     ARG_CHECK2(SR_ERR_INVAL_ARG, ds, xpath);
 
+    /* changes of the whole commit are pushed to VPP at once on apply */
+    if (event == SR_EV_APPLY)
+        return tx->commit();
+
+    if (event == SR_EV_ABORT) {
+        tx->abort();
+        return SR_ERR_OK;
+    }
+
     if (event != SR_EV_VERIFY)
         return SR_ERR_OK;
 
-    if (sr_get_changes_iter(ds, (char *)xpath, &it) != SR_ERR_OK) {
-        sr_free_change_iter(it);
+    if (sc_get_changes_iter(ds, (char *)xpath, &it) != SR_ERR_OK) {
+        sc_free_change_iter(it);
         return SR_ERR_OK;
     }
 
     foreach_change (ds, it, oper, ol, ne) {
 
-        intf_name = sr_xpath_key_value(ne->xpath, "interface", "name", &state);
+        leaf = config_leaves.match(ne ? ne->xpath : ol->xpath, keys);
+        intf_name = keys.value(0);
         if (intf_name.empty()) {
-            sr_set_error(ds, "XPATH interface name NOT found", ne->xpath);
-            return SR_ERR_INVAL_ARG;
+            sr_set_error(ds, "XPATH interface name NOT found",
+                         ne ? ne->xpath : ol->xpath);
+            rc = SR_ERR_INVAL_ARG;
+            goto nothing_todo;
         }
-        sr_xpath_recover(&state);
 
         switch (oper) {
             case SR_OP_CREATED:
-                if (sr_xpath_node_name_eq(ne->xpath, "name")) {
-                    builder.set_name(ne->data.string_val);
-                    create = true;
-                } else if(sr_xpath_node_name_eq(ne->xpath, "type")) {
-                    builder.set_type(ne->data.string_val);
-                } else if(sr_xpath_node_name_eq(ne->xpath, "enabled")) {
-                    builder.set_state(ne->data.bool_val);
+                switch (leaf) {
+                    case CONFIG_NAME:
+                        changes.create(intf_name).set_name(ne->data.string_val);
+                        break;
+                    case CONFIG_TYPE:
+                        changes.create(intf_name).set_type(ne->data.string_val);
+                        break;
+                    case CONFIG_ENABLED:
+                        changes.create(intf_name).set_enabled(
+                            ne->data.bool_val);
+                        break;
                 }
                 break;
 
             case SR_OP_MODIFIED:
-                if (sr_xpath_node_name_eq(ne->xpath, "enabled")) {
-                    string n = sr_xpath_key_value(ne->xpath, "interface",
-                                                  "name", &state);
-                    intf = interface::find(n);
-                    if (!intf) {
-                        rc = SR_ERR_OPERATION_FAILED;
+                if (CONFIG_ENABLED == leaf) {
+                    rc = changes.enable(intf_name, ne->data.bool_val);
+                    if (SR_ERR_OK != rc)
                         goto nothing_todo;
-                    }
-                    intf->set(admin_state_t::from_int(ne->data.bool_val));
-                    modify = true;
                 }
                 break;
 
             case SR_OP_DELETED:
-                if (sr_xpath_node_name_eq(ol->xpath, "name")) {
-                    builder.set_name(ol->data.string_val);
-                    remove = true;
-                }
+                if (CONFIG_NAME == leaf)
+                    changes.remove(ol->data.string_val);
                 break;
 
             default:
@@ -154,58 +127,46 @@ oc_interfaces_config_cb(sr_session_ctx_t *ds, const char *xpath,
                 goto nothing_todo;
         }
 
-        sr_xpath_recover(&state);
-
         sr_free_val(ol);
         sr_free_val(ne);
     }
 
-    if (create) {
-        SRP_LOG_INF("creating interface '%s'", builder.name().c_str());
-        intf = builder.build();
-        if (nullptr == intf) {
-            SRP_LOG_ERR_MSG("Interface does not exist");
-            rc = SR_ERR_INVAL_ARG;
-            goto nothing_todo;
-        }
-    }
+    sc_free_change_iter(it);
 
-    if (create || modify) {
-        if ( OM::write(intf->key(), *intf) != rc_t::OK ) {
-            SRP_LOG_ERR("Fail writing changes to VPP for: %s",
-                        builder.to_string().c_str());
-            rc = SR_ERR_OPERATION_FAILED;
-            goto nothing_todo;
-        }
-    } else if (remove) {
-        SRP_LOG_INF("deleting interface '%s'", builder.name().c_str());
-        OM::remove(builder.name());
-    }
+    rc = changes.stage();
+    if (rc != SR_ERR_OK)
+        tx->abort();
 
-    sr_free_change_iter(it);
-    return SR_ERR_OK;
+    return rc;
 
 nothing_todo:
     sr_free_val(ol);
     sr_free_val(ne);
-    sr_free_change_iter(it);
+    sc_free_change_iter(it);
+    tx->abort();
     return rc;
 }
 
+/* Leaves replied by oc_interfaces_state_cb for each interface */
+static const vector<string> state_leaves = {
+    "name", "type", "mtu", "enabled", "ifindex", "admin-status", "oper-status"
+};
+
 //XPATH : /openconfig-interfaces:interfaces/interface/state
 static int
 oc_interfaces_state_cb(const char *xpath, sr_val_t **values, size_t *values_cnt,
                        uint64_t request_id, const char *original_xpath,
                        void *private_ctx)
 {
-    UNUSED(request_id); UNUSED(original_xpath); UNUSED(private_ctx);
-    vapi_payload_sw_interface_details reply;
-    shared_ptr<interface_dump> dump;
+    UNUSED(private_ctx);
+    utils::xpath_filter filter(original_xpath, "state", state_leaves);
+    shared_ptr<const sc_request> snapshot;
+    const interface_cache::details_t *reply;
+    static thread_local utils::xpath_builder path;
     string intf_name;
     sr_val_t *vals = nullptr;
     sr_xpath_ctx_t state;
-    char xpath_root[XPATH_SIZE];
-    int vc = 7;
+    int vc = filter.count(state_leaves);
     int cnt = 0;
     int rc;
 
@@ -220,55 +181,374 @@ oc_interfaces_state_cb(const char *xpath, sr_val_t **values, size_t *values_cnt,
     }
     sr_xpath_recover(&state);
 
-    snprintf(xpath_root, XPATH_SIZE,
-             "/openconfig-interfaces:interfaces/interface[name='%s']/state",
-             intf_name.c_str());
+    /* the interfaces are read once for all the calls of the request */
+    snapshot = sc_request::get(request_id);
+    reply = snapshot->find(intf_name);
+    if (!reply) {
+        SRP_LOG_WRN("interface %s not found in VPP", intf_name.c_str());
+        *values = nullptr;
+        *values_cnt = 0;
+        return SR_ERR_OK;
+    }
 
     rc = sr_new_values(vc, &vals);
     if (SR_ERR_OK != rc)
         return rc;
 
-    dump = make_shared<interface_dump>(intf_name); //dump only specific intf
-    HW::enqueue(dump);
-    HW::write();
+    sc_interfaces::state st(*reply);
+    path.entry(xpath);
 
-    reply = dump->begin()->get_payload();
-
-    sr_val_build_xpath(&vals[cnt], "%s/name", xpath_root);
-    sr_val_set_str_data(&vals[cnt], SR_STRING_T, (char *)reply.interface_name);
-    cnt++;
+    if (filter.wants("name")) {
+        path.set(&vals[cnt], "name");
+        sr_val_set_str_data(&vals[cnt], SR_STRING_T, st.name());
+        cnt++;
+    }
 
     //TODO revisit types after V3PO has been implemented
-    sr_val_build_xpath(&vals[cnt], "%s/type", xpath_root);
-    sr_val_set_str_data(&vals[cnt], SR_IDENTITYREF_T, "ianaift:ethernetCsmacd");
-    cnt++;
-
-    sr_val_build_xpath(&vals[cnt], "%s/mtu", xpath_root);
-    vals[cnt].type = SR_UINT16_T;
-    vals[cnt].data.uint16_val = reply.link_mtu;
-    cnt++;
-
-    sr_val_build_xpath(&vals[cnt], "%s/enabled", xpath_root);
-    vals[cnt].type = SR_BOOL_T;
-    vals[cnt].data.bool_val = reply.flags;
-    cnt++;
-
-    sr_val_build_xpath(&vals[cnt], "%s/ifindex", xpath_root);
-    vals[cnt].type = SR_UINT32_T;
-    vals[cnt].data.uint32_val = reply.sw_if_index;
-    cnt++;
-
-    sr_val_build_xpath(&vals[cnt], "%s/admin-status", xpath_root);
-    sr_val_set_str_data(&vals[cnt], SR_ENUM_T,
-                        (reply.flags == vapi_enum_if_status_flags::IF_STATUS_API_FLAG_ADMIN_UP) ?
-                        "UP" : "DOWN");
-    cnt++;
-
-    sr_val_build_xpath(&vals[cnt], "%s/oper-status", xpath_root);
-    sr_val_set_str_data(&vals[cnt], SR_ENUM_T,
-                        (reply.flags == vapi_enum_if_status_flags::IF_STATUS_API_FLAG_LINK_UP) ?
-                        "UP" : "DOWN");
-    cnt++;
+    if (filter.wants("type")) {
+        path.set(&vals[cnt], "type");
+        sr_val_set_str_data(&vals[cnt], SR_IDENTITYREF_T, "ianaift:ethernetCsmacd");
+        cnt++;
+    }
+
+    if (filter.wants("mtu")) {
+        path.set(&vals[cnt], "mtu");
+        vals[cnt].type = SR_UINT16_T;
+        vals[cnt].data.uint16_val = st.mtu();
+        cnt++;
+    }
+
+    if (filter.wants("enabled")) {
+        path.set(&vals[cnt], "enabled");
+        vals[cnt].type = SR_BOOL_T;
+        vals[cnt].data.bool_val = st.admin_up();
+        cnt++;
+    }
+
+    if (filter.wants("ifindex")) {
+        path.set(&vals[cnt], "ifindex");
+        vals[cnt].type = SR_UINT32_T;
+        vals[cnt].data.uint32_val = st.index();
+        cnt++;
+    }
+
+    if (filter.wants("admin-status")) {
+        path.set(&vals[cnt], "admin-status");
+        sr_val_set_str_data(&vals[cnt], SR_ENUM_T,
+                            st.admin_up() ? "UP" : "DOWN");
+        cnt++;
+    }
+
+    if (filter.wants("oper-status")) {
+        path.set(&vals[cnt], "oper-status");
+        sr_val_set_str_data(&vals[cnt], SR_ENUM_T,
+                            st.oper_up() ? "UP" : "DOWN");
+        cnt++;
+    }
+
+    *values = vals;
+    *values_cnt = cnt;
+
+    return SR_ERR_OK;
+}
+
+/* Leaves of the counters of an interface or a subinterface */
+static const vector<string> counter_leaves = {
+    "in-octets", "in-pkts", "in-unicast-pkts", "in-broadcast-pkts",
+    "in-multicast-pkts", "in-discards", "in-errors", "out-octets", "out-pkts",
+    "out-unicast-pkts", "out-broadcast-pkts", "out-multicast-pkts",
+    "out-errors"
+};
+
+/* Leaves replied by oc_subinterface_state_cb for each subinterface */
+static const vector<string> subif_state_leaves = {
+    "index", "name", "enabled", "ifindex", "admin-status", "oper-status"
+};
+
+/* State nodes below an interface, served by the callbacks below */
+enum state_node_t {
+    STATE_COUNTERS,
+    SUBIF_STATE,
+    SUBIF_COUNTERS,
+};
+
+#define OC_INTERFACE "/openconfig-interfaces:interfaces/interface"
+#define OC_SUBIF OC_INTERFACE "/subinterfaces/subinterface"
+
+static const utils::schema_dispatch state_nodes = {
+    { OC_INTERFACE "/state/counters", STATE_COUNTERS },
+    { OC_SUBIF "/state", SUBIF_STATE },
+    { OC_SUBIF "/state/counters", SUBIF_COUNTERS },
+};
+
+/* Reply the counters of stats requested by original_xpath, xpath being the
+ * counters container */
+static int
+oc_counters_build(const char *xpath, const char *original_xpath,
+                  const if_counters_t &stats, sr_val_t **values,
+                  size_t *values_cnt)
+{
+    utils::xpath_filter filter(original_xpath, "counters", counter_leaves);
+    static thread_local utils::xpath_builder path;
+    /* VPP has no tx discards apart from the tx errors */
+    const pair<const char *, uint64_t> counters[] = {
+        { "in-octets", stats.rx.bytes },
+        { "in-pkts", stats.rx.packets },
+        { "in-unicast-pkts", stats.rx_unicast.packets },
+        { "in-broadcast-pkts", stats.rx_broadcast.packets },
+        { "in-multicast-pkts", stats.rx_multicast.packets },
+        { "in-discards", stats.drops + stats.rx_no_buf + stats.rx_miss },
+        { "in-errors", stats.rx_error },
+        { "out-octets", stats.tx.bytes },
+        { "out-pkts", stats.tx.packets },
+        { "out-unicast-pkts", stats.tx_unicast.packets },
+        { "out-broadcast-pkts", stats.tx_broadcast.packets },
+        { "out-multicast-pkts", stats.tx_multicast.packets },
+        { "out-errors", stats.tx_error },
+    };
+    sr_val_t *vals = nullptr;
+    int cnt = 0;
+    int rc;
+
+    rc = sr_new_values(filter.count(counter_leaves), &vals);
+    if (SR_ERR_OK != rc)
+        return rc;
+
+    path.entry(xpath);
+    for (auto &counter : counters) {
+        if (!filter.wants(counter.first))
+            continue;
+
+        path.set(&vals[cnt], counter.first);
+        vals[cnt].type = SR_UINT64_T;
+        vals[cnt].data.uint64_val = counter.second;
+        cnt++;
+    }
+
+    *values = vals;
+    *values_cnt = cnt;
+
+    return SR_ERR_OK;
+}
+
+/* Interface of subinterface index of interface: the interface itself for
+ * index 0, else its VPP sub-interface of that sub_id. Null if there is
+ * none. */
+static const interface_cache::details_t*
+oc_subinterface(const sc_request &snapshot, const string &name,
+                const string &index)
+{
+    const interface_cache::details_t *parent = snapshot.find(name);
+    char *end = nullptr;
+    unsigned long id;
+
+    if (!parent || index.empty())
+        return nullptr;
+
+    id = strtoul(index.c_str(), &end, 10);
+    if (*end != '\0')
+        return nullptr;
+    if (id == 0)
+        return parent;
+
+    for (auto sub : snapshot.subinterfaces(parent->sw_if_index)) {
+        if (sub->sub_id == id)
+            return sub;
+    }
+
+    return nullptr;
+}
+
+/* The counters of all interfaces are read at once from the stats segment,
+ * for all the calls of the request */
+//XPATH : /openconfig-interfaces:interfaces/interface/state/counters
+static int
+oc_interfaces_counters_cb(const char *xpath, sr_val_t **values,
+                          size_t *values_cnt, uint64_t request_id,
+                          const char *original_xpath, void *private_ctx)
+{
+    UNUSED(private_ctx);
+    shared_ptr<const sc_request> snapshot;
+    const interface_cache::details_t *details;
+    const if_counters_t *stats;
+    utils::xpath_keys keys;
+    string intf_name;
+
+    SRP_LOG_INF("In %s", __FUNCTION__);
+
+    ARG_CHECK3(SR_ERR_INVAL_ARG, xpath, values, values_cnt);
+    *values = nullptr;
+    *values_cnt = 0;
+
+    if (state_nodes.match(xpath, keys) != STATE_COUNTERS)
+        return SR_ERR_OK;
+
+    intf_name = keys.value("name");
+    if (intf_name.empty()) {
+        SRP_LOG_ERR_MSG("XPATH interface name not found");
+        return SR_ERR_INVAL_ARG;
+    }
+
+    snapshot = sc_request::get(request_id);
+    details = snapshot->find(intf_name);
+    if (!details) {
+        SRP_LOG_WRN("interface %s not found in VPP", intf_name.c_str());
+        return SR_ERR_OK;
+    }
+
+    stats = snapshot->counters(details->sw_if_index);
+    if (!stats) {
+        SRP_LOG_WRN("no counters for interface %s", intf_name.c_str());
+        return SR_ERR_OK;
+    }
+
+    return oc_counters_build(xpath, original_xpath, *stats, values,
+                             values_cnt);
+}
+
+/* Counters of a configured subinterface, read as the ones of the
+ * interfaces */
+//XPATH : /openconfig-interfaces:interfaces/interface/subinterfaces/subinterface/state/counters
+static int
+oc_subinterface_counters_cb(const char *xpath, sr_val_t **values,
+                            size_t *values_cnt, uint64_t request_id,
+                            const char *original_xpath, void *private_ctx)
+{
+    UNUSED(private_ctx);
+    shared_ptr<const sc_request> snapshot;
+    const interface_cache::details_t *details;
+    const if_counters_t *stats;
+    utils::xpath_keys keys;
+    string intf_name, index;
+
+    SRP_LOG_INF("In %s", __FUNCTION__);
+
+    ARG_CHECK3(SR_ERR_INVAL_ARG, xpath, values, values_cnt);
+    *values = nullptr;
+    *values_cnt = 0;
+
+    if (state_nodes.match(xpath, keys) != SUBIF_COUNTERS)
+        return SR_ERR_OK;
+
+    intf_name = keys.value("name");
+    if (intf_name.empty()) {
+        SRP_LOG_ERR_MSG("XPATH interface name not found");
+        return SR_ERR_INVAL_ARG;
+    }
+
+    snapshot = sc_request::get(request_id);
+    index = keys.value("index");
+    details = oc_subinterface(*snapshot, intf_name, index);
+    if (!details) {
+        SRP_LOG_WRN("subinterface %s of %s not found in VPP", index.c_str(),
+                    intf_name.c_str());
+        return SR_ERR_OK;
+    }
+
+    stats = snapshot->counters(details->sw_if_index);
+    if (!stats) {
+        SRP_LOG_WRN("no counters for subinterface %s of %s", index.c_str(),
+                    intf_name.c_str());
+        return SR_ERR_OK;
+    }
+
+    return oc_counters_build(xpath, original_xpath, *stats, values,
+                             values_cnt);
+}
+
+/* State of a configured subinterface: subinterface 0 is the interface
+ * itself, the next ones its VPP sub-interfaces, indexed by sub_id. The
+ * subinterface instances are config data, sysrepo asks for the state of
+ * the ones configured. */
+//XPATH : /openconfig-interfaces:interfaces/interface/subinterfaces/subinterface/state
+static int
+oc_subinterface_state_cb(const char *xpath, sr_val_t **values,
+                         size_t *values_cnt, uint64_t request_id,
+                         const char *original_xpath, void *private_ctx)
+{
+    UNUSED(private_ctx);
+    static thread_local utils::xpath_builder path;
+    shared_ptr<const sc_request> snapshot;
+    const interface_cache::details_t *details;
+    utils::xpath_keys keys;
+    string intf_name, index;
+    sr_val_t *vals = nullptr;
+    int cnt = 0;
+    int rc;
+
+    SRP_LOG_INF("In %s", __FUNCTION__);
+
+    ARG_CHECK3(SR_ERR_INVAL_ARG, xpath, values, values_cnt);
+    *values = nullptr;
+    *values_cnt = 0;
+
+    if (state_nodes.match(xpath, keys) != SUBIF_STATE)
+        return SR_ERR_OK;
+
+    intf_name = keys.value("name");
+    if (intf_name.empty()) {
+        SRP_LOG_ERR_MSG("XPATH interface name not found");
+        return SR_ERR_INVAL_ARG;
+    }
+
+    snapshot = sc_request::get(request_id);
+    index = keys.value("index");
+    details = oc_subinterface(*snapshot, intf_name, index);
+    if (!details) {
+        SRP_LOG_WRN("subinterface %s of %s not found in VPP", index.c_str(),
+                    intf_name.c_str());
+        return SR_ERR_OK;
+    }
+
+    utils::xpath_filter filter(original_xpath, "state", subif_state_leaves);
+    sc_interfaces::state st(*details);
+
+    rc = sr_new_values(filter.count(subif_state_leaves), &vals);
+    if (SR_ERR_OK != rc)
+        return rc;
+
+    path.entry(xpath);
+
+    if (filter.wants("index")) {
+        path.set(&vals[cnt], "index");
+        vals[cnt].type = SR_UINT32_T;
+        vals[cnt].data.uint32_val = strtoul(index.c_str(), nullptr, 10);
+        cnt++;
+    }
+
+    if (filter.wants("name")) {
+        path.set(&vals[cnt], "name");
+        sr_val_set_str_data(&vals[cnt], SR_STRING_T, st.name());
+        cnt++;
+    }
+
+    if (filter.wants("enabled")) {
+        path.set(&vals[cnt], "enabled");
+        vals[cnt].type = SR_BOOL_T;
+        vals[cnt].data.bool_val = st.admin_up();
+        cnt++;
+    }
+
+    if (filter.wants("ifindex")) {
+        path.set(&vals[cnt], "ifindex");
+        vals[cnt].type = SR_UINT32_T;
+        vals[cnt].data.uint32_val = st.index();
+        cnt++;
+    }
+
+    if (filter.wants("admin-status")) {
+        path.set(&vals[cnt], "admin-status");
+        sr_val_set_str_data(&vals[cnt], SR_ENUM_T,
+                            st.admin_up() ? "UP" : "DOWN");
+        cnt++;
+    }
+
+    if (filter.wants("oper-status")) {
+        path.set(&vals[cnt], "oper-status");
+        sr_val_set_str_data(&vals[cnt], SR_ENUM_T,
+                            st.oper_up() ? "UP" : "DOWN");
+        cnt++;
+    }
 
     *values = vals;
     *values_cnt = cnt;
@@ -282,18 +562,36 @@ openconfig_interface_init(sc_plugin_main_t *pm)
     int rc = SR_ERR_OK;
     SRP_LOG_DBG_MSG("Initializing openconfig-interfaces plugin.");
 
-    rc = sr_subtree_change_subscribe(pm->session, "/openconfig-interfaces:interfaces/interface/config",
+    rc = sc_subtree_change_subscribe(pm->session, OC_CONFIG,
             oc_interfaces_config_cb, nullptr, 98, SR_SUBSCR_CTX_REUSE, &pm->subscription);
     if (SR_ERR_OK != rc) {
         goto error;
     }
 
-    rc = sr_dp_get_items_subscribe(pm->session, "/openconfig-interfaces:interfaces/interface/state",
+    rc = sc_dp_get_items_subscribe(pm->session, "/openconfig-interfaces:interfaces/interface/state",
             oc_interfaces_state_cb, nullptr, SR_SUBSCR_CTX_REUSE, &pm->subscription);
     if (SR_ERR_OK != rc) {
         goto error;
     }
 
+    rc = sc_dp_get_items_subscribe(pm->session, OC_INTERFACE "/state/counters",
+            oc_interfaces_counters_cb, nullptr, SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    rc = sc_dp_get_items_subscribe(pm->session, OC_SUBIF "/state",
+            oc_subinterface_state_cb, nullptr, SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    rc = sc_dp_get_items_subscribe(pm->session, OC_SUBIF "/state/counters",
+            oc_subinterface_counters_cb, nullptr, SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
     SRP_LOG_DBG_MSG("openconfig-interfaces plugin initialized successfully.");
     return SR_ERR_OK;
 
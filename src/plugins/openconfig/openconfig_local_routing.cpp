@@ -0,0 +1,742 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * Static routes:
+ * ==============
+ * Static routes are routes of the VPP default table. A next-hop is:
+ *  -an address, through the interface of its interface-ref if it has one,
+ *   looked up recursively otherwise,
+ *  -DROP, whatever its interface-ref,
+ *  -LOCAL_LINK or no next-hop, the prefix is then attached to the interface
+ *   of its interface-ref, which is mandatory.
+ * The metric of a next-hop is the VPP path preference, lower is preferred,
+ * capped at 255. set-tag and recurse are accepted and not programmed.
+ *
+ * VPP programming
+ * ===============
+ * -Routes are indexed in memory by prefix: a change of a leaf is applied
+ *  to the route as it is, and the route is added again with all its
+ *  next-hops, which replaces the paths VPP has for it. A commit costs one
+ *  request per route changed, however many of its leaves changed.
+ * -Routes of a commit are programmed with pipelined requests rather than
+ *  one VOM object each, so that large tables load fast.
+ * -VPP keys a route by prefix with its host bits cleared: a prefix that
+ *  only differs from another one by its host bits is rejected on verify.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <vom/hw.hpp>
+#include <vom/interface.hpp>
+#include <vom/route.hpp>
+#include <vom/route_domain.hpp>
+#include <vpp-oper/ip.hpp>
+
+#include <sc_latency.h>
+#include <sc_plugins.h>
+#include <sc_running.h>
+#include <sc_transaction.h>
+
+using VOM::HW;
+using VOM::rc_t;
+
+/* A next-hop of a static route, as configured */
+struct oc_next_hop_t {
+    enum type_t {
+        NH_NONE,
+        NH_ADDRESS,
+        NH_DROP,
+        NH_LOCAL_LINK,
+    };
+
+    type_t type = NH_NONE;
+    boost::asio::ip::address address;
+    std::string interface;
+    bool has_subinterface = false;
+    uint32_t subinterface = 0;
+    bool has_metric = false;
+    uint32_t metric = 0;
+
+    /* VPP name of the interface, empty if there is none */
+    std::string vpp_interface() const
+    {
+        if (interface.empty() || !has_subinterface || 0 == subinterface)
+            return interface;
+
+        return interface + "." + std::to_string(subinterface);
+    }
+};
+
+/* A static route as configured: its list key and its next-hops by index */
+struct oc_static_route_t {
+    std::string key;
+    std::map<std::string, oc_next_hop_t> next_hops;
+};
+
+typedef std::vector<utils::prefix> oc_route_dels_t;
+typedef std::vector<std::pair<utils::prefix, oc_static_route_t>>
+    oc_route_adds_t;
+
+static VOM::route::prefix_t
+oc_vom_prefix(const utils::prefix &pfx)
+{
+    return VOM::route::prefix_t(pfx.address(), pfx.prefix_length());
+}
+
+/* Interfaces by VPP name, looked up in VOM once for many routes */
+typedef std::unordered_map<std::string, std::shared_ptr<VOM::interface>>
+    oc_interfaces_t;
+
+/* Paths of route to pfx, false if an interface they go through is not
+ * known to VOM */
+static bool
+oc_route_paths(const utils::prefix &pfx, const oc_static_route_t &route,
+               oc_interfaces_t &itfs, VOM::route::path_list_t &paths)
+{
+    const VOM::nh_proto_t &proto = (AF_INET6 == pfx.family()
+                                    ? VOM::nh_proto_t::IPV6
+                                    : VOM::nh_proto_t::IPV4);
+    const VOM::route_domain rd(VOM::route::DEFAULT_TABLE);
+
+    paths.clear();
+    for (auto &it : route.next_hops) {
+        const oc_next_hop_t &nh = it.second;
+        uint8_t preference = std::min<uint32_t>(nh.metric, UINT8_MAX);
+        std::shared_ptr<VOM::interface> itf;
+
+        if (oc_next_hop_t::NH_DROP == nh.type) {
+            paths.insert(VOM::route::path(
+                VOM::route::path::special_t::DROP, proto));
+            continue;
+        }
+
+        if (!nh.interface.empty()) {
+            std::string name = nh.vpp_interface();
+            auto found = itfs.find(name);
+
+            if (found == itfs.end())
+                found = itfs.emplace(name, VOM::interface::find(name)).first;
+            itf = found->second;
+            if (!itf)
+                return false;
+        }
+
+        if (oc_next_hop_t::NH_ADDRESS == nh.type && itf)
+            paths.insert(VOM::route::path(nh.address, *itf, 1, preference));
+        else if (oc_next_hop_t::NH_ADDRESS == nh.type)
+            paths.insert(VOM::route::path(rd, nh.address, 1, preference));
+        else if (itf)
+            paths.insert(VOM::route::path(*itf, proto, 1, preference));
+    }
+
+    return true;
+}
+
+/*
+ * Static routes pushed to VPP, by prefix with its host bits cleared.
+ */
+class oc_route_table {
+public:
+    /* Route to pfx, false if none */
+    bool get(const utils::prefix &pfx, oc_static_route_t &route)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        auto it = m_routes.find(pfx);
+        if (it == m_routes.end())
+            return false;
+        route = it->second;
+
+        return true;
+    }
+
+    /* List key of the route to pfx, false if none */
+    bool key(const utils::prefix &pfx, std::string &key)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        auto it = m_routes.find(pfx);
+        if (it == m_routes.end())
+            return false;
+        key = it->second.key;
+
+        return true;
+    }
+
+    void set(const utils::prefix &pfx, const oc_static_route_t &route)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        m_routes[pfx] = route;
+    }
+
+    void remove(const utils::prefix &pfx)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        m_routes.erase(pfx);
+    }
+
+    /* Declare all the routes to a reconcile */
+    void describe(reconcile &r)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        VOM::route::path_list_t paths;
+        oc_interfaces_t itfs;
+
+        for (auto &it : m_routes) {
+            if (oc_route_paths(it.first, it.second, itfs, paths))
+                r.route(oc_vom_prefix(it.first), paths);
+        }
+    }
+
+private:
+    std::mutex m_lock;
+    std::unordered_map<utils::prefix, oc_static_route_t> m_routes;
+};
+
+static oc_route_table route_table;
+
+/* Set nh from the value of a next-hop leaf, false if it is not valid */
+static bool
+oc_next_hop_parse(const char *value, oc_next_hop_t &nh)
+{
+    const char *id = strchr(value, ':');
+    boost::system::error_code ec;
+
+    /* identities are prefixed by their module */
+    id = id ? id + 1 : value;
+    if (0 == strcmp(id, "DROP")) {
+        nh.type = oc_next_hop_t::NH_DROP;
+        return true;
+    }
+    if (0 == strcmp(id, "LOCAL_LINK")) {
+        nh.type = oc_next_hop_t::NH_LOCAL_LINK;
+        return true;
+    }
+
+    nh.address = boost::asio::ip::address::from_string(value, ec);
+    nh.type = oc_next_hop_t::NH_ADDRESS;
+
+    return !ec;
+}
+
+/* Return why next-hop nh of the route to pfx can not be programmed, null
+ * if it can. known holds the interfaces checked by the commit already. */
+static const char *
+oc_next_hop_check(sc_transaction &tx, std::unordered_set<std::string> &known,
+                  const utils::prefix &pfx, const oc_next_hop_t &nh)
+{
+    if (oc_next_hop_t::NH_DROP == nh.type)
+        return nullptr;
+
+    if (oc_next_hop_t::NH_ADDRESS == nh.type &&
+        nh.address.is_v6() != (AF_INET6 == pfx.family()))
+        return "next-hop of another address family";
+
+    if (nh.interface.empty()) {
+        if (oc_next_hop_t::NH_ADDRESS != nh.type)
+            return "no next-hop address nor interface";
+        return nullptr;
+    }
+
+    std::string name = nh.vpp_interface();
+    if (known.count(name))
+        return nullptr;
+    if (!tx.find_interface(name))
+        return "unknown interface";
+
+    /* programmed once the commits creating the interface are */
+    tx.depends(name);
+    known.insert(name);
+
+    return nullptr;
+}
+
+/* Delete then add the routes with one batch of requests each */
+static rc_t
+oc_routes_program(const oc_route_dels_t &dels, const oc_route_adds_t &adds)
+{
+    route_batch del(false);
+    route_batch add(true);
+    VOM::route::path_list_t paths;
+    oc_interfaces_t itfs;
+    size_t unresolved = 0;
+
+    for (auto &d : dels)
+        del.add(oc_vom_prefix(d), paths);
+    for (auto &a : adds) {
+        if (!oc_route_paths(a.first, a.second, itfs, paths)) {
+            unresolved++;
+            continue;
+        }
+        add.add(oc_vom_prefix(a.first), paths);
+    }
+
+    del.enqueue();
+    add.enqueue();
+    HW::write();
+
+    if (unresolved || del.failed() || add.failed()) {
+        SRP_LOG_ERR("Fail programming static routes: %zu of %zu removals, "
+                    "%zu of %zu additions, %zu without interface",
+                    del.failed(), del.size(), add.failed(), add.size(),
+                    unresolved);
+        return rc_t::INVALID;
+    }
+
+    return rc_t::OK;
+}
+
+/* Leaves of a static route handled by oc_static_routes_config_cb */
+enum static_leaf_t {
+    STATIC_PREFIX,
+    NH_INDEX,
+    NH_NEXT_HOP,
+    NH_METRIC,
+    NH_INTERFACE,
+    NH_SUBINTERFACE,
+};
+
+#define OC_STATIC \
+    "/openconfig-local-routing:local-routes/static-routes/static"
+#define OC_NEXT_HOP OC_STATIC "/next-hops/next-hop"
+
+static const utils::schema_dispatch static_leaves = {
+    { OC_STATIC "/prefix", STATIC_PREFIX },
+    { OC_NEXT_HOP "/index", NH_INDEX },
+    { OC_NEXT_HOP "/config/next-hop", NH_NEXT_HOP },
+    { OC_NEXT_HOP "/config/metric", NH_METRIC },
+    { OC_NEXT_HOP "/interface-ref/config/interface", NH_INTERFACE },
+    { OC_NEXT_HOP "/interface-ref/config/subinterface", NH_SUBINTERFACE },
+};
+
+/* A route changed by a commit, from the route as it was */
+struct oc_route_edit_t {
+    utils::prefix network;
+    bool existed;
+    oc_static_route_t route;
+};
+
+/* Apply a change of a next-hop leaf to nh, false if its value is not
+ * valid */
+static bool
+oc_next_hop_change(int leaf, const sr_val_t *val, oc_next_hop_t &nh)
+{
+    switch (leaf) {
+    case NH_NEXT_HOP:
+        if (!val) {
+            nh.type = oc_next_hop_t::NH_NONE;
+            return true;
+        }
+        return oc_next_hop_parse(val->data.string_val, nh);
+    case NH_METRIC:
+        nh.has_metric = (val != nullptr);
+        nh.metric = val ? val->data.uint32_val : 0;
+        break;
+    case NH_INTERFACE:
+        nh.interface = val ? val->data.string_val : "";
+        break;
+    case NH_SUBINTERFACE:
+        nh.has_subinterface = (val != nullptr);
+        nh.subinterface = val ? val->data.uint32_val : 0;
+        break;
+    }
+
+    return true;
+}
+
+/*
+ * Return true if a route added has the network of another one, whether
+ * already pushed to VPP and kept by this commit or added by this commit
+ * too.
+ */
+static bool
+oc_route_conflict(const oc_route_dels_t &dels, const oc_route_adds_t &adds)
+{
+    std::unordered_set<utils::prefix> added, deleted(dels.begin(), dels.end());
+    std::string other;
+
+    added.reserve(adds.size());
+
+    for (auto &a : adds) {
+        if (route_table.key(a.first, other) && other != a.second.key &&
+            !deleted.count(a.first)) {
+            SRP_LOG_ERR("Route %s: prefix %s already routed by %s",
+                        a.second.key.c_str(), a.first.to_string().c_str(),
+                        other.c_str());
+            return true;
+        }
+        if (!added.insert(a.first).second) {
+            SRP_LOG_ERR("Route %s: prefix %s routed twice",
+                        a.second.key.c_str(), a.first.to_string().c_str());
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*
+ * /openconfig-local-routing:local-routes/static-routes/static[prefix='%s']/
+ */
+static int
+oc_static_routes_config_cb(sr_session_ctx_t *ds, const char *xpath,
+                           sr_notif_event_t event, void *private_ctx)
+{
+    UNUSED(private_ctx);
+    std::shared_ptr<sc_transaction> tx = sc_transaction::of(ds);
+    std::unordered_map<std::string, oc_route_edit_t> edits;
+    std::unordered_set<std::string> interfaces;
+    std::shared_ptr<oc_route_dels_t> dels = std::make_shared<oc_route_dels_t>();
+    std::shared_ptr<oc_route_adds_t> adds = std::make_shared<oc_route_adds_t>();
+    sr_val_t *ol = nullptr;
+    sr_val_t *ne = nullptr;
+    sc_change_iter_t *it = nullptr;
+    sr_change_oper_t oper;
+    utils::xpath_keys keys;
+    utils::prefix pfx;
+    std::string key, index;
+    int leaf;
+    int rc;
+
+    ARG_CHECK2(SR_ERR_INVAL_ARG, ds, xpath);
+
+    /* changes of the whole commit are pushed to VPP at once on apply */
+    if (event == SR_EV_APPLY)
+        return tx->commit();
+
+    if (event == SR_EV_ABORT) {
+        tx->abort();
+        return SR_ERR_OK;
+    }
+
+    if (event != SR_EV_VERIFY)
+        return SR_ERR_OK;
+
+    SRP_LOG_INF("In %s", __FUNCTION__);
+
+    rc = sc_get_changes_iter(ds, (char *)xpath, &it);
+    if (rc != SR_ERR_OK)
+        goto error;
+
+    foreach_change(ds, it, oper, ol, ne) {
+
+        /* prefix then next-hop index are the keys of the path */
+        leaf = static_leaves.match(ne ? ne->xpath : ol->xpath, keys);
+        key = keys.value(0);
+        if (leaf >= 0 && key.empty()) {
+            rc = SR_ERR_INVAL_ARG;
+            goto error;
+        }
+
+        /* the route as it is, on the first change of one of its leaves */
+        auto e = edits.find(key);
+        if (leaf >= 0 && e == edits.end()) {
+            if (!utils::prefix::parse(key.c_str(), pfx)) {
+                SRP_LOG_ERR("Invalid prefix %s", key.c_str());
+                rc = SR_ERR_INVAL_ARG;
+                goto error;
+            }
+            e = edits.emplace(key, oc_route_edit_t()).first;
+            e->second.network = pfx.network();
+            e->second.existed = route_table.get(e->second.network,
+                                                e->second.route) &&
+                                e->second.route.key == key;
+            if (!e->second.existed)
+                e->second.route = oc_static_route_t();
+            e->second.route.key = key;
+        }
+
+        index = keys.value(1);
+
+        switch (oper) {
+        case SR_OP_CREATED:
+        case SR_OP_MODIFIED:
+            if (leaf < 0 || STATIC_PREFIX == leaf)
+                break;
+            if (!oc_next_hop_change(
+                    leaf, ne, e->second.route.next_hops[index])) {
+                SRP_LOG_ERR("Route %s: invalid next-hop %s", key.c_str(),
+                            ne->data.string_val);
+                rc = SR_ERR_INVAL_ARG;
+                goto error;
+            }
+            break;
+
+        case SR_OP_DELETED:
+            if (STATIC_PREFIX == leaf) {
+                e->second.route.next_hops.clear();
+            } else if (NH_INDEX == leaf) {
+                e->second.route.next_hops.erase(index);
+            } else if (leaf >= 0) {
+                auto nh = e->second.route.next_hops.find(index);
+                if (nh != e->second.route.next_hops.end())
+                    oc_next_hop_change(leaf, nullptr, nh->second);
+            }
+            break;
+
+        default:
+            SRP_LOG_WRN_MSG("Operation not supported");
+            rc = SR_ERR_UNSUPPORTED;
+            goto error;
+        }
+
+        sr_free_val(ne);
+        sr_free_val(ol);
+    }
+
+    sc_free_change_iter(it);
+
+    /* a route without next-hop is not programmed */
+    for (auto &e : edits) {
+        oc_route_edit_t &edit = e.second;
+
+        if (edit.route.next_hops.empty()) {
+            if (edit.existed)
+                dels->push_back(edit.network);
+            continue;
+        }
+
+        for (auto &nh : edit.route.next_hops) {
+            const char *why = oc_next_hop_check(*tx, interfaces, edit.network,
+                                                 nh.second);
+            if (why) {
+                SRP_LOG_ERR("Route %s, next-hop %s: %s", e.first.c_str(),
+                            nh.first.c_str(), why);
+                tx->abort();
+                return SR_ERR_INVAL_ARG;
+            }
+        }
+        adds->emplace_back(edit.network, std::move(edit.route));
+    }
+
+    if (oc_route_conflict(*dels, *adds)) {
+        tx->abort();
+        return SR_ERR_INVAL_ARG;
+    }
+
+    if (dels->empty() && adds->empty())
+        return SR_ERR_OK;
+
+    /* the table describes all the routes, whichever commit made them */
+    tx->program("static-routes", sc_transaction::STAGE_L3,
+                [dels, adds]() { return oc_routes_program(*dels, *adds); },
+                [](reconcile &r) { route_table.describe(r); });
+
+    /* at once, for the next commits to be verified against */
+    tx->on_apply([dels, adds]() {
+        for (auto &d : *dels)
+            route_table.remove(d);
+        for (auto &a : *adds)
+            route_table.set(a.first, a.second);
+    });
+
+    return SR_ERR_OK;
+
+error:
+    sr_free_val(ol);
+    sr_free_val(ne);
+    sc_free_change_iter(it);
+    tx->abort();
+    return rc;
+}
+
+/* State containers replied by oc_static_routes_state_cb */
+enum state_node_t {
+    STATE_STATIC,
+    STATE_NEXT_HOP,
+    STATE_INTERFACE_REF,
+};
+
+static const utils::schema_dispatch state_nodes = {
+    { OC_STATIC "/state", STATE_STATIC },
+    { OC_NEXT_HOP "/state", STATE_NEXT_HOP },
+    { OC_NEXT_HOP "/interface-ref/state", STATE_INTERFACE_REF },
+};
+
+/* Append the state of next-hop nh to val, which has room for 3 values */
+static void
+oc_next_hop_state(const std::string &index, const oc_next_hop_t &nh,
+                  utils::xpath_builder &path, sr_val_t *val, size_t &cnt)
+{
+    path.set(&val[cnt], "index");
+    sr_val_set_str_data(&val[cnt], SR_STRING_T, index.c_str());
+    cnt++;
+
+    switch (nh.type) {
+    case oc_next_hop_t::NH_ADDRESS:
+        path.set(&val[cnt], "next-hop");
+        sr_val_set_str_data(&val[cnt], SR_STRING_T,
+                            nh.address.to_string().c_str());
+        cnt++;
+        break;
+    case oc_next_hop_t::NH_DROP:
+        path.set(&val[cnt], "next-hop");
+        sr_val_set_str_data(&val[cnt], SR_IDENTITYREF_T,
+                            "openconfig-local-routing:DROP");
+        cnt++;
+        break;
+    case oc_next_hop_t::NH_LOCAL_LINK:
+        path.set(&val[cnt], "next-hop");
+        sr_val_set_str_data(&val[cnt], SR_IDENTITYREF_T,
+                            "openconfig-local-routing:LOCAL_LINK");
+        cnt++;
+        break;
+    case oc_next_hop_t::NH_NONE:
+        break;
+    }
+
+    if (nh.has_metric) {
+        path.set(&val[cnt], "metric");
+        val[cnt].type = SR_UINT32_T;
+        val[cnt].data.uint32_val = nh.metric;
+        cnt++;
+    }
+}
+
+/*
+ * The state of a route, of a next-hop and of its interface-ref: what has
+ * been pushed to VPP, read from the route table
+ */
+static int
+oc_static_routes_state_cb(const char *xpath, sr_val_t **values,
+                          size_t *values_cnt, uint64_t request_id,
+                          const char *original_xpath, void *private_ctx)
+{
+    UNUSED(request_id); UNUSED(original_xpath); UNUSED(private_ctx);
+    static thread_local utils::xpath_builder path;
+    utils::xpath_keys keys;
+    oc_static_route_t route;
+    utils::prefix pfx;
+    std::string key;
+    sr_val_t *val = nullptr;
+    size_t cnt = 0;
+    int node;
+    int rc;
+
+    ARG_CHECK3(SR_ERR_INVAL_ARG, xpath, values, values_cnt);
+
+    *values = nullptr;
+    *values_cnt = 0;
+
+    node = state_nodes.match(xpath, keys);
+    key = keys.value(0);
+    if (node < 0 || !utils::prefix::parse(key.c_str(), pfx) ||
+        !route_table.get(pfx.network(), route) || route.key != key)
+        return SR_ERR_OK;
+
+    auto nh = route.next_hops.find(keys.value(1));
+    if (STATE_STATIC != node && nh == route.next_hops.end())
+        return SR_ERR_OK;
+
+    rc = sr_new_values(3, &val);
+    if (SR_ERR_OK != rc)
+        return rc;
+
+    path.entry(xpath);
+
+    switch (node) {
+    case STATE_STATIC:
+        path.set(&val[cnt], "prefix");
+        sr_val_set_str_data(&val[cnt], SR_STRING_T, key.c_str());
+        cnt++;
+        break;
+    case STATE_NEXT_HOP:
+        oc_next_hop_state(nh->first, nh->second, path, val, cnt);
+        break;
+    case STATE_INTERFACE_REF:
+        if (nh->second.interface.empty())
+            break;
+        path.set(&val[cnt], "interface");
+        sr_val_set_str_data(&val[cnt], SR_STRING_T,
+                            nh->second.interface.c_str());
+        cnt++;
+        if (nh->second.has_subinterface) {
+            path.set(&val[cnt], "subinterface");
+            val[cnt].type = SR_UINT32_T;
+            val[cnt].data.uint32_val = nh->second.subinterface;
+            cnt++;
+        }
+        break;
+    }
+
+    if (0 == cnt) {
+        sr_free_values(val, 3);
+        return SR_ERR_OK;
+    }
+
+    *values = val;
+    *values_cnt = cnt;
+
+    return SR_ERR_OK;
+}
+
+int
+openconfig_local_routing_init(sc_plugin_main_t *pm)
+{
+    int rc = SR_ERR_OK;
+    SRP_LOG_DBG_MSG("Initializing openconfig-local-routing plugin.");
+
+    rc = sc_subtree_change_subscribe(pm->session, OC_STATIC,
+            oc_static_routes_config_cb, nullptr, 10, SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    rc = sc_dp_get_items_subscribe(pm->session, OC_STATIC "/state",
+            oc_static_routes_state_cb, nullptr, SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    rc = sc_dp_get_items_subscribe(pm->session, OC_NEXT_HOP "/state",
+            oc_static_routes_state_cb, nullptr, SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    rc = sc_dp_get_items_subscribe(pm->session, OC_NEXT_HOP "/interface-ref/state",
+            oc_static_routes_state_cb, nullptr, SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    SRP_LOG_DBG_MSG("openconfig-local-routing plugin initialized successfully.");
+    return SR_ERR_OK;
+
+error:
+    SRP_LOG_ERR("Error by initialization of openconfig-local-routing plugin. Error : %d", rc);
+    return rc;
+}
+
+void
+openconfig_local_routing_exit(__attribute__((unused)) sc_plugin_main_t *pm)
+{
+}
+
+SC_INIT_FUNCTION(openconfig_local_routing_init);
+SC_EXIT_FUNCTION(openconfig_local_routing_exit);
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sc_connection.h"
+#include "sc_dispatcher.h"
+#include "sc_plugins.h"
+#include "sc_startup.h"
+#include "sc_transaction.h"
+
+#include <algorithm>
+
+#include <vom/hw.hpp>
+
+#include <vpp-oper/hw_lock.hpp>
+
+using namespace std::chrono;
+using VOM::HW;
+
+const milliseconds sc_connection::MIN_BACKOFF(100);
+const milliseconds sc_connection::MAX_BACKOFF(5000);
+
+sc_connection& sc_connection::instance()
+{
+    static sc_connection conn;
+
+    return conn;
+}
+
+sc_connection::sc_connection()
+    : m_stop(false)
+{
+    m_stats.state = STATE_DISCONNECTED;
+    m_stats.attempts = 0;
+    m_stats.connects = 0;
+    m_stats.backoff = MIN_BACKOFF;
+    m_stats.connect_time = milliseconds(0);
+}
+
+void sc_connection::on_start(std::function<void()> f)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_on_start = f;
+}
+
+void sc_connection::on_connect(std::function<bool(bool first)> f)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_on_connect = f;
+}
+
+void sc_connection::start()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    if (m_thread.joinable())
+        return;
+
+    m_stop = false;
+    m_thread = std::thread(&sc_connection::run, this);
+}
+
+void sc_connection::stop()
+{
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_stop = true;
+    }
+    m_cond.notify_all();
+
+    if (m_thread.joinable())
+        m_thread.join();
+
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_stats.state = STATE_DISCONNECTED;
+}
+
+void sc_connection::reconnect()
+{
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        if (STATE_CONNECTED != m_stats.state)
+            return;
+        m_stats.state = STATE_DISCONNECTED;
+    }
+    m_cond.notify_all();
+}
+
+bool sc_connection::is_connected()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return STATE_CONNECTED == m_stats.state;
+}
+
+const char* sc_connection::state_to_string(state_t state)
+{
+    switch (state) {
+        case STATE_DISCONNECTED:
+            return "disconnected";
+        case STATE_CONNECTING:
+            return "connecting";
+        case STATE_CONNECTED:
+            return "connected";
+    }
+
+    return "unknown";
+}
+
+sc_connection::stats_t sc_connection::stats()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_stats;
+}
+
+void sc_connection::run()
+{
+    std::unique_lock<std::mutex> lk(m_lock);
+    steady_clock::time_point begin;
+    /* the hook has not succeeded yet */
+    bool first = true;
+    /* HW is connected from a previous attempt */
+    bool connected = false;
+    bool ok;
+
+    /* run even if stopped already: others may wait for it */
+    if (m_on_start) {
+        lk.unlock();
+        m_on_start();
+        lk.lock();
+    }
+
+    while (!m_stop) {
+        if (STATE_CONNECTED == m_stats.state) {
+            m_cond.wait(lk);
+            continue;
+        }
+
+        begin = steady_clock::now();
+        m_stats.state = STATE_CONNECTING;
+        m_stats.attempts = 0;
+        m_stats.backoff = MIN_BACKOFF;
+
+        while (!m_stop) {
+            m_stats.attempts++;
+
+            /* HW calls wait for VPP replies, never hold the lock over them */
+            lk.unlock();
+            {
+                std::lock_guard<std::mutex> hw(hw_lock());
+                if (connected)
+                    HW::disconnect();
+                ok = HW::connect();
+                connected = ok;
+            }
+            if (ok) {
+                if (first)
+                    sc_startup::instance().record("vpp-connect", begin,
+                                                  steady_clock::now());
+                SRP_LOG_INF("Connection to VPP established after %u attempts",
+                            m_stats.attempts);
+                ok = !m_on_connect || m_on_connect(first);
+                if (!ok)
+                    SRP_LOG_WRN_MSG("VPP connected but not usable, "
+                                    "connecting again");
+            }
+            lk.lock();
+            if (ok || m_stop)
+                break;
+
+            SRP_LOG_DBG("Try connecting to VPP again in %lld ms",
+                        (long long) m_stats.backoff.count());
+            m_cond.wait_for(lk, m_stats.backoff, [this]() { return m_stop; });
+            m_stats.backoff = std::min(m_stats.backoff * 2, MAX_BACKOFF);
+        }
+
+        if (m_stop)
+            break;
+
+        m_stats.state = STATE_CONNECTED;
+        m_stats.connects++;
+        m_stats.connected_at = steady_clock::now();
+        m_stats.connect_time =
+                duration_cast<milliseconds>(m_stats.connected_at - begin);
+
+        /* apply the changes committed while VPP was not connected */
+        lk.unlock();
+        {
+            sc_startup::phase phase("deferred-changes");
+
+            sc_transaction::flush();
+            sc_dispatcher::instance().wait();
+        }
+        if (first)
+            sc_startup::instance().ready();
+        lk.lock();
+        first = false;
+    }
+}
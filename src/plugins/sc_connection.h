@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SC_CONNECTION_H__
+#define __SC_CONNECTION_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/*
+ * Connection to VPP, established in the background.
+ *
+ * A dedicated thread connects to VPP, retrying with an exponential backoff
+ * between MIN_BACKOFF and MAX_BACKOFF, so that neither the plugin init nor
+ * the health check block sysrepo-plugind while VPP is down. The on_start
+ * hook is run by the thread first, e.g. staging the configuration to
+ * program VPP with once connected. Once connected,
+ * the thread runs the on_connect hook, e.g. reading VPP, then applies the
+ * configuration changes that sc_transaction deferred meanwhile. A hook that
+ * fails has the connection dropped and tried again after the backoff.
+ */
+class sc_connection {
+public:
+    enum state_t {
+        STATE_DISCONNECTED = 0,
+        STATE_CONNECTING,
+        STATE_CONNECTED,
+    };
+
+    struct stats_t {
+        state_t state;
+        /* attempts since the connection was last lost */
+        uint32_t attempts;
+        /* connections established since start */
+        uint32_t connects;
+        /* delay before the next attempt */
+        std::chrono::milliseconds backoff;
+        /* time taken to establish the last connection */
+        std::chrono::milliseconds connect_time;
+        /* when the last connection was established */
+        std::chrono::steady_clock::time_point connected_at;
+    };
+
+    static const std::chrono::milliseconds MIN_BACKOFF;
+    static const std::chrono::milliseconds MAX_BACKOFF;
+
+    static sc_connection& instance();
+
+    /* Hook run once by the connection thread, before it first connects */
+    void on_start(std::function<void()> f);
+
+    /* Hook run by the connection thread each time VPP is connected, first is
+     * true until the hook has succeeded once since start(). Return false to
+     * drop the connection and try again. */
+    void on_connect(std::function<bool(bool first)> f);
+
+    /* Start connecting in the background, return at once */
+    void start();
+
+    /* Disconnect and join the connection thread */
+    void stop();
+
+    /* Drop the connection, e.g. when VPP has restarted, and connect again */
+    void reconnect();
+
+    bool is_connected();
+
+    static const char* state_to_string(state_t state);
+
+    stats_t stats();
+
+private:
+    sc_connection();
+
+    void run();
+
+    std::mutex m_lock;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+    std::function<void()> m_on_start;
+    std::function<bool(bool)> m_on_connect;
+    bool m_stop;
+    stats_t m_stats;
+};
+
+#endif /* __SC_CONNECTION_H__ */
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sc_dispatcher.h"
+#include "sc_plugins.h"
+
+#include <exception>
+
+const unsigned sc_dispatcher::MAX_WORKERS;
+
+/* Workers of a job of several shards meeting before it runs */
+struct barrier_t {
+    std::mutex lock;
+    std::condition_variable cond;
+    unsigned arrived;
+    bool done;
+};
+
+sc_dispatcher& sc_dispatcher::instance()
+{
+    static sc_dispatcher dispatcher;
+
+    return dispatcher;
+}
+
+sc_dispatcher::sc_dispatcher() : m_pending(0), m_stop(false)
+{
+}
+
+void sc_dispatcher::start(unsigned n)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    if (!m_workers.empty())
+        return;
+
+    m_stop = false;
+    for (unsigned i = 0; i < n; i++)
+        m_workers.emplace_back(new worker_t());
+    for (auto &w : m_workers) {
+        worker_t *worker = w.get();
+        worker->thread = std::thread([this, worker]() { run(*worker); });
+    }
+
+    SRP_LOG_INF("Dispatch callbacks work to %u workers", n);
+}
+
+void sc_dispatcher::stop()
+{
+    std::vector<std::unique_ptr<worker_t>> workers;
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        m_stop = true;
+        for (auto &w : m_workers)
+            w->cond.notify_one();
+    }
+
+    /* workers leave once their queue is empty */
+    for (auto &w : m_workers)
+        w->thread.join();
+
+    std::lock_guard<std::mutex> lg(m_lock);
+    m_workers.swap(workers);
+}
+
+void sc_dispatcher::run(worker_t &w)
+{
+    std::unique_lock<std::mutex> lk(m_lock);
+    std::function<void()> job;
+
+    for (;;) {
+        w.cond.wait(lk, [this, &w]() { return m_stop || !w.jobs.empty(); });
+        if (w.jobs.empty())
+            break;
+
+        job = std::move(w.jobs.front());
+        w.jobs.pop_front();
+
+        lk.unlock();
+        job();
+        lk.lock();
+    }
+}
+
+void sc_dispatcher::push(const std::set<unsigned> &workers,
+                         std::function<void()> f)
+{
+    std::function<void()> job;
+
+    m_pending++;
+
+    job = [this, f]() {
+        try {
+            f();
+        } catch (std::exception &e) {
+            SRP_LOG_ERR("Dispatched job failed: %s", e.what());
+        } catch (...) {
+            SRP_LOG_ERR_MSG("Dispatched job failed");
+        }
+
+        std::lock_guard<std::mutex> lg(m_lock);
+        if (0 == --m_pending)
+            m_idle.notify_all();
+    };
+
+    if (workers.size() > 1) {
+        std::shared_ptr<barrier_t> b = std::make_shared<barrier_t>();
+        unsigned count = workers.size();
+
+        b->arrived = 0;
+        b->done = false;
+
+        /* the last worker to arrive runs the job, the others wait for it:
+         * jobs are queued on all workers at once under m_lock, so they
+         * reach them in the same order and cannot wait for each other */
+        job = [b, count, job]() {
+            std::unique_lock<std::mutex> lk(b->lock);
+
+            if (++b->arrived < count) {
+                b->cond.wait(lk, [&b]() { return b->done; });
+                return;
+            }
+
+            lk.unlock();
+            job();
+            lk.lock();
+            b->done = true;
+            b->cond.notify_all();
+        };
+    }
+
+    for (unsigned i : workers) {
+        m_workers[i]->jobs.push_back(job);
+        m_workers[i]->cond.notify_one();
+    }
+}
+
+void sc_dispatcher::dispatch(const std::string &shard,
+                             std::function<void()> f)
+{
+    dispatch(std::set<std::string>{ shard }, f);
+}
+
+void sc_dispatcher::dispatch(const std::set<std::string> &shards,
+                             std::function<void()> f)
+{
+    std::set<unsigned> workers;
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        if (!m_workers.empty() && !m_stop) {
+            for (auto &s : shards)
+                workers.insert(std::hash<std::string>()(s) % m_workers.size());
+            if (workers.empty())
+                workers.insert(0);
+            push(workers, f);
+            return;
+        }
+    }
+
+    f();
+}
+
+void sc_dispatcher::wait()
+{
+    std::unique_lock<std::mutex> lk(m_lock);
+
+    m_idle.wait(lk, [this]() { return 0 == m_pending; });
+}
+
+size_t sc_dispatcher::pending()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_pending;
+}
+
+unsigned sc_dispatcher::workers()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_workers.size();
+}
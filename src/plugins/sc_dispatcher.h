@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SC_DISPATCHER_H__
+#define __SC_DISPATCHER_H__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Pool of worker threads running jobs off the sysrepo callback thread.
+ *
+ * A job belongs to one or more shards, e.g. the interfaces a commit
+ * touches. A shard always goes to the same worker, so the jobs of one shard
+ * run one after the other in dispatch order, while jobs of shards on
+ * different workers run in parallel. A job of several shards is queued on
+ * each of their workers: it runs once all of them have reached it, and
+ * holds them until it is done.
+ *
+ * Until start() is called, or with no worker, jobs run in the caller.
+ */
+class sc_dispatcher {
+public:
+    /* Workers started for as many cores, at most */
+    static const unsigned MAX_WORKERS = 4;
+
+    static sc_dispatcher& instance();
+
+    /* Start n workers, return at once */
+    void start(unsigned n);
+
+    /* Run the jobs queued, then join the workers */
+    void stop();
+
+    /* Run f on the worker of shard */
+    void dispatch(const std::string &shard, std::function<void()> f);
+
+    /* Run f on the workers of all the shards, in order with each of them */
+    void dispatch(const std::set<std::string> &shards,
+                  std::function<void()> f);
+
+    /* Wait for the jobs dispatched so far to be done */
+    void wait();
+
+    /* Number of jobs queued or running */
+    size_t pending();
+
+    unsigned workers();
+
+private:
+    struct worker_t {
+        std::thread thread;
+        std::deque<std::function<void()>> jobs;
+        std::condition_variable cond;
+    };
+
+    sc_dispatcher();
+
+    void run(worker_t &w);
+
+    /* Queue f on workers, m_lock must be held */
+    void push(const std::set<unsigned> &workers, std::function<void()> f);
+
+    std::mutex m_lock;
+    std::condition_variable m_idle;
+    std::vector<std::unique_ptr<worker_t>> m_workers;
+    size_t m_pending;
+    bool m_stop;
+};
+
+#endif /* __SC_DISPATCHER_H__ */
@@ -14,6 +14,7 @@
  */
 
 #include "sc_plugins.h"
+#include "sc_startup.h"
 
 int
 sc_call_all_init_function(sc_plugin_main_t *pm)
@@ -22,6 +23,7 @@ sc_call_all_init_function(sc_plugin_main_t *pm)
     _sc_init_function_list_elt_t *p = pm->init_function_registrations;
     while (p != NULL) {
         if (!p->is_called) {
+            sc_startup::phase phase(std::string("init:") + p->name);
             p->is_called = true;
             ret = p->func(pm);
             if (ret != SR_ERR_OK) {
@@ -33,6 +33,7 @@ _(exit)
 typedef struct _sc_##tag##_function_list_elt {  \
     struct _sc_##tag##_function_list_elt *next; \
     sc_##tag##_function_t *func;                \
+    const char *name;                           \
     bool is_called;                             \
 } _sc_##tag##_function_list_elt_t;
 foreach_sc_declare_function_list
@@ -47,6 +48,7 @@ static void __sc_add_##tag##_function_##f()
     static _sc_##tag##_function_list_elt_t _sc_##tag##_function;                    \
     _sc_##tag##_function.next = pm->tag##_function_registrations;                   \
     _sc_##tag##_function.func = &f;                                                 \
+    _sc_##tag##_function.name = #f;                                                 \
     _sc_##tag##_function.is_called = false;                                         \
     pm->tag##_function_registrations = &_sc_##tag##_function;                       \
 }                                                                                   \
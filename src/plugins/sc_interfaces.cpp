@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sc_interfaces.h"
+
+#include <cstdio>
+#include <sstream>
+
+#include "sc_plugins.h"
+#include "sc_transaction.h"
+
+using VOM::interface;
+
+using type_t = VOM::interface::type_t;
+using admin_state_t = VOM::interface::admin_state_t;
+
+namespace sc_interfaces {
+
+const size_t state::MAC_STRLEN;
+
+void intent::set_type(const std::string &type)
+{
+    if (type == "iana-if-type:ethernetCsmacd")
+        m_type = "ETHERNET";
+}
+
+std::shared_ptr<interface> intent::build() const
+{
+    if (m_name.empty() || m_type.empty())
+        return nullptr;
+
+    return std::make_shared<interface>(m_name, type_t::from_string(m_type),
+                                       admin_state_t::from_int(m_enabled));
+}
+
+std::string intent::to_string() const
+{
+    std::ostringstream os;
+
+    os << m_name << "," << m_type << "," << m_enabled;
+
+    return os.str();
+}
+
+/* What VPP must have for an interface written */
+static sc_transaction::describe_t describe(const std::string &name, bool up)
+{
+    return [name, up](reconcile &r) { r.interface(name, up); };
+}
+
+int changes::enable(const std::string &name, bool up)
+{
+    std::shared_ptr<interface> intf = m_tx.find_interface(name);
+
+    if (!intf) {
+        SRP_LOG_ERR("Interface %s does not exist", name.c_str());
+        return SR_ERR_OPERATION_FAILED;
+    }
+
+    interface itf(*intf);
+    itf.set(admin_state_t::from_int(up));
+    m_tx.write(itf, describe(name, up));
+
+    return SR_ERR_OK;
+}
+
+void changes::remove(const std::string &name)
+{
+    SRP_LOG_INF("deleting interface '%s'", name.c_str());
+    m_tx.remove(name, sc_transaction::STAGE_INTERFACE);
+}
+
+int changes::stage()
+{
+    bool created = false;
+
+    for (auto &it : m_created) {
+        /* leaves created under an existing interface */
+        if (it.second.name().empty())
+            continue;
+
+        SRP_LOG_INF("creating interface '%s'", it.first.c_str());
+        std::shared_ptr<interface> intf = it.second.build();
+        if (nullptr == intf) {
+            SRP_LOG_ERR("Fail building interface: %s",
+                        it.second.to_string().c_str());
+            return SR_ERR_INVAL_ARG;
+        }
+
+        /* Written to VOM DB and VPP with interface name as key on apply.
+         * Work for modifications too, because OM::write() check for
+         * existing l3 bindings. */
+        m_tx.write(*intf, describe(it.second.name(), it.second.enabled()));
+        created = true;
+    }
+
+    /* VPP does not send events for new interfaces */
+    if (created)
+        m_tx.on_commit([]() { interface_cache::instance().invalidate(); });
+
+    return SR_ERR_OK;
+}
+
+void state::phys_address(char *buf) const
+{
+    const uint8_t *mac = m_details.l2_address;
+
+    snprintf(buf, MAC_STRLEN, "%02x:%02x:%02x:%02x:%02x:%02x", mac[0], mac[1],
+             mac[2], mac[3], mac[4], mac[5]);
+}
+
+} //end of sc_interfaces namespace
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SC_INTERFACES_H__
+#define __SC_INTERFACES_H__
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+#include <vom/interface.hpp>
+
+#include <vpp-oper/interface_cache.hpp>
+
+class sc_transaction;
+
+/*
+ * VPP interfaces as the ietf-interfaces and openconfig-interfaces models
+ * both see them. The two front ends only translate between their YANG
+ * nodes and this model:
+ *  - configuration of either model is gathered in a changes, then staged
+ *    in the sc_transaction of the commit under the interface name. An
+ *    interface changed through both models in one commit is written to
+ *    VPP once, with its last value.
+ *  - operational state of either model is read from the same
+ *    interface_cache table, one dump kept current by VPP events, and
+ *    translated by the same state view, so that both models agree.
+ */
+namespace sc_interfaces {
+
+/* Interface as configured, whichever model configured it */
+class intent {
+public:
+    /* enabled defaults to true in both models */
+    intent() : m_enabled(true) {}
+
+    void set_name(const std::string &name) { m_name = name; }
+
+    /* Type identity, e.g. "iana-if-type:ethernetCsmacd", the ones VPP
+     * can not create are left unset */
+    void set_type(const std::string &type);
+
+    void set_enabled(bool enabled) { m_enabled = enabled; }
+
+    const std::string& name() const { return m_name; }
+    bool enabled() const { return m_enabled; }
+
+    /* VOM interface, null if the name or the type is missing */
+    std::shared_ptr<VOM::interface> build() const;
+
+    std::string to_string() const;
+
+private:
+    std::string m_name;
+    std::string m_type;
+    bool m_enabled;
+};
+
+/* Interface changes of one model in one commit, staged in tx */
+class changes {
+public:
+    explicit changes(sc_transaction &tx) : m_tx(tx) {}
+
+    /* Intent of interface created under key, the list key of the model */
+    intent& create(const std::string &key) { return m_created[key]; }
+
+    /* Set admin state of existing interface name. Return a sysrepo error
+     * code */
+    int enable(const std::string &name, bool up);
+
+    /* Remove interface name */
+    void remove(const std::string &name);
+
+    /* Stage the interfaces created in the transaction. Return a sysrepo
+     * error code, the transaction is left to the caller to abort */
+    int stage();
+
+private:
+    sc_transaction &m_tx;
+    std::map<std::string, intent> m_created;
+};
+
+/* Operational state of a VPP interface, read in place from the
+ * interface_cache details, as both models report it */
+class state {
+public:
+    explicit state(const interface_cache::details_t &details)
+        : m_details(details) {}
+
+    const char* name() const
+    {
+        return (const char *) m_details.interface_name;
+    }
+
+    uint32_t index() const { return m_details.sw_if_index; }
+
+    bool admin_up() const
+    {
+        return m_details.flags & IF_STATUS_API_FLAG_ADMIN_UP;
+    }
+
+    bool oper_up() const
+    {
+        return m_details.flags & IF_STATUS_API_FLAG_LINK_UP;
+    }
+
+    uint16_t mtu() const { return m_details.link_mtu; }
+
+    /* link speed, as VPP reports it */
+    uint64_t speed() const { return m_details.link_speed; }
+
+    /* Write "xx:xx:xx:xx:xx:xx" in buf of at least MAC_STRLEN bytes */
+    static const size_t MAC_STRLEN = sizeof("xx:xx:xx:xx:xx:xx");
+    void phys_address(char *buf) const;
+
+private:
+    const interface_cache::details_t &m_details;
+};
+
+} //end of sc_interfaces namespace
+
+#endif /* __SC_INTERFACES_H__ */
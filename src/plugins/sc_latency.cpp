@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sc_latency.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "sc_running.h"
+
+using namespace std::chrono;
+
+const unsigned sc_latency::SUB_BITS;
+const unsigned sc_latency::SUB_BUCKETS;
+const unsigned sc_latency::MAX_BITS;
+const unsigned sc_latency::BUCKETS;
+const unsigned sc_latency::SHARDS;
+
+/* Shard a thread records in, threads are given one in turn */
+static unsigned shard_of_thread()
+{
+    static std::atomic<unsigned> next(0);
+    static thread_local unsigned shard =
+        next.fetch_add(1, std::memory_order_relaxed) % sc_latency::SHARDS;
+
+    return shard;
+}
+
+sc_latency& sc_latency::instance()
+{
+    static sc_latency latency;
+
+    return latency;
+}
+
+unsigned sc_latency::bucket(uint64_t us)
+{
+    unsigned msb, shift;
+
+    if (us < SUB_BUCKETS)
+        return us;
+
+    msb = 63 - __builtin_clzll(us);
+    if (msb > MAX_BITS)
+        return BUCKETS - 1;
+
+    shift = msb - SUB_BITS;
+
+    return (shift + 1) * SUB_BUCKETS + ((us >> shift) & (SUB_BUCKETS - 1));
+}
+
+uint64_t sc_latency::upper_bound(unsigned bucket)
+{
+    unsigned shift;
+
+    if (bucket < SUB_BUCKETS)
+        return bucket + 1;
+
+    shift = bucket / SUB_BUCKETS - 1;
+
+    return (uint64_t) (bucket % SUB_BUCKETS + SUB_BUCKETS + 1) << shift;
+}
+
+const char* sc_latency::type_to_string(type_t type)
+{
+    switch (type) {
+    case TYPE_CHANGE:
+        return "change";
+    case TYPE_GET:
+        return "get";
+    }
+
+    return "unknown";
+}
+
+sc_latency::callback* sc_latency::add(const std::string &xpath, type_t type,
+                                      void *private_ctx)
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+
+    m_callbacks.emplace_back(new callback(xpath, type, private_ctx));
+
+    return m_callbacks.back().get();
+}
+
+std::vector<sc_latency::stats_t> sc_latency::stats()
+{
+    std::lock_guard<std::mutex> lock(m_lock);
+    std::vector<stats_t> all;
+
+    all.reserve(m_callbacks.size());
+    for (auto &cb : m_callbacks)
+        all.push_back(cb->stats());
+
+    return all;
+}
+
+uint64_t sc_latency::stats_t::percentile(double q) const
+{
+    uint64_t rank = (uint64_t) (q * calls + 0.5);
+    uint64_t seen = 0;
+
+    if (0 == calls)
+        return 0;
+    if (0 == rank)
+        rank = 1;
+
+    for (unsigned b = 0; b < BUCKETS; b++) {
+        seen += buckets[b];
+        if (seen >= rank)
+            return std::min(upper_bound(b), max);
+    }
+
+    return max;
+}
+
+sc_latency::callback::shard_t::shard_t()
+    : calls(0), errors(0), total(0), max(0)
+{
+    for (auto &b : buckets)
+        b.store(0, std::memory_order_relaxed);
+}
+
+sc_latency::callback::callback(const std::string &xpath, type_t type,
+                               void *private_ctx)
+    : m_xpath(xpath), m_type(type), m_private_ctx(private_ctx),
+      m_change(nullptr), m_get(nullptr)
+{
+}
+
+void sc_latency::callback::record(steady_clock::duration d, bool error)
+{
+    shard_t &s = m_shards[shard_of_thread()];
+    uint64_t us = duration_cast<microseconds>(d).count();
+    uint64_t max = s.max.load(std::memory_order_relaxed);
+
+    s.calls.fetch_add(1, std::memory_order_relaxed);
+    if (error)
+        s.errors.fetch_add(1, std::memory_order_relaxed);
+    s.total.fetch_add(us, std::memory_order_relaxed);
+    s.buckets[bucket(us)].fetch_add(1, std::memory_order_relaxed);
+
+    while (us > max && !s.max.compare_exchange_weak(max, us,
+                                                    std::memory_order_relaxed))
+        ;
+}
+
+sc_latency::stats_t sc_latency::callback::stats() const
+{
+    stats_t st;
+
+    st.xpath = m_xpath;
+    st.type = m_type;
+    st.calls = st.errors = st.total = st.max = 0;
+    memset(st.buckets, 0, sizeof(st.buckets));
+
+    /* shards are read while being written, the sums may be off by the calls
+     * being recorded */
+    for (auto &s : m_shards) {
+        st.calls += s.calls.load(std::memory_order_relaxed);
+        st.errors += s.errors.load(std::memory_order_relaxed);
+        st.total += s.total.load(std::memory_order_relaxed);
+        st.max = std::max(st.max, s.max.load(std::memory_order_relaxed));
+        for (unsigned b = 0; b < BUCKETS; b++)
+            st.buckets[b] += s.buckets[b].load(std::memory_order_relaxed);
+    }
+
+    return st;
+}
+
+static int change_cb(sr_session_ctx_t *session, const char *xpath,
+                     sr_notif_event_t event, void *private_ctx)
+{
+    sc_latency::callback *cb = (sc_latency::callback*) private_ctx;
+    steady_clock::time_point start;
+    int rc;
+
+    /* commits apply on top of the running datastore applied at start */
+    sc_running::instance().wait();
+
+    start = steady_clock::now();
+    rc = cb->m_change(session, xpath, event, cb->m_private_ctx);
+    cb->record(steady_clock::now() - start, SR_ERR_OK != rc);
+
+    return rc;
+}
+
+static int get_items_cb(const char *xpath, sr_val_t **values,
+                        size_t *values_cnt, uint64_t request_id,
+                        const char *original_xpath, void *private_ctx)
+{
+    sc_latency::callback *cb = (sc_latency::callback*) private_ctx;
+    steady_clock::time_point start = steady_clock::now();
+    int rc;
+
+    rc = cb->m_get(xpath, values, values_cnt, request_id, original_xpath,
+                   cb->m_private_ctx);
+    cb->record(steady_clock::now() - start, SR_ERR_OK != rc);
+
+    return rc;
+}
+
+int sc_subtree_change_subscribe(sr_session_ctx_t *session, const char *xpath,
+                                sr_subtree_change_cb callback,
+                                void *private_ctx, uint32_t priority,
+                                sr_subscr_options_t opts,
+                                sr_subscription_ctx_t **subscription)
+{
+    sc_latency::callback *cb;
+
+    cb = sc_latency::instance().add(xpath, sc_latency::TYPE_CHANGE,
+                                    private_ctx);
+    cb->m_change = callback;
+
+    /* subscribed once the running datastore is read, which is applied
+     * through the same wrapper */
+    return sc_running::instance().add(session, xpath, change_cb, cb,
+                                      priority, opts, subscription);
+}
+
+int sc_dp_get_items_subscribe(sr_session_ctx_t *session, const char *xpath,
+                              sr_dp_get_items_cb callback, void *private_ctx,
+                              sr_subscr_options_t opts,
+                              sr_subscription_ctx_t **subscription)
+{
+    sc_latency::callback *cb;
+
+    cb = sc_latency::instance().add(xpath, sc_latency::TYPE_GET, private_ctx);
+    cb->m_get = callback;
+
+    return sr_dp_get_items_subscribe(session, xpath, get_items_cb, cb, opts,
+                                     subscription);
+}
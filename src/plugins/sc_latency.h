@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SC_LATENCY_H__
+#define __SC_LATENCY_H__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+extern "C" {
+    #include <sysrepo.h>
+}
+
+/*
+ * Call counts, error counts and latency histograms of the sysrepo callbacks.
+ *
+ * Callbacks subscribed with sc_subtree_change_subscribe() or
+ * sc_dp_get_items_subscribe() are called through a wrapper timing them.
+ * Latencies are counted in microseconds in log-linear buckets: exact below
+ * SUB_BUCKETS, then each power of two is split in SUB_BUCKETS linear
+ * buckets, which bounds the error of a percentile to 1 / SUB_BUCKETS.
+ *
+ * Recording takes no lock: each callback has SHARDS sets of counters, a
+ * thread always records in the same one and threads are spread over them,
+ * so that sysrepo threads do not contend on the same cache lines.
+ */
+class sc_latency {
+public:
+    enum type_t {
+        TYPE_CHANGE = 0,
+        TYPE_GET,
+    };
+
+    static const unsigned SUB_BITS = 2;
+    static const unsigned SUB_BUCKETS = 1 << SUB_BITS;
+    /* latencies from 2^26 us (67 s) on share the last bucket */
+    static const unsigned MAX_BITS = 26;
+    static const unsigned BUCKETS = (MAX_BITS - SUB_BITS + 2) * SUB_BUCKETS;
+    static const unsigned SHARDS = 8;
+
+    /* Counters of one callback summed over all threads */
+    struct stats_t {
+        std::string xpath;
+        type_t type;
+        uint64_t calls;
+        uint64_t errors;
+        /* in microseconds */
+        uint64_t total;
+        uint64_t max;
+        uint64_t buckets[BUCKETS];
+
+        /* Upper bound of the bucket holding quantile q, in microseconds */
+        uint64_t percentile(double q) const;
+    };
+
+    /* A subscribed callback, passed to sysrepo as private context */
+    class callback {
+    public:
+        callback(const std::string &xpath, type_t type, void *private_ctx);
+
+        /* Count one call which took d */
+        void record(std::chrono::steady_clock::duration d, bool error);
+
+        stats_t stats() const;
+
+        const std::string m_xpath;
+        const type_t m_type;
+        void * const m_private_ctx;
+        sr_subtree_change_cb m_change;
+        sr_dp_get_items_cb m_get;
+
+    private:
+        struct shard_t {
+            shard_t();
+
+            std::atomic<uint64_t> calls;
+            std::atomic<uint64_t> errors;
+            std::atomic<uint64_t> total;
+            std::atomic<uint64_t> max;
+            std::atomic<uint64_t> buckets[BUCKETS];
+            /* keep counters of two shards off the same cache line */
+            char pad[64];
+        };
+
+        shard_t m_shards[SHARDS];
+    };
+
+    static sc_latency& instance();
+
+    /* Bucket of a latency in microseconds */
+    static unsigned bucket(uint64_t us);
+
+    /* Exclusive upper bound of a bucket, in microseconds */
+    static uint64_t upper_bound(unsigned bucket);
+
+    static const char* type_to_string(type_t type);
+
+    /* Register a callback subscribed at xpath */
+    callback* add(const std::string &xpath, type_t type, void *private_ctx);
+
+    /* Counters of all callbacks, in subscription order */
+    std::vector<stats_t> stats();
+
+private:
+    sc_latency() = default;
+
+    std::mutex m_lock;
+    std::vector<std::unique_ptr<callback>> m_callbacks;
+};
+
+/* Same as sr_subtree_change_subscribe(), callback calls are timed. The
+ * subscription is made by sc_running::read() */
+int sc_subtree_change_subscribe(sr_session_ctx_t *session, const char *xpath,
+                                sr_subtree_change_cb callback,
+                                void *private_ctx, uint32_t priority,
+                                sr_subscr_options_t opts,
+                                sr_subscription_ctx_t **subscription);
+
+/* Same as sr_dp_get_items_subscribe(), callback calls are timed */
+int sc_dp_get_items_subscribe(sr_session_ctx_t *session, const char *xpath,
+                              sr_dp_get_items_cb callback, void *private_ctx,
+                              sr_subscr_options_t opts,
+                              sr_subscription_ctx_t **subscription);
+
+#endif /* __SC_LATENCY_H__ */
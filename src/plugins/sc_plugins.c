@@ -17,135 +17,163 @@
 
 #include "sc_plugins.h"
 
-#include <dirent.h>
-#include <string.h>
-#include <errno.h>
-
 #include <vom/hw.hpp>
 #include <vom/om.hpp>
 
-static int vpp_pid_start;
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+#include <vpp-oper/hw_lock.hpp>
+#include <vpp-oper/interface_cache.hpp>
+#include <vpp-oper/read_pool.hpp>
+#include <vpp-oper/reconcile.hpp>
+#include <vpp-oper/stats.hpp>
+
+#include "sc_connection.h"
+#include "sc_dispatcher.h"
+#include "sc_request.h"
+#include "sc_running.h"
+#include "sc_startup.h"
+#include "sc_transaction.h"
+#include "sc_vpp_monitor.h"
+
+static sc_vpp_monitor vpp_monitor;
 
 sc_plugin_main_t sc_plugin_main;
 
 using namespace VOM;
 
-#define _DIRENT_NAME 256
-#define CMDLINE_MAX _DIRENT_NAME + 15
-#define VPP_FULL_PATH "/usr/bin/vpp"
-
 sc_plugin_main_t *sc_get_plugin_main()
 {
     return &sc_plugin_main;
 }
 
 /**
- * @brief get one pid of any running vpp process.
- * @return Return vpp pid or -ESRH value if process was not found
+ * @brief run by the connection thread each time VPP is connected.
+ * Reads are made possible first, so that they are served while VOM
+ * database is populated; changes stay deferred until this returns.
  */
-int get_vpp_pid()
+static bool vpp_connected(bool first)
 {
-    DIR *dir = NULL;
-    struct dirent *ptr = NULL;
-    FILE *fp = NULL;
-    char filepath[CMDLINE_MAX];
-    char filetext[sizeof(VPP_FULL_PATH)+1];
-    char *first = NULL;
-    size_t cnt;
-
-    dir = opendir("/proc");
-    if (dir == NULL)
-        return -errno;
-
-    /* read vpp pid file in proc, return pid of vpp */
-    while (NULL != (ptr = readdir(dir)))
+    /* Reads have connections of their own, lost with previous VPP too */
     {
-        if ((0 == strcmp(ptr->d_name, ".")) || (0 == strcmp(ptr->d_name, "..")))
-            continue;
-
-        if (DT_DIR != ptr->d_type)
-            continue;
-
-        /* Open cmdline of PID */
-        snprintf(filepath, CMDLINE_MAX, "/proc/%s/cmdline", ptr->d_name);
-        fp = fopen(filepath, "r");
-        if (fp == NULL)
-            continue;
-
-        /* Write '/0' char in filetext array to prevent stack reading */
-        bzero(filetext, sizeof(VPP_FULL_PATH));
-
-        /* Read the string written in cmdline file */
-        cnt = fread(filetext, sizeof(char), sizeof(VPP_FULL_PATH), fp);
-        if (cnt == 0) {
-            fclose(fp);
-            continue;
-        }
-        filetext[cnt] = '\0';
+        sc_startup::phase phase("read-pool");
 
-        /* retrieve string before first space */
-        first = strtok(filetext, " ");
-        if (first == NULL) { //unmet space delimiter
-            fclose(fp);
-            continue;
-        }
+        read_pool::instance().disconnect();
+        if (read_pool::instance().connect() < read_pool::SIZE)
+            SRP_LOG_WRN("only %u read connections to VPP, reads share the "
+                        "rest", read_pool::instance().size());
+    }
 
-        /* One VPP process has been found */
-        if (!strcmp(first, "vpp") || !strcmp(first, VPP_FULL_PATH)) {
-            fclose(fp);
-            closedir(dir);
-            return atoi(ptr->d_name);
-        }
+    /* Interface events registration was lost with previous connection */
+    {
+        sc_startup::phase phase("interface-cache");
 
-        fclose(fp); // we assume fclose don't fail
+        if (interface_cache::instance().restart() != rc_t::OK)
+            SRP_LOG_WRN_MSG("fail filling interface cache, retry on first read");
+    }
 
-        errno = 0; //to distinguish readdir() error from end of dir
+    /* Stats segment of previous VPP is gone, map the new one */
+    {
+        sc_startup::phase phase("stats-segment");
+
+        interface_stats::instance().disconnect();
+        sc_request::clear();
+        if (!interface_stats::instance().connect())
+            SRP_LOG_WRN_MSG("fail connecting VPP stats segment, retry on first read");
     }
 
-    if (errno != 0) { //this means an error has occured in readir
-        SRP_LOG_ERR("readir errno %d", errno);
-        return -errno;
+    /* Find VPP process, then watch it without scanning /proc again */
+    {
+        sc_startup::phase phase("vpp-monitor");
+
+        if (vpp_monitor.attach() < 0)
+            SRP_LOG_WRN_MSG("fail finding VPP process, health check pings "
+                            "VPP until it is found");
     }
 
-    closedir(dir);
+    if (first) {
+        sc_startup::phase phase("populate");
 
-    return -ESRCH;
-}
+        try {
+            std::lock_guard<std::mutex> hw(hw_lock());
+            OM::populate("boot");
+        } catch (...) {
+            SRP_LOG_ERR_MSG("fail populating VOM database");
+            return false;
+        }
+    } else {
+        /* Though VPP has crashed, VOM database has kept the configuration.
+         * Only what the new VPP is missing of it is programmed again, so
+         * that VPP state matches sysrepo RUNNING DS and VOM database. */
+        sc_startup::phase phase("reconcile");
+        reconcile r;
+        reconcile::result_t res;
+
+        sc_transaction::describe(r);
+        res = r.run();
+        SRP_LOG_INF("VPP reconciled by %s in %lld ms: %zu objects checked, "
+                    "%zu written, %zu failed",
+                    res.replayed ? "replay" : "difference",
+                    (long long) res.duration.count(), res.checked,
+                    res.written, res.failed);
+    }
 
+    return true;
+}
 
 int sr_plugin_init_cb(sr_session_ctx_t *session, void **private_ctx)
 {
     int rc = SR_ERR_OK;;
 
     sc_plugin_main.session = session;
+    sc_startup::instance().begin();
+    sc_startup::phase phase("plugin-init");
+
+    /* Connection to VAPI via VOM and VOM database. Connecting is done in
+     * the background, changes are deferred until VPP is connected. */
+    {
+        sc_startup::phase phase("vom-init");
 
-    /* Connection to VAPI via VOM and VOM database */
-    HW::init();
-    OM::init();
-    while (HW::connect() != true);
-    SRP_LOG_INF_MSG("Connection to VPP established");
-
-    try {
-        OM::populate("boot");
-    } catch (...) {
-        SRP_LOG_ERR_MSG("fail populating VOM database");
-        exit(1);
+        HW::init();
+        OM::init();
+    }
+    /* VPP is programmed off the sysrepo thread, reads are served meanwhile */
+    {
+        sc_startup::phase phase("dispatcher-start");
+
+        sc_dispatcher::instance().start(
+            std::min(std::max(1u, std::thread::hardware_concurrency()),
+                     sc_dispatcher::MAX_WORKERS));
     }
 
+    /* Subscriptions are registered without waiting for VPP */
     rc = sc_call_all_init_function(&sc_plugin_main);
     if (rc != SR_ERR_OK) {
         SRP_LOG_ERR("Call all init function error: %d", rc);
         return rc;
     }
 
+    /* Configuration already in running datastore is read before changes
+     * are subscribed to, so that none is seen twice */
+    rc = sc_running::instance().read(session);
+    if (rc != SR_ERR_OK)
+        return rc;
+
+    /* It is then staged as one commit by the connection thread, deferred
+     * until VPP is connected, then pushed to VPP in one pass with the
+     * changes committed meanwhile. Left out if it is refused: the next
+     * commits are still applied. */
+    sc_connection::instance().on_start([]() {
+        sc_running::instance().apply();
+    });
+    sc_connection::instance().on_connect(vpp_connected);
+    sc_connection::instance().start();
+
     /* set subscription as our private context */
     *private_ctx = sc_plugin_main.subscription;
 
-    /* Get initial PID of VPP process */
-    vpp_pid_start = get_vpp_pid();
-    if (vpp_pid_start < 0)
-        return SR_ERR_DISCONNECT;
-
     return SR_ERR_OK;
 }
 
@@ -158,34 +186,56 @@ void sr_plugin_cleanup_cb(sr_session_ctx_t *session, void *private_ctx)
         sr_unsubscribe(session, (sr_subscription_ctx_t*) private_ctx);
     SRP_LOG_DBG_MSG("unload plugin ok.");
 
-    HW::disconnect();
+    sc_connection::instance().stop();
+    /* commits handed to the workers reach VPP before it is disconnected */
+    sc_dispatcher::instance().stop();
+    interface_cache::instance().stop();
+    interface_stats::instance().disconnect();
+    read_pool::instance().disconnect();
+    vpp_monitor.detach();
+
+    {
+        std::lock_guard<std::mutex> hw(hw_lock());
+        HW::disconnect();
+    }
     SRP_LOG_DBG_MSG("plugin disconnect vpp ok.");
 }
 
-int sr_plugin_health_check_cb(sr_session_ctx_t *session, void *private_ctx)
+/* VPP replies to a ping on the VAPI connection. One busy programming VPP
+ * is taken for a reply. */
+static bool vpp_replies()
 {
-    UNUSED(session); UNUSED(private_ctx);
-    int vpp_pid_now = get_vpp_pid();
+    std::unique_lock<std::mutex> hw(hw_lock(), std::try_to_lock);
 
-    if (vpp_pid_now == vpp_pid_start)
-        return SR_ERR_OK; //VPP has not crashed
+    if (!hw.owns_lock())
+        return true;
 
-    SRP_LOG_WRN("VPP has crashed, new pid %d", vpp_pid_now);
-
-    /* Wait until we succeed connecting to VPP */
-    HW::disconnect();
-    while (HW::connect() != true) {
-        SRP_LOG_DBG_MSG("Try connecting to VPP again");
-    };
+    return HW::poll();
+}
 
-    SRP_LOG_DBG_MSG("Connection to VPP established again");
+int sr_plugin_health_check_cb(sr_session_ctx_t *session, void *private_ctx)
+{
+    UNUSED(session); UNUSED(private_ctx);
 
-    /* Though VPP has crashed, VOM database has kept the configuration.
-     * This function replays the previous configuration to reconfigure VPP
-     * so that VPP state matches sysrepo RUNNING DS and VOM database. */
-    OM::replay();
+    /* connection thread is (re)connecting */
+    if (!sc_connection::instance().is_connected())
+        return SR_ERR_OK;
+
+    /* A monitor that failed to attach watches nothing, so that its VPP is
+     * never alive: look for the process again, else ask VPP itself */
+    if (vpp_monitor.pid() < 0 && vpp_monitor.attach() < 0) {
+        if (vpp_replies())
+            return SR_ERR_OK;
+        SRP_LOG_WRN_MSG("VPP does not reply");
+    } else if (vpp_monitor.alive()) {
+        return SR_ERR_OK; //VPP has not crashed
+    } else {
+        SRP_LOG_WRN("VPP has crashed, pid %d", vpp_monitor.pid());
+    }
+    vpp_monitor.detach();
 
-    vpp_pid_start = vpp_pid_now;
+    /* Reconnect and replay configuration in the background */
+    sc_connection::instance().reconnect();
 
     return SR_ERR_OK;
 }
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sc_request.h"
+
+#include <algorithm>
+#include <map>
+
+#include "sc_plugins.h"
+
+using namespace std::chrono;
+
+const milliseconds sc_request::TTL(2000);
+
+namespace {
+
+struct entry_t {
+    std::shared_ptr<const sc_request> snapshot;
+    steady_clock::time_point taken;
+};
+
+std::mutex requests_lock;
+/* by request_id, protected by requests_lock */
+std::map<uint64_t, entry_t> requests;
+uint64_t requests_taken = 0;
+
+/* Drop the snapshots expired at now, then the oldest ones beyond max,
+ * requests_lock held */
+void expire(steady_clock::time_point now, size_t max)
+{
+    for (auto it = requests.begin(); it != requests.end();) {
+        if (now - it->second.taken >= sc_request::TTL)
+            it = requests.erase(it);
+        else
+            ++it;
+    }
+
+    while (requests.size() > max) {
+        auto oldest = requests.begin();
+
+        for (auto it = requests.begin(); it != requests.end(); ++it) {
+            if (it->second.taken < oldest->second.taken)
+                oldest = it;
+        }
+        requests.erase(oldest);
+    }
+}
+
+}
+
+std::shared_ptr<const sc_request> sc_request::get(uint64_t request_id)
+{
+    std::lock_guard<std::mutex> lg(requests_lock);
+    steady_clock::time_point now = steady_clock::now();
+
+    expire(now, MAX_REQUESTS);
+    auto it = requests.find(request_id);
+    if (it != requests.end())
+        return it->second.snapshot;
+
+    expire(now, MAX_REQUESTS - 1);
+    std::shared_ptr<const sc_request> snap(new sc_request());
+    requests[request_id] = { snap, now };
+    requests_taken++;
+
+    return snap;
+}
+
+sc_request::sc_request()
+    : m_lookups(0),
+      m_copied(false)
+{
+}
+
+void sc_request::clear()
+{
+    std::lock_guard<std::mutex> lg(requests_lock);
+
+    requests.clear();
+}
+
+uint64_t sc_request::taken()
+{
+    std::lock_guard<std::mutex> lg(requests_lock);
+
+    return requests_taken;
+}
+
+const sc_request::details_t* sc_request::find(const std::string &name) const
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    /* more than one interface looked up: the request walks the list */
+    if (!m_copied && m_lookups++ > 0)
+        copy();
+
+    auto it = m_names.find(name);
+    if (it != m_names.end())
+        return it->second;
+    if (m_copied)
+        return nullptr;
+
+    details_t details;
+    if (!interface_cache::instance().find(name, details))
+        return nullptr;
+
+    auto found = m_table.emplace(details.sw_if_index, details).first;
+    m_names.emplace(name, &found->second);
+
+    return &found->second;
+}
+
+const std::vector<const sc_request::details_t*>&
+sc_request::subinterfaces(uint32_t sw_if_index) const
+{
+    static const std::vector<const details_t*> none;
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    if (!m_copied)
+        copy();
+
+    auto it = m_subs.find(sw_if_index);
+
+    return it == m_subs.end() ? none : it->second;
+}
+
+void sc_request::copy() const
+{
+    m_copied = true;
+    if (interface_cache::instance().read(
+        [&](const interface_cache::table_t &table) {
+            /* the interfaces found already keep their details */
+            m_table.insert(table.begin(), table.end());
+        }) != VOM::rc_t::OK)
+        SRP_LOG_ERR_MSG("Fail reading interfaces from VPP");
+
+    m_names.reserve(m_table.size());
+    for (auto &it : m_table) {
+        const details_t &d = it.second;
+
+        m_names.emplace((const char *) d.interface_name, &d);
+        if (d.sup_sw_if_index != d.sw_if_index)
+            m_subs[d.sup_sw_if_index].push_back(&d);
+    }
+
+    for (auto &it : m_subs)
+        std::sort(it.second.begin(), it.second.end(),
+                  [](const details_t *a, const details_t *b) {
+                      return a->sub_id < b->sub_id;
+                  });
+}
+
+const if_counters_t* sc_request::counters(uint32_t sw_if_index) const
+{
+    std::call_once(m_counters_once, [this]() {
+        m_counters = interface_stats::instance().snapshot();
+    });
+
+    return m_counters ? m_counters->get(sw_if_index) : nullptr;
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SC_REQUEST_H__
+#define __SC_REQUEST_H__
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <vpp-oper/interface_cache.hpp>
+#include <vpp-oper/stats.hpp>
+
+/*
+ * Operational state of VPP as seen by one get request.
+ *
+ * sysrepo calls a dp-get callback once per list instance, e.g. once per
+ * interface for a get of the statistics of all interfaces, each time with
+ * the request_id of the get. The calls of a request share one snapshot: the
+ * interface table is copied once, on the second lookup or on a walk of
+ * sub-interfaces, a get of a single interface only looks it up, and the
+ * counters of all interfaces are read from the stats segment once on first
+ * use. A request costs one dump and one segment read whatever the number of
+ * instances, and its replies are consistent with each other.
+ *
+ * sysrepo does not tell when a request ends: a snapshot is dropped once TTL
+ * has elapsed since it was taken, or when MAX_REQUESTS newer requests have
+ * taken theirs.
+ */
+class sc_request {
+public:
+    typedef interface_cache::details_t details_t;
+
+    /* Lifetime of a snapshot */
+    static const std::chrono::milliseconds TTL;
+
+    /* Snapshots kept at most */
+    static const size_t MAX_REQUESTS = 16;
+
+    /* Snapshot of request_id, created by its first call */
+    static std::shared_ptr<const sc_request> get(uint64_t request_id);
+
+    /* Drop all snapshots, e.g. when VPP has restarted */
+    static void clear();
+
+    /* Number of snapshots taken since start */
+    static uint64_t taken();
+
+    /* Details of interface name, valid as long as the snapshot is. Null if
+     * it does not exist or the interfaces can not be read from VPP. */
+    const details_t* find(const std::string &name) const;
+
+    /* VPP sub-interfaces of interface sw_if_index, by sub_id. The whole
+     * interface table is read to find them. */
+    const std::vector<const details_t*>&
+    subinterfaces(uint32_t sw_if_index) const;
+
+    /* Counters of interface sw_if_index, null if they can not be read */
+    const if_counters_t* counters(uint32_t sw_if_index) const;
+
+private:
+    sc_request();
+
+    /* Copy the interface table, m_lock held */
+    void copy() const;
+
+    /* protects the interfaces, filled as they are looked up */
+    mutable std::mutex m_lock;
+    mutable size_t m_lookups;
+    mutable bool m_copied;
+    mutable interface_cache::table_t m_table;
+    mutable std::unordered_map<std::string, const details_t*> m_names;
+    /* by sw_if_index of their interface, once copied */
+    mutable std::unordered_map<uint32_t,
+                               std::vector<const details_t*>> m_subs;
+
+    /* read on first use, only some requests want them */
+    mutable std::once_flag m_counters_once;
+    mutable std::shared_ptr<const interface_stats::snapshot_t> m_counters;
+};
+
+#endif /* __SC_REQUEST_H__ */
@@ -0,0 +1,368 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sc_running.h"
+
+#include <algorithm>
+#include <chrono>
+#include <set>
+
+#include "sc_plugins.h"
+#include "sc_startup.h"
+#include "sc_transaction.h"
+
+using namespace std::chrono;
+
+/* Values being applied by the callbacks called from this thread */
+static thread_local const std::vector<sc_running::value_t> *replayed = nullptr;
+
+struct sc_change_iter_s {
+    /* iterator of sysrepo, null when values are replayed */
+    sr_change_iter_t *sr;
+    /* schema path the replayed values are under */
+    std::string path;
+    size_t pos;
+};
+
+/* xpath without its predicates, e.g. "/m:a/b[k='v']/c" -> "/m:a/b/c" */
+static std::string schema_path(const char *xpath)
+{
+    std::string path;
+    char quote = 0;
+    int depth = 0;
+
+    for (const char *c = xpath; *c; c++) {
+        if (quote) {
+            if (*c == quote)
+                quote = 0;
+        } else if (depth && (*c == '\'' || *c == '"')) {
+            quote = *c;
+        } else if (*c == '[') {
+            depth++;
+        } else if (*c == ']') {
+            depth--;
+        } else if (!depth) {
+            path += *c;
+        }
+    }
+
+    return path;
+}
+
+/* Return true if schema path is top or below it */
+static bool under(const std::string &path, const std::string &top)
+{
+    return path.compare(0, top.size(), top) == 0 &&
+           (path.size() == top.size() || path[top.size()] == '/');
+}
+
+/* Module of xpath, e.g. "ietf-interfaces" of "/ietf-interfaces:a/b" */
+static std::string module_of(const std::string &xpath)
+{
+    size_t colon = xpath.find(':');
+
+    if (xpath.empty() || xpath[0] != '/' || colon == std::string::npos)
+        return "";
+
+    return xpath.substr(1, colon - 1);
+}
+
+int sc_get_changes_iter(sr_session_ctx_t *session, const char *xpath,
+                        sc_change_iter_t **iter)
+{
+    sc_change_iter_t *it = new sc_change_iter_t();
+    int rc = SR_ERR_OK;
+
+    it->sr = nullptr;
+    it->pos = 0;
+    if (replayed)
+        it->path = schema_path(xpath);
+    else
+        rc = sr_get_changes_iter(session, xpath, &it->sr);
+
+    if (SR_ERR_OK != rc) {
+        sc_free_change_iter(it);
+        it = nullptr;
+    }
+    *iter = it;
+
+    return rc;
+}
+
+int sc_get_change_next(sr_session_ctx_t *session, sc_change_iter_t *iter,
+                       sr_change_oper_t *operation, sr_val_t **old_value,
+                       sr_val_t **new_value)
+{
+    if (!replayed)
+        return sr_get_change_next(session, iter->sr, operation, old_value,
+                                  new_value);
+
+    while (iter->pos < replayed->size()) {
+        const sc_running::value_t &v = (*replayed)[iter->pos++];
+
+        if (!under(v.path, iter->path))
+            continue;
+
+        *operation = SR_OP_CREATED;
+        *old_value = nullptr;
+
+        return sr_dup_val(v.val, new_value);
+    }
+
+    return SR_ERR_NOT_FOUND;
+}
+
+void sc_free_change_iter(sc_change_iter_t *iter)
+{
+    if (!iter)
+        return;
+
+    if (iter->sr)
+        sr_free_change_iter(iter->sr);
+    delete iter;
+}
+
+sc_running& sc_running::instance()
+{
+    static sc_running running;
+
+    return running;
+}
+
+sc_running::sc_running()
+    : m_session(nullptr),
+      m_modules(0),
+      m_subscribed(false),
+      m_pending(false),
+      m_stats()
+{
+}
+
+int sc_running::add(sr_session_ctx_t *session, const std::string &xpath,
+                    sr_subtree_change_cb callback, void *private_ctx,
+                    uint32_t priority, sr_subscr_options_t opts,
+                    sr_subscription_ctx_t **subscription)
+{
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        if (!m_subscribed) {
+            m_subscriptions.push_back({ xpath, callback, private_ctx,
+                                        priority, opts, subscription });
+            return SR_ERR_OK;
+        }
+    }
+
+    return sr_subtree_change_subscribe(session, xpath.c_str(), callback,
+                                       private_ctx, priority, opts,
+                                       subscription);
+}
+
+sc_running::stats_t sc_running::stats()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_stats;
+}
+
+int sc_running::read(sr_session_ctx_t *session, const std::string &module)
+{
+    std::string xpath = "/" + module + ":*//*";
+    sr_val_t *values = nullptr;
+    size_t cnt = 0;
+    int rc;
+
+    rc = sr_get_items(session, xpath.c_str(), &values, &cnt);
+    if (SR_ERR_NOT_FOUND == rc)
+        return SR_ERR_OK; //nothing configured
+    if (SR_ERR_OK != rc) {
+        SRP_LOG_ERR("Fail reading running datastore of %s: %s",
+                    module.c_str(), sr_strerror(rc));
+        return rc;
+    }
+
+    m_read.emplace_back(values, cnt);
+
+    return SR_ERR_OK;
+}
+
+int sc_running::read(sr_session_ctx_t *session)
+{
+    sc_startup::phase phase("running-read");
+    std::set<std::string> modules;
+    int rc = SR_ERR_OK;
+
+    m_session = session;
+    m_start = steady_clock::now();
+    for (auto &s : m_subscriptions)
+        modules.insert(module_of(s.xpath));
+    modules.erase("");
+    m_modules = modules.size();
+
+    /* state data of the modules are not wanted, nor their providers
+     * called */
+    sr_session_set_options(session, SR_SESS_CONFIG_ONLY);
+    for (auto &m : modules) {
+        rc = read(session, m);
+        if (SR_ERR_OK != rc)
+            break;
+    }
+    sr_session_set_options(session, SR_SESS_DEFAULT);
+
+    std::unique_lock<std::mutex> lk(m_lock);
+
+    m_stats.values = 0;
+    for (auto &r : m_read)
+        m_stats.values += r.second;
+    if (SR_ERR_OK == rc && m_stats.values) {
+        m_pending = true;
+    } else {
+        if (SR_ERR_OK != rc)
+            SRP_LOG_ERR("Running datastore left out: %s", sr_strerror(rc));
+        clear();
+    }
+
+    /* what is committed from now on is notified, not read */
+    m_subscribed = true;
+    lk.unlock();
+    for (auto &s : m_subscriptions) {
+        int r = sr_subtree_change_subscribe(session, s.xpath.c_str(),
+                                            s.callback, s.private_ctx,
+                                            s.priority, s.opts,
+                                            s.subscription);
+        if (SR_ERR_OK != r) {
+            SRP_LOG_ERR("Fail subscribing to %s: %s", s.xpath.c_str(),
+                        sr_strerror(r));
+            return r;
+        }
+    }
+
+    return SR_ERR_OK;
+}
+
+int sc_running::apply(stats_t &st)
+{
+    std::vector<const subscription_t*> subs, verified;
+    std::shared_ptr<sc_transaction> tx = sc_transaction::of(m_session);
+    int rc = SR_ERR_OK;
+
+    m_values.reserve(st.values);
+    for (auto &r : m_read) {
+        for (size_t i = 0; i < r.second; i++)
+            m_values.push_back({ schema_path(r.first[i].xpath), &r.first[i] });
+    }
+
+    for (auto &s : m_subscriptions) {
+        std::string path = schema_path(s.xpath.c_str());
+
+        for (auto &v : m_values) {
+            if (under(v.path, path)) {
+                subs.push_back(&s);
+                break;
+            }
+        }
+    }
+    /* in the order sysrepo calls them for a commit */
+    std::stable_sort(subs.begin(), subs.end(),
+                     [](const subscription_t *a, const subscription_t *b) {
+                         return a->priority > b->priority;
+                     });
+
+    replayed = &m_values;
+    for (auto s : subs) {
+        rc = s->callback(m_session, s->xpath.c_str(), SR_EV_VERIFY,
+                         s->private_ctx);
+        if (SR_ERR_OK != rc)
+            break;
+        verified.push_back(s);
+    }
+    st.callbacks = subs.size();
+    st.staged = tx->size();
+
+    if (SR_ERR_OK != rc) {
+        /* the callback that refused has aborted already */
+        for (auto s : verified)
+            s->callback(m_session, s->xpath.c_str(), SR_EV_ABORT,
+                        s->private_ctx);
+    } else {
+        for (auto s : subs) {
+            int r = s->callback(m_session, s->xpath.c_str(), SR_EV_APPLY,
+                                s->private_ctx);
+            if (SR_ERR_OK == rc)
+                rc = r;
+        }
+    }
+    /* nothing staged is left behind, whatever the callbacks did */
+    tx->abort();
+    replayed = nullptr;
+
+    return rc;
+}
+
+int sc_running::apply()
+{
+    stats_t st;
+    int rc;
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        if (!m_pending)
+            return SR_ERR_OK;
+        st = m_stats;
+    }
+
+    sc_startup::phase phase("running-config");
+    rc = apply(st);
+
+    if (SR_ERR_OK == rc)
+        SRP_LOG_INF("running datastore applied in %lld ms: %zu values of "
+                    "%zu modules, %zu changes staged",
+                    (long long) duration_cast<milliseconds>(
+                        steady_clock::now() - m_start).count(),
+                    st.values, m_modules, st.staged);
+    else
+        SRP_LOG_ERR("Fail applying running datastore: %s", sr_strerror(rc));
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        clear();
+        m_pending = false;
+        m_stats = st;
+    }
+    m_cond.notify_all();
+
+    return rc;
+}
+
+void sc_running::wait()
+{
+    /* apply() calls the callbacks itself */
+    if (replayed)
+        return;
+
+    std::unique_lock<std::mutex> lk(m_lock);
+    m_cond.wait(lk, [this]() { return !m_pending; });
+}
+
+void sc_running::clear()
+{
+    for (auto &r : m_read)
+        sr_free_values(r.first, r.second);
+    m_read.clear();
+    m_values.clear();
+}
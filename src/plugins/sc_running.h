@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SC_RUNNING_H__
+#define __SC_RUNNING_H__
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+extern "C" {
+    #include <sysrepo.h>
+}
+
+/*
+ * Changes iterator of the change callbacks, used by foreach_change().
+ *
+ * It iterates over the changes sysrepo hands out, except while the running
+ * datastore is applied by sc_running::apply(): the values read under xpath
+ * are then iterated as if a commit created them.
+ */
+typedef struct sc_change_iter_s sc_change_iter_t;
+
+/* Same as sr_get_changes_iter(), *iter is null on error */
+int sc_get_changes_iter(sr_session_ctx_t *session, const char *xpath,
+                        sc_change_iter_t **iter);
+
+/* Same as sr_get_change_next(), the values are the caller's to free */
+int sc_get_change_next(sr_session_ctx_t *session, sc_change_iter_t *iter,
+                       sr_change_oper_t *operation, sr_val_t **old_value,
+                       sr_val_t **new_value);
+
+/* Same as sr_free_change_iter(), iter can be null */
+void sc_free_change_iter(sc_change_iter_t *iter);
+
+/*
+ * Application of the running datastore at plugin start.
+ *
+ * Subscriptions do not ask sysrepo to replay the running datastore with
+ * SR_EV_ENABLED, which would call each callback with the configuration of
+ * its own subtree, one commit each. Instead, read() reads the whole
+ * configuration of each module subscribed to at once, before subscribing
+ * to its changes, so that what is committed from then on is not read too.
+ * apply() then calls the change callbacks with it as a single commit
+ * creating all of it, off the sysrepo thread: VPP objects of all models are
+ * staged in a sc_transaction of its own, pushed to VPP in one pass by the
+ * dispatcher workers once VPP is connected. The commits made meanwhile wait
+ * for apply() to be done, so that they apply on top of it.
+ */
+class sc_running {
+public:
+    /* Outcome of read() and apply() */
+    struct stats_t {
+        /* values read from sysrepo */
+        size_t values;
+        /* callbacks given some of them */
+        size_t callbacks;
+        /* changes staged for VPP */
+        size_t staged;
+    };
+
+    /* A value read, with its xpath without predicates */
+    struct value_t {
+        std::string path;
+        const sr_val_t *val;
+    };
+
+    static sc_running& instance();
+
+    /* Subscribe callback to the changes under xpath, as
+     * sr_subtree_change_subscribe() does, once the running datastore is
+     * read. Return a sysrepo error code. */
+    int add(sr_session_ctx_t *session, const std::string &xpath,
+            sr_subtree_change_cb callback, void *private_ctx,
+            uint32_t priority, sr_subscr_options_t opts,
+            sr_subscription_ctx_t **subscription);
+
+    /* Read the running datastore of the modules subscribed to, then
+     * subscribe to their changes. Return a sysrepo error code. */
+    int read(sr_session_ctx_t *session);
+
+    /* Apply what read() has read, once. Return a sysrepo error code. */
+    int apply();
+
+    /* Wait for apply() to be done if read() has read something, unless
+     * called by apply() itself */
+    void wait();
+
+    stats_t stats();
+
+private:
+    sc_running();
+
+    struct subscription_t {
+        std::string xpath;
+        sr_subtree_change_cb callback;
+        void *private_ctx;
+        uint32_t priority;
+        sr_subscr_options_t opts;
+        sr_subscription_ctx_t **subscription;
+    };
+
+    /* Read the configuration of module, append it to values */
+    int read(sr_session_ctx_t *session, const std::string &module);
+
+    /* Play the values read to the callbacks */
+    int apply(stats_t &st);
+
+    /* Forget the values read, m_lock held */
+    void clear();
+
+    /* subscriptions are all added before read(), which is called once */
+    std::vector<subscription_t> m_subscriptions;
+    /* session read() is called with, the one of the commit applied */
+    sr_session_ctx_t *m_session;
+    /* as returned by sr_get_items(), one array per module */
+    std::vector<std::pair<sr_val_t*, size_t>> m_read;
+    /* the values read with their schema path, built by apply() */
+    std::vector<value_t> m_values;
+    size_t m_modules;
+    std::chrono::steady_clock::time_point m_start;
+    /* protects the members below */
+    std::mutex m_lock;
+    std::condition_variable m_cond;
+    /* changes are subscribed to */
+    bool m_subscribed;
+    /* values read not applied yet */
+    bool m_pending;
+    stats_t m_stats;
+};
+
+#endif /* __SC_RUNNING_H__ */
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sc_startup.h"
+
+#include <algorithm>
+
+#include "sc_plugins.h"
+
+using namespace std::chrono;
+
+sc_startup::phase::phase(const std::string &name)
+    : m_name(name), m_start(steady_clock::now()), m_ended(false)
+{
+}
+
+void sc_startup::phase::end()
+{
+    if (m_ended)
+        return;
+
+    m_ended = true;
+    sc_startup::instance().record(m_name, m_start, steady_clock::now());
+}
+
+sc_startup& sc_startup::instance()
+{
+    static sc_startup startup;
+
+    return startup;
+}
+
+sc_startup::sc_startup()
+    : m_begin(steady_clock::now()), m_ready(false)
+{
+}
+
+void sc_startup::begin()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_begin = steady_clock::now();
+    m_ready = false;
+    m_phases.clear();
+}
+
+void sc_startup::record(const std::string &name, steady_clock::time_point start,
+                        steady_clock::time_point end)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+    phase_t p = { name, duration_cast<microseconds>(start - m_begin),
+                  duration_cast<microseconds>(end - start) };
+
+    SRP_LOG_INF("Startup phase %s took %lld us", name.c_str(),
+                (long long) p.duration.count());
+
+    m_phases.erase(std::remove_if(m_phases.begin(), m_phases.end(),
+                                  [&name](const phase_t &ph) {
+                                      return ph.name == name;
+                                  }), m_phases.end());
+    m_phases.push_back(p);
+    std::stable_sort(m_phases.begin(), m_phases.end(),
+                     [](const phase_t &a, const phase_t &b) {
+                         return a.start < b.start;
+                     });
+}
+
+void sc_startup::ready()
+{
+    steady_clock::time_point begin;
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        if (m_ready)
+            return;
+        m_ready = true;
+        begin = m_begin;
+    }
+
+    record("total", begin, steady_clock::now());
+}
+
+std::vector<sc_startup::phase_t> sc_startup::phases()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_phases;
+}
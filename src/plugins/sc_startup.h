@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SC_STARTUP_H__
+#define __SC_STARTUP_H__
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/*
+ * Durations of the phases of the plugin start: the work done in
+ * sr_plugin_init_cb, then what the connection thread does once VPP is
+ * connected. Each phase is logged as it ends and published in
+ * sweetcomb-stats. A phase run again, on a new connection to VPP, replaces
+ * the previous timing.
+ */
+class sc_startup {
+public:
+    struct phase_t {
+        std::string name;
+        /* since begin() */
+        std::chrono::microseconds start;
+        std::chrono::microseconds duration;
+    };
+
+    /* Times the phase from its construction to its end */
+    class phase {
+    public:
+        explicit phase(const std::string &name);
+        ~phase() { end(); }
+
+        /* End the phase before it goes out of scope */
+        void end();
+
+    private:
+        std::string m_name;
+        std::chrono::steady_clock::time_point m_start;
+        bool m_ended;
+    };
+
+    static sc_startup& instance();
+
+    /* Start of the plugin, phases are dated from it */
+    void begin();
+
+    /* Record a phase */
+    void record(const std::string &name,
+                std::chrono::steady_clock::time_point start,
+                std::chrono::steady_clock::time_point end);
+
+    /* VPP is programmed with the configuration: record phase total, once */
+    void ready();
+
+    /* Phases recorded, in start order */
+    std::vector<phase_t> phases();
+
+private:
+    sc_startup();
+
+    std::mutex m_lock;
+    std::chrono::steady_clock::time_point m_begin;
+    bool m_ready;
+    std::vector<phase_t> m_phases;
+};
+
+#endif /* __SC_STARTUP_H__ */
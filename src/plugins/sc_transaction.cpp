@@ -0,0 +1,490 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sc_transaction.h"
+#include "sc_connection.h"
+#include "sc_dispatcher.h"
+#include "sc_plugins.h"
+
+#include <vom/hw.hpp>
+
+#include <vpp-oper/hw_lock.hpp>
+#include <vpp-oper/interface.hpp>
+
+using VOM::HW;
+using VOM::OM;
+using VOM::rc_t;
+
+sc_transaction::queue_t& sc_transaction::queue()
+{
+    static queue_t q;
+
+    return q;
+}
+
+sc_transaction::sc_transaction(sr_session_ctx_t *session)
+    : m_session(session)
+{
+}
+
+std::shared_ptr<sc_transaction> sc_transaction::of(sr_session_ctx_t *session)
+{
+    queue_t &q = queue();
+    std::lock_guard<std::mutex> lg(q.lock);
+    std::shared_ptr<sc_transaction> &tx = q.open[session];
+
+    if (!tx)
+        tx.reset(new sc_transaction(session));
+
+    return tx;
+}
+
+void sc_transaction::close(batch_t &batch)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    std::swap(batch, m_staged);
+    m_staged.clear();
+
+    queue_t &q = queue();
+    std::lock_guard<std::mutex> ql(q.lock);
+    auto it = q.open.find(m_session);
+
+    /* a later commit of the same session has its own transaction */
+    if (it != q.open.end() && it->second.get() == this)
+        q.open.erase(it);
+}
+
+bool sc_transaction::batch_t::empty() const
+{
+    return writes.empty() && removes.empty() && on_commit.empty();
+}
+
+size_t sc_transaction::batch_t::size() const
+{
+    return writes.size() + removes.size();
+}
+
+void sc_transaction::batch_t::clear()
+{
+    writes.clear();
+    describes.clear();
+    removes.clear();
+    interfaces.clear();
+    on_commit.clear();
+    on_apply.clear();
+    shards.clear();
+}
+
+void sc_transaction::stage_write(const std::string &key, stage_t stage,
+                                 std::function<VOM::rc_t()> write,
+                                 describe_t describe,
+                                 const std::string &shard)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_staged.writes[entry_key_t(stage, key)] = write;
+    m_staged.describes[entry_key_t(stage, key)] = describe;
+    m_staged.shards.insert(shard.empty() ? key : shard);
+}
+
+void sc_transaction::program(const std::string &key, stage_t stage,
+                             std::function<VOM::rc_t()> f,
+                             describe_t describe, const std::string &shard)
+{
+    stage_write(key, stage, f, describe, shard);
+}
+
+void sc_transaction::write(const VOM::interface &itf, describe_t describe)
+{
+    std::shared_ptr<VOM::interface> i = std::make_shared<VOM::interface>(itf);
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_staged.interfaces[i->name()] = i;
+    }
+
+    stage_write(i->key(), STAGE_INTERFACE, [i]() {
+        return OM::write(i->key(), *i);
+    }, describe, i->name());
+}
+
+void sc_transaction::depends(const std::string &shard)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_staged.shards.insert(shard);
+}
+
+void sc_transaction::stage_remove(const std::string &key, stage_t stage,
+                                  std::function<VOM::rc_t()> remove,
+                                  const std::string &shard)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_staged.shards.insert(shard.empty() ? key : shard);
+
+    /* a removal cancels a write staged before, not one staged after */
+    m_staged.writes.erase(entry_key_t(stage, key));
+    m_staged.describes.erase(entry_key_t(stage, key));
+    m_staged.removes[entry_key_t(stage, key)] = remove;
+    if (STAGE_INTERFACE == stage)
+        m_staged.interfaces.erase(key);
+}
+
+void sc_transaction::remove(const std::string &key, stage_t stage,
+                           const std::string &shard)
+{
+    stage_remove(key, stage, nullptr, shard);
+}
+
+void sc_transaction::unprogram(const std::string &key, stage_t stage,
+                               std::function<VOM::rc_t()> f,
+                               const std::string &shard)
+{
+    stage_remove(key, stage, f, shard);
+}
+
+void sc_transaction::on_commit(std::function<void()> f)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_staged.on_commit.push_back(f);
+}
+
+void sc_transaction::on_apply(std::function<void()> f)
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    m_staged.on_apply.push_back(f);
+}
+
+std::shared_ptr<VOM::interface>
+sc_transaction::find_interface(const std::string &name)
+{
+    entry_key_t key(STAGE_INTERFACE, name);
+
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        auto it = m_staged.interfaces.find(name);
+        if (it != m_staged.interfaces.end())
+            return it->second;
+        if (m_staged.removes.count(key))
+            return nullptr;
+
+        queue_t &q = queue();
+        std::lock_guard<std::mutex> ql(q.lock);
+
+        /* latest queued commit first */
+        for (auto b = q.queued.rbegin(); b != q.queued.rend(); ++b) {
+            it = (*b)->interfaces.find(name);
+            if (it != (*b)->interfaces.end())
+                return it->second;
+            if ((*b)->removes.count(key))
+                return nullptr;
+        }
+    }
+
+    std::lock_guard<std::mutex> hw(hw_lock());
+
+    return VOM::interface::find(name);
+}
+
+int sc_transaction::write_admin_states(const batch_t &batch,
+                                       std::set<entry_key_t> &done)
+{
+    std::vector<std::shared_ptr<VOM::interface>> known;
+    admin_state_batch states;
+
+    {
+        queue_t &q = queue();
+        std::lock_guard<std::mutex> lg(q.lock);
+
+        /* written by a commit before, so VOM holds it under its key */
+        for (auto &i : batch.interfaces) {
+            entry_key_t key(STAGE_INTERFACE, i.second->key());
+
+            if (batch.writes.count(key) && q.committed.count(key))
+                known.push_back(i.second);
+        }
+    }
+
+    if (known.empty())
+        return SR_ERR_OK;
+
+    std::lock_guard<std::mutex> hw(hw_lock());
+    std::vector<std::pair<std::shared_ptr<VOM::interface>,
+                          std::shared_ptr<VOM::interface>>> changed;
+
+    for (auto &itf : known) {
+        std::shared_ptr<VOM::interface> vom =
+            VOM::interface::find(itf->key());
+
+        if (!vom || VOM::handle_t::INVALID == vom->handle())
+            continue;
+
+        done.insert(entry_key_t(STAGE_INTERFACE, itf->key()));
+        if (vom->admin_state() == itf->admin_state())
+            continue;
+
+        states.add(vom->handle().value(),
+                   VOM::interface::admin_state_t::UP == itf->admin_state());
+        changed.push_back(std::make_pair(vom, itf));
+    }
+
+    states.enqueue();
+    HW::write();
+
+    if (states.failed()) {
+        SRP_LOG_WRN("Fail setting the admin state of %zu of %zu interfaces, "
+                    "write them one by one", states.failed(), states.size());
+        for (auto &c : changed)
+            done.erase(entry_key_t(STAGE_INTERFACE, c.second->key()));
+        return SR_ERR_OPERATION_FAILED;
+    }
+
+    /* VOM keeps the state VPP has now, for a replay */
+    for (auto &c : changed)
+        c.first->set(c.second->admin_state());
+
+    return SR_ERR_OK;
+}
+
+int sc_transaction::apply(const std::shared_ptr<batch_t> &batch)
+{
+    std::set<entry_key_t> done;
+    std::vector<entry_key_t> failed;
+
+    SRP_LOG_INF("Commit %zu removals and %zu writes to VPP",
+                batch->removes.size(), batch->writes.size());
+
+    /* dependent objects first; one object at a time, so that reads and
+     * other workers get to VPP in between */
+    for (auto it = batch->removes.rbegin(); it != batch->removes.rend(); ++it) {
+        std::lock_guard<std::mutex> hw(hw_lock());
+
+        if (!it->second) {
+            OM::remove(it->first.second);
+        } else if (it->second() != rc_t::OK) {
+            SRP_LOG_ERR("Fail removing changes from VPP for: %s",
+                        it->first.second.c_str());
+            failed.push_back(it->first);
+        }
+    }
+
+    /* those the batch fails on are written one by one below */
+    write_admin_states(*batch, done);
+
+    for (auto &w : batch->writes) {
+        if (done.count(w.first))
+            continue;
+
+        std::lock_guard<std::mutex> hw(hw_lock());
+
+        if (w.second() != rc_t::OK) {
+            SRP_LOG_ERR("Fail writing changes to VPP for: %s",
+                        w.first.second.c_str());
+            failed.push_back(w.first);
+        }
+    }
+
+    {
+        queue_t &q = queue();
+        std::lock_guard<std::mutex> lg(q.lock);
+
+        for (auto &r : batch->removes)
+            q.committed.erase(r.first);
+        for (auto &d : batch->describes) {
+            if (d.second)
+                q.committed[d.first] = d.second;
+            else
+                q.committed.erase(d.first);
+        }
+
+        for (auto b = q.queued.begin(); b != q.queued.end(); ++b) {
+            if (*b == batch) {
+                q.queued.erase(b);
+                break;
+            }
+        }
+    }
+
+    for (auto &f : batch->on_commit)
+        f();
+
+    if (failed.empty())
+        return SR_ERR_OK;
+
+    repair(*batch, failed);
+
+    return SR_ERR_OPERATION_FAILED;
+}
+
+void sc_transaction::repair(const batch_t &batch,
+                            const std::vector<entry_key_t> &failed)
+{
+    queue_t &q = queue();
+    reconcile r;
+    size_t described = 0;
+    bool repaired = false;
+
+    /* removals have nothing to declare, they stay failed */
+    for (auto &k : failed) {
+        auto d = batch.describes.find(k);
+
+        if (d != batch.describes.end() && d->second) {
+            d->second(r);
+            described++;
+        }
+    }
+
+    /* if VPP is gone, the reconcile run once it is back repairs them */
+    if (described && sc_connection::instance().is_connected()) {
+        reconcile::result_t res = r.run();
+
+        repaired = (0 == res.failed);
+        SRP_LOG_INF("Repair of %zu failed changes by %s: %zu objects "
+                    "checked, %zu written, %zu failed", described,
+                    res.replayed ? "replay" : "difference", res.checked,
+                    res.written, res.failed);
+    }
+
+    std::lock_guard<std::mutex> lg(q.lock);
+
+    q.failures.failed += failed.size();
+    if (repaired)
+        q.failures.repaired += described;
+    q.failures.last = failed.back().second;
+}
+
+void sc_transaction::dispatch()
+{
+    queue_t &q = queue();
+    std::lock_guard<std::mutex> dl(q.dispatch_lock);
+    std::vector<std::shared_ptr<batch_t>> batches;
+
+    {
+        std::lock_guard<std::mutex> lg(q.lock);
+
+        for (auto &b : q.queued) {
+            if (!b->dispatched) {
+                b->dispatched = true;
+                batches.push_back(b);
+            }
+        }
+    }
+
+    /* sysrepo has no use for the result of a commit it applies: failures
+     * are counted and repaired by apply() */
+    for (auto &b : batches)
+        sc_dispatcher::instance().dispatch(b->shards, [b]() { apply(b); });
+}
+
+int sc_transaction::commit()
+{
+    std::shared_ptr<batch_t> batch = std::make_shared<batch_t>();
+
+    close(*batch);
+
+    for (auto &f : batch->on_apply)
+        f();
+
+    if (batch->empty())
+        return SR_ERR_OK;
+
+    {
+        queue_t &q = queue();
+        std::lock_guard<std::mutex> lg(q.lock);
+        q.queued.push_back(batch);
+    }
+
+    if (!sc_connection::instance().is_connected()) {
+        SRP_LOG_WRN("VPP not connected, defer %zu changes", batch->size());
+        return SR_ERR_OK;
+    }
+
+    dispatch();
+
+    return SR_ERR_OK;
+}
+
+int sc_transaction::flush()
+{
+    dispatch();
+
+    return SR_ERR_OK;
+}
+
+void sc_transaction::abort()
+{
+    batch_t batch;
+
+    close(batch);
+    SRP_LOG_DBG("Drop %zu staged changes", batch.size());
+}
+
+size_t sc_transaction::size()
+{
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    return m_staged.size();
+}
+
+void sc_transaction::describe(reconcile &r)
+{
+    queue_t &q = queue();
+    std::lock_guard<std::mutex> lg(q.lock);
+
+    for (auto &c : q.committed)
+        c.second(r);
+}
+
+sc_transaction::failures_t sc_transaction::failures()
+{
+    queue_t &q = queue();
+    std::lock_guard<std::mutex> lg(q.lock);
+
+    return q.failures;
+}
+
+size_t sc_transaction::deferred()
+{
+    queue_t &q = queue();
+    std::lock_guard<std::mutex> lg(q.lock);
+    size_t n = 0;
+
+    for (auto &b : q.queued) {
+        if (!b->dispatched)
+            n += b->size();
+    }
+
+    return n;
+}
+
+size_t sc_transaction::dispatched()
+{
+    queue_t &q = queue();
+    std::lock_guard<std::mutex> lg(q.lock);
+    size_t n = 0;
+
+    for (auto &b : q.queued) {
+        if (b->dispatched)
+            n += b->size();
+    }
+
+    return n;
+}
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SC_TRANSACTION_H__
+#define __SC_TRANSACTION_H__
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <vom/interface.hpp>
+#include <vom/om.hpp>
+
+#include <vpp-oper/reconcile.hpp>
+
+extern "C" {
+    #include <sysrepo.h>
+}
+
+/*
+ * A sysrepo commit as seen by VPP.
+ *
+ * Change callbacks of all models stage the VOM objects they build during
+ * SR_EV_VERIFY instead of writing them one by one. The first SR_EV_APPLY
+ * callback of the commit pushes everything to VPP in a single pass, ordered
+ * by stage, and SR_EV_ABORT drops it. An object staged twice under the same
+ * key is written once, with its last value.
+ *
+ * sysrepo calls the callbacks of one commit with the same session: the
+ * transaction of a commit is the one of its session, so that commits in
+ * progress and the running datastore applied at start each stage in their
+ * own and commit or abort only their own changes.
+ *
+ * VPP is programmed by the sc_dispatcher workers, so that the sysrepo
+ * thread is free to serve reads meanwhile: sysrepo ignores what SR_EV_APPLY
+ * callbacks return anyway, a commit VPP refuses is in the running datastore
+ * all the same. Changes that fail are counted by failures() instead, and
+ * repaired at once: the objects they declare to a reconcile are compared
+ * with VPP and programmed again. Those the repair fails on, and failed
+ * removals which it can not undo, stay reported until the reconcile run
+ * after VPP has restarted. Each object is staged in a shard, the interface
+ * it belongs to by default its key: a commit runs in order with the commits
+ * before it that share a shard with it, in parallel with the others.
+ * Programming itself is serialized by hw_lock(), one object at a time: the
+ * admin state of the interfaces VOM knows already is set with a single
+ * batch of pipelined requests per commit, as models programming many
+ * objects outside of VOM do with program().
+ *
+ * Commits applied while VPP is not connected are deferred, in order, until
+ * sc_connection has connected and calls flush().
+ *
+ * Each object written comes with a description of what VPP must have for
+ * it, kept as long as the object is, from which a reconcile is built after
+ * VPP has restarted.
+ */
+class sc_transaction {
+public:
+    /* Objects are written in increasing stage order and removed in
+     * decreasing stage order, so that dependencies exist first. */
+    enum stage_t {
+        STAGE_INTERFACE = 0,
+        STAGE_L3,
+        STAGE_NAT,
+    };
+
+    /* Declare to a reconcile what VPP must have for an object */
+    typedef std::function<void(reconcile&)> describe_t;
+
+    /* Changes VPP failed to be programmed with since start */
+    struct failures_t {
+        /* changes that failed */
+        uint64_t failed;
+        /* of them, programmed by the repair that followed */
+        uint64_t repaired;
+        /* key of the last change that failed, mostly its xpath */
+        std::string last;
+    };
+
+    /* Transaction of the commit session is called for, created on its
+     * first use and forgotten once committed or aborted */
+    static std::shared_ptr<sc_transaction> of(sr_session_ctx_t *session);
+
+    /* Stage obj to be written under key, in shard or in the key's one */
+    template <typename OBJ>
+    void write(const std::string &key, const OBJ &obj, stage_t stage,
+               describe_t describe = nullptr, const std::string &shard = "")
+    {
+        std::shared_ptr<OBJ> o = std::make_shared<OBJ>(obj);
+
+        stage_write(key, stage, [key, o]() {
+            return VOM::OM::write(key, *o);
+        }, describe, shard);
+    }
+
+    /* Stage f to program VPP itself under key, e.g. with a batch of
+     * requests. It is run in stage order with the objects written. */
+    void program(const std::string &key, stage_t stage,
+                 std::function<VOM::rc_t()> f, describe_t describe = nullptr,
+                 const std::string &shard = "");
+
+    /* Stage an interface, in its own shard, which can then be found by
+     * find_interface() */
+    void write(const VOM::interface &itf, describe_t describe = nullptr);
+
+    /* Order this commit after the ones before it in shard too, e.g. the
+     * shard of an interface that what it programs refers to */
+    void depends(const std::string &shard);
+
+    /* Stage removal of all objects written under key */
+    void remove(const std::string &key, stage_t stage,
+                const std::string &shard = "");
+
+    /* Stage f to remove from VPP what program() wrote outside of VOM. It
+     * is run with the removals, before the writes, e.g. before the
+     * removal of an interface what was programmed on it. */
+    void unprogram(const std::string &key, stage_t stage,
+                   std::function<VOM::rc_t()> f,
+                   const std::string &shard = "");
+
+    /* Run f once the staged changes have been pushed to VPP */
+    void on_commit(std::function<void()> f);
+
+    /* Run f on commit(), before VPP is programmed: for state the
+     * verification of the next commits depends on */
+    void on_apply(std::function<void()> f);
+
+    /* Return interface staged in this transaction or known by VOM */
+    std::shared_ptr<VOM::interface> find_interface(const std::string &name);
+
+    /* Hand all staged changes to the workers, or defer them if VPP is not
+     * connected. Return a sysrepo error code */
+    int commit();
+
+    /* Drop all staged changes */
+    void abort();
+
+    /* Number of staged changes */
+    size_t size();
+
+    /* Hand the deferred commits to the workers, return a sysrepo error
+     * code */
+    static int flush();
+
+    /* Number of changes deferred until VPP is connected */
+    static size_t deferred();
+
+    /* Number of changes handed to the workers and not pushed to VPP yet */
+    static size_t dispatched();
+
+    /* Declare all the objects committed to VPP */
+    static void describe(reconcile &r);
+
+    /* Changes VPP failed to be programmed with, and their repair */
+    static failures_t failures();
+
+private:
+    typedef std::pair<stage_t, std::string> entry_key_t;
+
+    /* Changes of one commit */
+    struct batch_t {
+        std::map<entry_key_t, std::function<VOM::rc_t()>> writes;
+        std::map<entry_key_t, describe_t> describes;
+        /* removed by OM::remove() if null */
+        std::map<entry_key_t, std::function<VOM::rc_t()>> removes;
+        std::map<std::string, std::shared_ptr<VOM::interface>> interfaces;
+        std::vector<std::function<void()>> on_commit;
+        std::vector<std::function<void()>> on_apply;
+        std::set<std::string> shards;
+        /* handed to the workers */
+        bool dispatched = false;
+
+        bool empty() const;
+        size_t size() const;
+        void clear();
+    };
+
+    /* Commits of all transactions */
+    struct queue_t {
+        /* protects all but dispatch_lock */
+        std::mutex lock;
+        /* transactions staging, by session */
+        std::map<sr_session_ctx_t*, std::shared_ptr<sc_transaction>> open;
+        /* committed and not pushed to VPP yet, in commit order */
+        std::deque<std::shared_ptr<batch_t>> queued;
+        std::map<entry_key_t, describe_t> committed;
+        failures_t failures = { 0, 0, "" };
+        /* keeps batches handed to the workers in commit order */
+        std::mutex dispatch_lock;
+    };
+
+    explicit sc_transaction(sr_session_ctx_t *session);
+
+    static queue_t& queue();
+
+    void stage_write(const std::string &key, stage_t stage,
+                     std::function<VOM::rc_t()> write, describe_t describe,
+                     const std::string &shard);
+
+    void stage_remove(const std::string &key, stage_t stage,
+                      std::function<VOM::rc_t()> remove,
+                      const std::string &shard);
+
+    /* Set the admin state of the interfaces of batch VOM knows with one
+     * batch, return the keys of those it took care of; none if the batch
+     * failed, so that they are written one by one */
+    static int write_admin_states(const batch_t &batch,
+                                  std::set<entry_key_t> &done);
+
+    /* Take the staged changes and forget the transaction */
+    void close(batch_t &batch);
+
+    /* Push one batch to VPP, then forget it */
+    static int apply(const std::shared_ptr<batch_t> &batch);
+
+    /* Count the changes of batch that failed, and program again what
+     * they declare */
+    static void repair(const batch_t &batch,
+                       const std::vector<entry_key_t> &failed);
+
+    /* Hand the batches not handed yet to the workers, in commit order */
+    static void dispatch();
+
+    sr_session_ctx_t * const m_session;
+    /* protects m_staged, taken before the queue lock */
+    std::mutex m_lock;
+    batch_t m_staged;
+};
+
+#endif /* __SC_TRANSACTION_H__ */
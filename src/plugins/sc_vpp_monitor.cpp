@@ -0,0 +1,180 @@
+/*
+ * Copyright (c) 2018 HUACHENTEL and/or its affiliates.
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sc_vpp_monitor.h"
+#include "sc_plugins.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define _DIRENT_NAME 256
+#define CMDLINE_MAX _DIRENT_NAME + 15
+
+static const char *basename_of(const char *path)
+{
+    const char *slash = strrchr(path, '/');
+
+    return slash ? slash + 1 : path;
+}
+
+sc_vpp_monitor::sc_vpp_monitor(const std::string &cmd)
+    : m_cmd(cmd), m_pid(-1), m_fd(-1), m_pidfd(false)
+{
+}
+
+sc_vpp_monitor::~sc_vpp_monitor()
+{
+    detach();
+}
+
+/**
+ * @brief get one pid of any running process of cmd.
+ * @return Return pid or -ESRCH value if process was not found
+ */
+int sc_vpp_monitor::find(const std::string &cmd)
+{
+    DIR *dir = NULL;
+    struct dirent *ptr = NULL;
+    FILE *fp = NULL;
+    char filepath[CMDLINE_MAX];
+    char filetext[CMDLINE_MAX];
+    char *first = NULL;
+    size_t cnt;
+
+    dir = opendir("/proc");
+    if (dir == NULL)
+        return -errno;
+
+    errno = 0;
+
+    /* read process cmdline in proc, return pid of cmd */
+    while (NULL != (ptr = readdir(dir)))
+    {
+        if (DT_DIR != ptr->d_type || ptr->d_name[0] < '0' ||
+            ptr->d_name[0] > '9')
+            continue;
+
+        /* Open cmdline of PID */
+        snprintf(filepath, CMDLINE_MAX, "/proc/%s/cmdline", ptr->d_name);
+        fp = fopen(filepath, "r");
+        if (fp == NULL)
+            continue;
+
+        /* Read argv[0], the string written before the first '\0' */
+        cnt = fread(filetext, sizeof(char), sizeof(filetext) - 1, fp);
+        fclose(fp); // we assume fclose don't fail
+        if (cnt == 0)
+            continue;
+        filetext[cnt] = '\0';
+
+        /* retrieve string before first space */
+        first = strtok(filetext, " ");
+        if (first == NULL) //unmet space delimiter
+            continue;
+
+        /* One process has been found */
+        if (cmd == first ||
+            !strcmp(basename_of(first), basename_of(cmd.c_str()))) {
+            closedir(dir);
+            return atoi(ptr->d_name);
+        }
+
+        errno = 0; //to distinguish readdir() error from end of dir
+    }
+
+    if (errno != 0) { //this means an error has occured in readir
+        int err = errno;
+        SRP_LOG_ERR("readir errno %d", err);
+        closedir(dir);
+        return -err;
+    }
+
+    closedir(dir);
+
+    return -ESRCH;
+}
+
+int sc_vpp_monitor::attach()
+{
+    char path[CMDLINE_MAX];
+    int pid, fd = -1;
+
+    detach();
+
+    pid = find(m_cmd);
+    if (pid < 0)
+        return pid;
+
+#ifdef SYS_pidfd_open
+    fd = syscall(SYS_pidfd_open, pid, 0);
+    m_pidfd = (fd >= 0);
+#endif
+
+    /* Kernel without pidfd: an open /proc/<pid> directory stays bound to
+     * the process it was opened for, lookups in it fail once it is gone. */
+    if (fd < 0) {
+        snprintf(path, sizeof(path), "/proc/%d", pid);
+        fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd < 0)
+            return -errno;
+    }
+
+    m_pid = pid;
+    m_fd = fd;
+
+    SRP_LOG_DBG("Watching %s pid %d", m_cmd.c_str(), m_pid);
+
+    return m_pid;
+}
+
+void sc_vpp_monitor::detach()
+{
+    if (m_fd >= 0)
+        close(m_fd);
+
+    m_fd = -1;
+    m_pid = -1;
+    m_pidfd = false;
+}
+
+bool sc_vpp_monitor::alive()
+{
+    struct pollfd pfd;
+    int rc;
+
+    if (m_fd < 0)
+        return false;
+
+    if (!m_pidfd)
+        return faccessat(m_fd, "stat", F_OK, 0) == 0;
+
+    /* a pidfd becomes readable when its process exits */
+    pfd.fd = m_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    do {
+        rc = poll(&pfd, 1, 0);
+    } while (rc < 0 && errno == EINTR);
+
+    return rc == 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef __SC_VPP_MONITOR_H__
+#define __SC_VPP_MONITOR_H__
+
+#include <string>
+
+#define VPP_FULL_PATH "/usr/bin/vpp"
+
+/*
+ * Liveness of the VPP process.
+ *
+ * The process is searched in /proc only when none is watched. Once found, it
+ * is watched through a handle bound to it: a pidfd, or its /proc directory on
+ * kernels without pidfd. Checking it is then a single syscall, and a new
+ * process reusing the pid is never mistaken for the one watched.
+ */
+class sc_vpp_monitor {
+public:
+    /* Watch processes whose command is cmd or has the same basename */
+    explicit sc_vpp_monitor(const std::string &cmd = VPP_FULL_PATH);
+    ~sc_vpp_monitor();
+
+    /* Find a running process and watch it, return its pid or -errno */
+    int attach();
+
+    /* Stop watching the process */
+    void detach();
+
+    /* Return true if the watched process is still running */
+    bool alive();
+
+    /* pid of the watched process, -1 if none */
+    int pid() const { return m_pid; }
+
+    /* Scan /proc for a process running cmd, return its pid or -errno */
+    static int find(const std::string &cmd);
+
+private:
+    std::string m_cmd;
+    int m_pid;
+    int m_fd;
+    bool m_pidfd;
+};
+
+#endif /* __SC_VPP_MONITOR_H__ */
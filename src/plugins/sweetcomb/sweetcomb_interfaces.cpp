@@ -0,0 +1,635 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* This file implements sweetcomb-interfaces: the VPP interface events kept
+ * by the interface cache and the interface counters are pushed as sysrepo
+ * notifications, so that clients learn about a link going down or follow
+ * the counters without polling interfaces-state. */
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <vpp-oper/interface_cache.hpp>
+#include <vpp-oper/stats.hpp>
+
+#include "sc_interfaces.h"
+#include "sc_latency.h"
+#include "sc_plugins.h"
+#include "sc_running.h"
+#include "sys_util.h"
+
+using namespace std::chrono;
+
+#define STATE_CHANGE_XPATH "/sweetcomb-interfaces:interface-state-change"
+#define COUNTERS_XPATH "/sweetcomb-interfaces:interface-counters"
+
+/* Send a notification, from the threads of this file, which share the
+ * plugin session */
+static int
+notif_send(sr_session_ctx_t *session, const char *xpath, sr_val_t *val,
+           size_t cnt)
+{
+    static std::mutex session_lock;
+    std::lock_guard<std::mutex> lg(session_lock);
+
+    return sr_event_notif_send(session, xpath, val, cnt, SR_EV_NOTIF_DEFAULT);
+}
+
+/*
+ * Sender of interface-state-change, off the VAPI RX thread which reports
+ * the changes. The first change of an interface is held for the debounce
+ * time, the changes that follow meanwhile only update it, so that a
+ * flapping link costs one notification per debounce time rather than one
+ * per event.
+ */
+class state_notifier {
+public:
+    static const uint32_t DEFAULT_DEBOUNCE = 200; //ms
+
+    static state_notifier& instance()
+    {
+        static state_notifier n;
+
+        return n;
+    }
+
+    void start(sr_session_ctx_t *session)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        if (m_running)
+            return;
+        m_session = session;
+        m_running = true;
+        m_thread = std::thread(&state_notifier::run, this);
+    }
+
+    /* Drop the changes not sent yet and join the thread */
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lg(m_lock);
+
+            if (!m_running)
+                return;
+            m_running = false;
+            m_pending.clear();
+            m_cond.notify_all();
+        }
+        m_thread.join();
+    }
+
+    void configure(bool enabled, uint32_t debounce)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        m_enabled = enabled;
+        m_debounce = milliseconds(debounce);
+        if (!enabled)
+            m_pending.clear();
+    }
+
+    /* Called by the interface cache */
+    void change(const interface_cache::details_t &before,
+                const interface_cache::details_t &after)
+    {
+        sc_interfaces::state was(before), is(after);
+        bool admin = is.admin_up();
+        bool oper = is.oper_up();
+        uint32_t transitions =
+            (admin != was.admin_up()) + (oper != was.oper_up());
+
+        if (0 == transitions)
+            return;
+
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        if (!m_running || !m_enabled)
+            return;
+
+        auto r = m_pending.emplace(after.sw_if_index, pending_t());
+        pending_t &p = r.first->second;
+
+        if (r.second) {
+            p.name = after.interface_name;
+            p.due = steady_clock::now() + m_debounce;
+            p.transitions = 0;
+            m_cond.notify_all();
+        }
+
+        p.admin = admin;
+        p.oper = oper;
+        p.transitions += transitions;
+    }
+
+private:
+    struct pending_t {
+        std::string name;
+        bool admin;
+        bool oper;
+        uint32_t transitions;
+        steady_clock::time_point due;
+    };
+
+    state_notifier()
+        : m_session(nullptr), m_running(false), m_enabled(true),
+          m_debounce(DEFAULT_DEBOUNCE)
+    {
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lk(m_lock);
+
+        while (m_running) {
+            steady_clock::time_point now = steady_clock::now();
+            steady_clock::time_point next = steady_clock::time_point::max();
+            std::vector<pending_t> due;
+
+            for (auto it = m_pending.begin(); it != m_pending.end();) {
+                if (it->second.due <= now) {
+                    due.push_back(it->second);
+                    it = m_pending.erase(it);
+                } else {
+                    next = std::min(next, it->second.due);
+                    ++it;
+                }
+            }
+
+            if (!due.empty()) {
+                /* changes coming meanwhile start new notifications */
+                lk.unlock();
+                for (auto &p : due)
+                    send(p);
+                lk.lock();
+                continue;
+            }
+
+            if (next == steady_clock::time_point::max())
+                m_cond.wait(lk);
+            else
+                m_cond.wait_until(lk, next);
+        }
+    }
+
+    void send(const pending_t &p)
+    {
+        sr_val_t *val = nullptr;
+        int rc;
+
+        rc = sr_new_values(4, &val);
+        if (SR_ERR_OK != rc)
+            return;
+
+        sr_val_set_xpath(&val[0], STATE_CHANGE_XPATH "/name");
+        sr_val_set_str_data(&val[0], SR_STRING_T, p.name.c_str());
+        sr_val_set_xpath(&val[1], STATE_CHANGE_XPATH "/admin-status");
+        sr_val_set_str_data(&val[1], SR_ENUM_T, p.admin ? "up" : "down");
+        sr_val_set_xpath(&val[2], STATE_CHANGE_XPATH "/oper-status");
+        sr_val_set_str_data(&val[2], SR_ENUM_T, p.oper ? "up" : "down");
+        sr_val_set_xpath(&val[3], STATE_CHANGE_XPATH "/transitions");
+        val[3].type = SR_UINT32_T;
+        val[3].data.uint32_val = p.transitions;
+
+        rc = notif_send(m_session, STATE_CHANGE_XPATH, val, 4);
+        if (SR_ERR_OK != rc)
+            SRP_LOG_WRN("fail sending state change of %s: %s",
+                        p.name.c_str(), sr_strerror(rc));
+
+        sr_free_values(val, 4);
+    }
+
+    sr_session_ctx_t *m_session;
+    std::mutex m_lock;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+    bool m_running;
+    bool m_enabled;
+    milliseconds m_debounce;
+    /* by sw_if_index */
+    std::map<uint32_t, pending_t> m_pending;
+};
+
+/*
+ * Sender of interface-counters: every interval, the counters of all the
+ * interfaces are read in one snapshot of the stats segment and sent in one
+ * notification, instead of a collector getting the statistics of each
+ * interface. In changed-only mode, the counters equal to the previous
+ * sample are left out, and nothing is sent if none changed.
+ */
+class counters_telemetry {
+public:
+    struct stats_t {
+        uint64_t samples;
+        uint64_t sent;
+        microseconds last_sample;
+    };
+
+    static counters_telemetry& instance()
+    {
+        static counters_telemetry t;
+
+        return t;
+    }
+
+    void start(sr_session_ctx_t *session)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        if (m_running)
+            return;
+        m_session = session;
+        m_running = true;
+        m_thread = std::thread(&counters_telemetry::run, this);
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lg(m_lock);
+
+            if (!m_running)
+                return;
+            m_running = false;
+            m_cond.notify_all();
+        }
+        m_thread.join();
+    }
+
+    /* interval 0 stops sampling */
+    void configure(uint32_t interval, bool changed_only)
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        m_interval = milliseconds(interval);
+        m_changed_only = changed_only;
+        /* the next changed-only sample is sent in full */
+        m_last.reset();
+        m_cond.notify_all();
+    }
+
+    stats_t stats()
+    {
+        std::lock_guard<std::mutex> lg(m_lock);
+
+        return m_stats;
+    }
+
+private:
+    counters_telemetry()
+        : m_session(nullptr), m_running(false), m_interval(0),
+          m_changed_only(false), m_stats()
+    {
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lk(m_lock);
+        steady_clock::time_point next = steady_clock::now();
+        milliseconds interval(0);
+
+        while (m_running) {
+            if (0 == m_interval.count()) {
+                m_cond.wait(lk);
+                continue;
+            }
+
+            /* a new interval starts from now */
+            if (m_interval != interval) {
+                interval = m_interval;
+                next = steady_clock::now() + interval;
+            }
+
+            if (steady_clock::now() < next) {
+                m_cond.wait_until(lk, next);
+                continue;
+            }
+
+            /* a slow sample skips the ticks it missed */
+            next += interval;
+            if (next < steady_clock::now())
+                next = steady_clock::now() + interval;
+
+            bool changed_only = m_changed_only;
+            std::shared_ptr<const interface_stats::snapshot_t> last = m_last;
+            lk.unlock();
+            sample(changed_only, last);
+            lk.lock();
+        }
+    }
+
+    void sample(bool changed_only,
+                std::shared_ptr<const interface_stats::snapshot_t> last)
+    {
+        std::shared_ptr<const interface_stats::snapshot_t> snap;
+        steady_clock::time_point start = steady_clock::now();
+        sr_val_t *val = nullptr;
+        size_t cnt = 0;
+        bool sent = false;
+        int rc;
+
+        snap = interface_stats::instance().snapshot(milliseconds(0));
+        if (!snap) {
+            SRP_LOG_WRN_MSG("fail reading VPP stats segment for telemetry");
+            return;
+        }
+
+        interface_cache::instance().read(
+            [&](const interface_cache::table_t &table) {
+                size_t vc = table.size() * COUNTERS;
+
+                if (0 != sr_new_values(vc, &val))
+                    return;
+
+                for (auto &it : table) {
+                    const if_counters_t *c = snap->get(it.first);
+                    const if_counters_t *prev =
+                        last ? last->get(it.first) : nullptr;
+                    uint64_t now[COUNTERS], before[COUNTERS];
+
+                    if (nullptr == c)
+                        continue;
+                    fold(*c, now);
+                    if (changed_only && prev)
+                        fold(*prev, before);
+
+                    m_path.entry(COUNTERS_XPATH "/interface", "name",
+                               it.second.interface_name);
+                    for (unsigned i = 0; i < COUNTERS; i++) {
+                        if (changed_only && prev && now[i] == before[i])
+                            continue;
+                        m_path.set(&val[cnt], counter_names[i]);
+                        val[cnt].type = SR_UINT64_T;
+                        val[cnt].data.uint64_val = now[i];
+                        cnt++;
+                    }
+                }
+            });
+
+        if (cnt) {
+            rc = notif_send(m_session, COUNTERS_XPATH, val, cnt);
+            if (SR_ERR_OK != rc)
+                SRP_LOG_WRN("fail sending interface counters: %s",
+                            sr_strerror(rc));
+            sent = (SR_ERR_OK == rc);
+        }
+        sr_free_values(val, cnt);
+
+        std::lock_guard<std::mutex> lg(m_lock);
+        m_last = snap;
+        m_stats.samples++;
+        m_stats.sent += sent;
+        m_stats.last_sample =
+            duration_cast<microseconds>(steady_clock::now() - start);
+    }
+
+    /* Leaves of interface-counters, as the ietf-interfaces statistics */
+    static const unsigned COUNTERS = 8;
+    static const char *counter_names[COUNTERS];
+
+    static void fold(const if_counters_t &c, uint64_t out[COUNTERS])
+    {
+        out[0] = c.rx.bytes;
+        out[1] = c.rx_unicast.packets;
+        out[2] = c.rx_broadcast.packets;
+        out[3] = c.rx_multicast.packets;
+        out[4] = c.tx.bytes;
+        out[5] = c.tx_unicast.packets;
+        out[6] = c.tx_broadcast.packets;
+        out[7] = c.tx_multicast.packets;
+    }
+
+    sr_session_ctx_t *m_session;
+    std::mutex m_lock;
+    std::condition_variable m_cond;
+    std::thread m_thread;
+    bool m_running;
+    milliseconds m_interval;
+    bool m_changed_only;
+    /* previous sample, for changed-only */
+    std::shared_ptr<const interface_stats::snapshot_t> m_last;
+    stats_t m_stats;
+    utils::xpath_builder m_path;
+};
+
+const char *counters_telemetry::counter_names[COUNTERS] = {
+    "in-octets", "in-unicast-pkts", "in-broadcast-pkts", "in-multicast-pkts",
+    "out-octets", "out-unicast-pkts", "out-broadcast-pkts",
+    "out-multicast-pkts"
+};
+
+/* Configuration of the notifications */
+struct notif_config_t {
+    bool enabled = true;
+    uint32_t debounce = state_notifier::DEFAULT_DEBOUNCE;
+    uint32_t interval = 0;
+    bool changed_only = false;
+};
+
+/* running_config is installed on SR_EV_APPLY of the commit that staged
+ * commit_config */
+static notif_config_t running_config, commit_config;
+
+/* Stage the leaves changed under xpath in commit_config */
+static int
+config_verify(sr_session_ctx_t *session, const char *xpath,
+              sr_notif_event_t event)
+{
+    const notif_config_t defaults;
+    sc_change_iter_t *iter = nullptr;
+    sr_val_t *old_val = nullptr;
+    sr_val_t *new_val = nullptr;
+    sr_change_oper_t op;
+    int rc;
+
+    rc = sc_get_changes_iter(session, xpath, &iter);
+    if (SR_ERR_OK != rc) {
+        sc_free_change_iter(iter);
+        SRP_LOG_ERR("Unable to retrieve change iterator: %s", sr_strerror(rc));
+        return SR_ERR_OPERATION_FAILED;
+    }
+
+    foreach_change (session, iter, op, old_val, new_val) {
+        /* a deleted leaf is back to its default */
+        const sr_val_t *v = (SR_OP_DELETED == op) ? nullptr : new_val;
+        const char *leaf = v ? v->xpath : old_val->xpath;
+
+        if (sr_xpath_node_name_eq(leaf, "enabled"))
+            commit_config.enabled = v ? v->data.bool_val : defaults.enabled;
+        else if (sr_xpath_node_name_eq(leaf, "debounce"))
+            commit_config.debounce = v ? v->data.uint32_val
+                                       : defaults.debounce;
+        else if (sr_xpath_node_name_eq(leaf, "interval"))
+            commit_config.interval = v ? v->data.uint32_val
+                                       : defaults.interval;
+        else if (sr_xpath_node_name_eq(leaf, "changed-only"))
+            commit_config.changed_only = v ? v->data.bool_val
+                                           : defaults.changed_only;
+
+        sr_free_val(old_val);
+        sr_free_val(new_val);
+    }
+
+    sc_free_change_iter(iter);
+
+    return SR_ERR_OK;
+}
+
+/*
+ * /sweetcomb-interfaces:state-change-notifications
+ * /sweetcomb-interfaces:counters-telemetry
+ * A commit changing both calls this for each, both stage the same
+ * commit_config.
+ */
+static int
+notifications_config_cb(sr_session_ctx_t *session, const char *xpath,
+                        sr_notif_event_t event, void *private_ctx)
+{
+    UNUSED(private_ctx);
+    static bool staged = false;
+
+    SRP_LOG_INF("In %s", __FUNCTION__);
+
+    switch (event) {
+    case SR_EV_VERIFY:
+        if (!staged)
+            commit_config = running_config;
+        staged = true;
+        return config_verify(session, xpath, event);
+    case SR_EV_APPLY:
+        /* the second subscriber of a commit finds it applied already */
+        if (staged) {
+            running_config = commit_config;
+            state_notifier::instance().configure(running_config.enabled,
+                                                 running_config.debounce);
+            counters_telemetry::instance().configure(
+                running_config.interval, running_config.changed_only);
+        }
+        staged = false;
+        return SR_ERR_OK;
+    case SR_EV_ABORT:
+        staged = false;
+        return SR_ERR_OK;
+    default:
+        return SR_ERR_OK;
+    }
+}
+
+/*
+ * /sweetcomb-interfaces:counters-telemetry-state
+ */
+static int
+counters_telemetry_state_cb(const char *xpath, sr_val_t **values,
+                            size_t *values_cnt, uint64_t request_id,
+                            const char *original_xpath, void *private_ctx)
+{
+    UNUSED(request_id); UNUSED(original_xpath); UNUSED(private_ctx);
+    counters_telemetry::stats_t stats = counters_telemetry::instance().stats();
+    const std::pair<const char*, uint64_t> counters[] = {
+        { "samples", stats.samples },
+        { "sent", stats.sent },
+        { "last-sample-time", (uint64_t) stats.last_sample.count() },
+    };
+    sr_val_t *val = nullptr;
+    int cnt = 0; //value counter
+    int rc;
+
+    SRP_LOG_INF("In %s", __FUNCTION__);
+
+    ARG_CHECK3(SR_ERR_INVAL_ARG, xpath, values, values_cnt);
+
+    rc = sr_new_values(3, &val);
+    if (0 != rc) {
+        *values = NULL;
+        *values_cnt = 0;
+        return SR_ERR_NOMEM;
+    }
+
+    for (auto &c : counters) {
+        sr_val_build_xpath(&val[cnt], "%s/%s", xpath, c.first);
+        val[cnt].type = SR_UINT64_T;
+        val[cnt].data.uint64_val = c.second;
+        cnt++;
+    }
+
+    *values = val;
+    *values_cnt = cnt;
+
+    return SR_ERR_OK;
+}
+
+int
+sweetcomb_interfaces_init(sc_plugin_main_t *pm)
+{
+    int rc = SR_ERR_OK;
+    SRP_LOG_DBG_MSG("Initializing sweetcomb-interfaces plugin.");
+
+    rc = sc_subtree_change_subscribe(pm->session,
+            "/sweetcomb-interfaces:state-change-notifications",
+            notifications_config_cb, NULL, 0,
+            SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    rc = sc_subtree_change_subscribe(pm->session,
+            "/sweetcomb-interfaces:counters-telemetry",
+            notifications_config_cb, NULL, 0,
+            SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    rc = sc_dp_get_items_subscribe(pm->session,
+            "/sweetcomb-interfaces:counters-telemetry-state",
+            counters_telemetry_state_cb, NULL,
+            SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    state_notifier::instance().start(pm->session);
+    counters_telemetry::instance().start(pm->session);
+    interface_cache::instance().on_change(
+        [](const interface_cache::details_t &before,
+           const interface_cache::details_t &after) {
+            state_notifier::instance().change(before, after);
+        });
+
+    SRP_LOG_DBG_MSG("sweetcomb-interfaces plugin initialized successfully.");
+    return SR_ERR_OK;
+
+error:
+    SRP_LOG_ERR("Error by initialization of sweetcomb-interfaces plugin. Error : %d", rc);
+    return rc;
+}
+
+void
+sweetcomb_interfaces_exit(__attribute__((unused)) sc_plugin_main_t *pm)
+{
+    interface_cache::instance().on_change(nullptr);
+    state_notifier::instance().stop();
+    counters_telemetry::instance().stop();
+}
+
+SC_INIT_FUNCTION(sweetcomb_interfaces_init);
+SC_EXIT_FUNCTION(sweetcomb_interfaces_exit);
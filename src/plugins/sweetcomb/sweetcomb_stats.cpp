@@ -0,0 +1,488 @@
+/*
+ * Copyright (c) 2019 Cisco and/or its affiliates.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/* This file implements the operational data of sweetcomb-stats, which
+ * describe the plugins themselves rather than VPP. */
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <vpp-oper/reconcile.hpp>
+
+#include "sc_connection.h"
+#include "sc_latency.h"
+#include "sc_plugins.h"
+#include "sc_startup.h"
+#include "sc_transaction.h"
+#include "sys_util.h"
+
+using namespace std::chrono;
+
+/* Leaves replied by vpp_connection_state_cb */
+static const std::vector<std::string> connection_leaves = {
+    "state", "attempts", "connects", "backoff", "connect-time", "uptime",
+    "deferred-changes", "dispatched-changes", "failed-changes",
+    "repaired-changes", "last-failure"
+};
+
+/*
+ * /sweetcomb-stats:vpp-connection
+ */
+static int
+vpp_connection_state_cb(const char *xpath, sr_val_t **values,
+                        size_t *values_cnt, uint64_t request_id,
+                        const char *original_xpath, void *private_ctx)
+{
+    UNUSED(request_id); UNUSED(private_ctx);
+    utils::xpath_filter filter(original_xpath, "vpp-connection",
+                               connection_leaves);
+    sc_connection::stats_t stats = sc_connection::instance().stats();
+    sc_transaction::failures_t failures = sc_transaction::failures();
+    sr_val_t *val = nullptr;
+    int vc = filter.count(connection_leaves); //expected number of answer
+    int cnt = 0; //value counter
+    int rc;
+
+    SRP_LOG_INF("In %s", __FUNCTION__);
+
+    ARG_CHECK3(SR_ERR_INVAL_ARG, xpath, values, values_cnt);
+
+    rc = sr_new_values(vc, &val);
+    if (0 != rc) {
+        rc = SR_ERR_NOMEM;
+        goto nothing_todo;
+    }
+
+    if (filter.wants("state")) {
+        sr_val_build_xpath(&val[cnt], "%s/state", xpath);
+        sr_val_set_str_data(&val[cnt], SR_ENUM_T,
+                            sc_connection::state_to_string(stats.state));
+        cnt++;
+    }
+
+    if (filter.wants("attempts")) {
+        sr_val_build_xpath(&val[cnt], "%s/attempts", xpath);
+        val[cnt].type = SR_UINT32_T;
+        val[cnt].data.uint32_val = stats.attempts;
+        cnt++;
+    }
+
+    if (filter.wants("connects")) {
+        sr_val_build_xpath(&val[cnt], "%s/connects", xpath);
+        val[cnt].type = SR_UINT32_T;
+        val[cnt].data.uint32_val = stats.connects;
+        cnt++;
+    }
+
+    if (filter.wants("backoff")) {
+        sr_val_build_xpath(&val[cnt], "%s/backoff", xpath);
+        val[cnt].type = SR_UINT32_T;
+        val[cnt].data.uint32_val = stats.backoff.count();
+        cnt++;
+    }
+
+    if (filter.wants("connect-time")) {
+        sr_val_build_xpath(&val[cnt], "%s/connect-time", xpath);
+        val[cnt].type = SR_UINT64_T;
+        val[cnt].data.uint64_val = stats.connect_time.count();
+        cnt++;
+    }
+
+    if (filter.wants("uptime")) {
+        sr_val_build_xpath(&val[cnt], "%s/uptime", xpath);
+        val[cnt].type = SR_UINT64_T;
+        val[cnt].data.uint64_val = 0;
+        if (sc_connection::STATE_CONNECTED == stats.state)
+            val[cnt].data.uint64_val = duration_cast<seconds>(
+                    steady_clock::now() - stats.connected_at).count();
+        cnt++;
+    }
+
+    if (filter.wants("deferred-changes")) {
+        sr_val_build_xpath(&val[cnt], "%s/deferred-changes", xpath);
+        val[cnt].type = SR_UINT32_T;
+        val[cnt].data.uint32_val = sc_transaction::deferred();
+        cnt++;
+    }
+
+    if (filter.wants("dispatched-changes")) {
+        sr_val_build_xpath(&val[cnt], "%s/dispatched-changes", xpath);
+        val[cnt].type = SR_UINT32_T;
+        val[cnt].data.uint32_val = sc_transaction::dispatched();
+        cnt++;
+    }
+
+    if (filter.wants("failed-changes")) {
+        sr_val_build_xpath(&val[cnt], "%s/failed-changes", xpath);
+        val[cnt].type = SR_UINT64_T;
+        val[cnt].data.uint64_val = failures.failed;
+        cnt++;
+    }
+
+    if (filter.wants("repaired-changes")) {
+        sr_val_build_xpath(&val[cnt], "%s/repaired-changes", xpath);
+        val[cnt].type = SR_UINT64_T;
+        val[cnt].data.uint64_val = failures.repaired;
+        cnt++;
+    }
+
+    /* left out until a change has failed */
+    if (filter.wants("last-failure") && !failures.last.empty()) {
+        sr_val_build_xpath(&val[cnt], "%s/last-failure", xpath);
+        sr_val_set_str_data(&val[cnt], SR_STRING_T, failures.last.c_str());
+        cnt++;
+    }
+
+    *values = val;
+    *values_cnt = cnt;
+
+    return SR_ERR_OK;
+
+nothing_todo:
+    *values = NULL;
+    *values_cnt = 0;
+    return rc;
+}
+
+/* Leaves replied by reconcile_state_cb */
+static const std::vector<std::string> reconcile_leaves = {
+    "method", "checked", "written", "failed", "duration"
+};
+
+/*
+ * /sweetcomb-stats:reconcile
+ */
+static int
+reconcile_state_cb(const char *xpath, sr_val_t **values, size_t *values_cnt,
+                   uint64_t request_id, const char *original_xpath,
+                   void *private_ctx)
+{
+    UNUSED(request_id); UNUSED(private_ctx);
+    utils::xpath_filter filter(original_xpath, "reconcile", reconcile_leaves);
+    reconcile::result_t res = reconcile::last();
+    const std::pair<const char*, uint64_t> counters[] = {
+        { "checked", res.checked },
+        { "written", res.written },
+        { "failed", res.failed },
+        { "duration", (uint64_t) res.duration.count() },
+    };
+    sr_val_t *val = nullptr;
+    int vc = filter.count(reconcile_leaves); //expected number of answer
+    int cnt = 0; //value counter
+    int rc;
+
+    SRP_LOG_INF("In %s", __FUNCTION__);
+
+    ARG_CHECK3(SR_ERR_INVAL_ARG, xpath, values, values_cnt);
+
+    /* VPP has not restarted yet */
+    if (0 == res.checked) {
+        *values = NULL;
+        *values_cnt = 0;
+        return SR_ERR_OK;
+    }
+
+    rc = sr_new_values(vc, &val);
+    if (0 != rc) {
+        rc = SR_ERR_NOMEM;
+        goto nothing_todo;
+    }
+
+    if (filter.wants("method")) {
+        sr_val_build_xpath(&val[cnt], "%s/method", xpath);
+        sr_val_set_str_data(&val[cnt], SR_ENUM_T,
+                            res.replayed ? "replay" : "difference");
+        cnt++;
+    }
+
+    for (auto &c : counters) {
+        if (!filter.wants(c.first))
+            continue;
+        sr_val_build_xpath(&val[cnt], "%s/%s", xpath, c.first);
+        val[cnt].type = SR_UINT64_T;
+        val[cnt].data.uint64_val = c.second;
+        cnt++;
+    }
+
+    *values = val;
+    *values_cnt = cnt;
+
+    return SR_ERR_OK;
+
+nothing_todo:
+    *values = NULL;
+    *values_cnt = 0;
+    return rc;
+}
+
+/* Leaves replied by callbacks_state_cb for each callback */
+static const std::vector<std::string> callback_leaves = {
+    "type", "calls", "errors", "mean", "p50", "p90", "p99", "max"
+};
+
+/* Fill val with the leaves of one callback selected by filter */
+static void
+callback_state_build(const char *xpath, const utils::xpath_filter &filter,
+                     const sc_latency::stats_t &st, sr_val_t *val, int &cnt)
+{
+    const std::pair<const char*, uint64_t> counters[] = {
+        { "calls", st.calls },
+        { "errors", st.errors },
+        { "mean", st.calls ? st.total / st.calls : 0 },
+        { "p50", st.percentile(0.50) },
+        { "p90", st.percentile(0.90) },
+        { "p99", st.percentile(0.99) },
+        { "max", st.max },
+    };
+
+    if (filter.wants("type")) {
+        sr_val_build_xpath(&val[cnt], "%s[xpath='%s']/type", xpath,
+                           st.xpath.c_str());
+        sr_val_set_str_data(&val[cnt], SR_ENUM_T,
+                            sc_latency::type_to_string(st.type));
+        cnt++;
+    }
+
+    for (auto &c : counters) {
+        if (!filter.wants(c.first))
+            continue;
+        sr_val_build_xpath(&val[cnt], "%s[xpath='%s']/%s", xpath,
+                           st.xpath.c_str(), c.first);
+        val[cnt].type = SR_UINT64_T;
+        val[cnt].data.uint64_val = c.second;
+        cnt++;
+    }
+}
+
+/* Fill val with the non-empty buckets of the histogram of one callback */
+static void
+callback_buckets_build(const char *xpath, const sc_latency::stats_t &st,
+                       sr_val_t *val, int &cnt)
+{
+    for (unsigned b = 0; b < sc_latency::BUCKETS; b++) {
+        if (0 == st.buckets[b])
+            continue;
+        sr_val_build_xpath(&val[cnt], "%s[le='%llu']/count", xpath,
+                           (unsigned long long) sc_latency::upper_bound(b));
+        val[cnt].type = SR_UINT64_T;
+        val[cnt].data.uint64_val = st.buckets[b];
+        cnt++;
+    }
+}
+
+/*
+ * /sweetcomb-stats:callbacks
+ * Called for the callback list, then for the bucket list of each callback.
+ */
+static int
+callbacks_state_cb(const char *xpath, sr_val_t **values, size_t *values_cnt,
+                   uint64_t request_id, const char *original_xpath,
+                   void *private_ctx)
+{
+    UNUSED(request_id); UNUSED(private_ctx);
+    utils::xpath_filter filter(original_xpath, "callback", callback_leaves);
+    std::vector<sc_latency::stats_t> all = sc_latency::instance().stats();
+    std::string key;
+    sr_val_t *val = nullptr;
+    size_t vc = 0; //expected number of answer
+    int cnt = 0; //value counter
+    int rc = SR_ERR_OK;
+
+    SRP_LOG_INF("In %s", __FUNCTION__);
+
+    ARG_CHECK3(SR_ERR_INVAL_ARG, xpath, values, values_cnt);
+
+    if (sr_xpath_node_name_eq(xpath, "bucket")) {
+        /* buckets of the callback named in xpath */
+        key = utils::xpath_filter(xpath, "callback").key("xpath");
+        auto it = std::find_if(all.begin(), all.end(),
+                               [&key](const sc_latency::stats_t &st) {
+                                   return st.xpath == key;
+                               });
+        if (it == all.end())
+            goto nothing_todo;
+
+        for (unsigned b = 0; b < sc_latency::BUCKETS; b++)
+            vc += (it->buckets[b] != 0);
+        if (0 == vc)
+            goto nothing_todo;
+
+        rc = sr_new_values(vc, &val);
+        if (0 != rc) {
+            rc = SR_ERR_NOMEM;
+            goto nothing_todo;
+        }
+
+        callback_buckets_build(xpath, *it, val, cnt);
+
+    } else if (sr_xpath_node_name_eq(xpath, "callback")) {
+        key = filter.key("xpath");
+        if (!key.empty())
+            all.erase(std::remove_if(all.begin(), all.end(),
+                                     [&key](const sc_latency::stats_t &st) {
+                                         return st.xpath != key;
+                                     }), all.end());
+
+        vc = all.size() * filter.count(callback_leaves);
+        if (0 == vc)
+            goto nothing_todo;
+
+        rc = sr_new_values(vc, &val);
+        if (0 != rc) {
+            rc = SR_ERR_NOMEM;
+            goto nothing_todo;
+        }
+
+        for (auto &st : all)
+            callback_state_build(xpath, filter, st, val, cnt);
+
+    } else {
+        goto nothing_todo; //no callback field specified
+    }
+
+    *values = val;
+    *values_cnt = cnt;
+
+    return SR_ERR_OK;
+
+nothing_todo:
+    *values = NULL;
+    *values_cnt = 0;
+    return rc;
+}
+
+/* Leaves replied by startup_state_cb for each phase */
+static const std::vector<std::string> phase_leaves = { "start", "duration" };
+
+/*
+ * /sweetcomb-stats:startup
+ */
+static int
+startup_state_cb(const char *xpath, sr_val_t **values, size_t *values_cnt,
+                 uint64_t request_id, const char *original_xpath,
+                 void *private_ctx)
+{
+    UNUSED(request_id); UNUSED(private_ctx);
+    utils::xpath_filter filter(original_xpath, "phase", phase_leaves);
+    std::vector<sc_startup::phase_t> phases = sc_startup::instance().phases();
+    std::string key = filter.key("name");
+    sr_val_t *val = nullptr;
+    size_t vc = 0; //expected number of answer
+    int cnt = 0; //value counter
+    int rc = SR_ERR_OK;
+
+    SRP_LOG_INF("In %s", __FUNCTION__);
+
+    ARG_CHECK3(SR_ERR_INVAL_ARG, xpath, values, values_cnt);
+
+    if (!sr_xpath_node_name_eq(xpath, "phase"))
+        goto nothing_todo; //no phase field specified
+
+    if (!key.empty())
+        phases.erase(std::remove_if(phases.begin(), phases.end(),
+                                    [&key](const sc_startup::phase_t &ph) {
+                                        return ph.name != key;
+                                    }), phases.end());
+
+    vc = phases.size() * filter.count(phase_leaves);
+    if (0 == vc)
+        goto nothing_todo;
+
+    rc = sr_new_values(vc, &val);
+    if (0 != rc) {
+        rc = SR_ERR_NOMEM;
+        goto nothing_todo;
+    }
+
+    for (auto &ph : phases) {
+        const std::pair<const char*, uint64_t> times[] = {
+            { "start", (uint64_t) ph.start.count() },
+            { "duration", (uint64_t) ph.duration.count() },
+        };
+
+        for (auto &t : times) {
+            if (!filter.wants(t.first))
+                continue;
+            sr_val_build_xpath(&val[cnt], "%s[name='%s']/%s", xpath,
+                               ph.name.c_str(), t.first);
+            val[cnt].type = SR_UINT64_T;
+            val[cnt].data.uint64_val = t.second;
+            cnt++;
+        }
+    }
+
+    *values = val;
+    *values_cnt = cnt;
+
+    return SR_ERR_OK;
+
+nothing_todo:
+    *values = NULL;
+    *values_cnt = 0;
+    return rc;
+}
+
+int
+sweetcomb_stats_init(sc_plugin_main_t *pm)
+{
+    int rc = SR_ERR_OK;
+    SRP_LOG_DBG_MSG("Initializing sweetcomb-stats plugin.");
+
+    rc = sr_dp_get_items_subscribe(pm->session, "/sweetcomb-stats:vpp-connection",
+                                   vpp_connection_state_cb, NULL,
+                                   SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    rc = sr_dp_get_items_subscribe(pm->session, "/sweetcomb-stats:reconcile",
+                                   reconcile_state_cb, NULL,
+                                   SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    rc = sr_dp_get_items_subscribe(pm->session, "/sweetcomb-stats:callbacks",
+                                   callbacks_state_cb, NULL,
+                                   SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    rc = sr_dp_get_items_subscribe(pm->session, "/sweetcomb-stats:startup",
+                                   startup_state_cb, NULL,
+                                   SR_SUBSCR_CTX_REUSE, &pm->subscription);
+    if (SR_ERR_OK != rc) {
+        goto error;
+    }
+
+    SRP_LOG_DBG_MSG("sweetcomb-stats plugin initialized successfully.");
+    return SR_ERR_OK;
+
+error:
+    SRP_LOG_ERR("Error by initialization of sweetcomb-stats plugin. Error : %d", rc);
+    return rc;
+}
+
+void
+sweetcomb_stats_exit(__attribute__((unused)) sc_plugin_main_t *pm)
+{
+}
+
+SC_INIT_FUNCTION(sweetcomb_stats_init);
+SC_EXIT_FUNCTION(sweetcomb_stats_exit);
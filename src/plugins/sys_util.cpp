@@ -1,61 +1,589 @@
 #include "sys_util.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace utils {
 
+/* Parse the dotted-quad IPv4 address of the n first characters of s */
+static bool parse_v4(const char *s, size_t n, uint8_t *bytes)
+{
+    unsigned octet = 0, digits = 0, cnt = 0;
+
+    for (size_t i = 0; i <= n; i++) {
+        if (i == n || s[i] == '.') {
+            if (digits == 0 || cnt == 4)
+                return false;
+            bytes[cnt++] = octet;
+            octet = 0;
+            digits = 0;
+        } else if (s[i] >= '0' && s[i] <= '9' && digits < 3) {
+            octet = octet * 10 + (s[i] - '0');
+            if (octet > 255)
+                return false;
+            digits++;
+        } else {
+            return false;
+        }
+    }
+
+    return cnt == 4;
+}
+
+/* Parse the IPv4 or IPv6 address of the n first characters of s */
+static bool parse_address(const char *s, size_t n, uint8_t *bytes,
+                          uint8_t &family)
+{
+    char buf[INET6_ADDRSTRLEN];
+
+    if (memchr(s, ':', n) == nullptr) {
+        family = AF_INET;
+        return parse_v4(s, n, bytes);
+    }
+
+    if (n >= sizeof(buf))
+        return false;
+    memcpy(buf, s, n);
+    buf[n] = '\0';
+    family = AF_INET6;
+
+    return inet_pton(AF_INET6, buf, bytes) == 1;
+}
+
+/* Write the decimal value of v at buf, return the length written */
+static size_t format_uint(char *buf, unsigned v)
+{
+    char digits[4];
+    size_t n = 0, len;
+
+    do {
+        digits[n++] = '0' + v % 10;
+        v /= 10;
+    } while (v != 0);
+
+    for (len = 0; n > 0; len++)
+        buf[len] = digits[--n];
+
+    return len;
+}
+
+int netmask_to_plen(const char *netmask)
+{
+    uint8_t bytes[16];
+    uint8_t family;
+    size_t size, i;
+    int len = 0;
+
+    if (netmask == nullptr ||
+        !parse_address(netmask, strlen(netmask), bytes, family))
+        return -1;
+
+    size = (family == AF_INET) ? 4 : 16;
+
+    for (i = 0; i < size && bytes[i] == 0xff; i++)
+        len += 8;
+
+    if (i < size) {
+        /* leading ones of the last byte which is not 0xff */
+        uint8_t ones = __builtin_clz((uint8_t) ~bytes[i]) - 24;
+
+        if ((uint8_t) (bytes[i] << ones) != 0)
+            return -1;
+        len += ones;
+
+        for (i++; i < size; i++)
+            if (bytes[i] != 0)
+                return -1;
+    }
+
+    return len;
+}
+
+const size_t prefix::STRLEN;
+
 prefix::prefix()
+    : m_family(AF_UNSPEC), m_len(0)
 {
+    memset(m_bytes, 0, sizeof(m_bytes));
 }
 
-prefix::prefix(const prefix &p)
+prefix::prefix(const boost::asio::ip::address &address, uint8_t len)
+    : prefix()
 {
-    m_address = p.address();
-    m_prefix_len = p.prefix_length();
+    if (address.is_v4() && len <= 32) {
+        auto b = address.to_v4().to_bytes();
+        memcpy(m_bytes, b.data(), b.size());
+        m_family = AF_INET;
+        m_len = len;
+    } else if (address.is_v6() && len <= 128) {
+        auto b = address.to_v6().to_bytes();
+        memcpy(m_bytes, b.data(), b.size());
+        m_family = AF_INET6;
+        m_len = len;
+    }
 }
 
-prefix::prefix(std::string p)
+bool prefix::parse(const char *str, prefix &p)
 {
-    size_t found = p.find_last_of('/');
+    const char *slash;
+    unsigned len = 0;
+    size_t i;
+
+    p = prefix();
+    if (str == nullptr || (slash = strchr(str, '/')) == nullptr)
+        return false;
+
+    for (i = 1; slash[i] >= '0' && slash[i] <= '9' && i <= 3; i++)
+        len = len * 10 + (slash[i] - '0');
+    if (i == 1 || slash[i] != '\0')
+        return false;
 
-    if (found == std::string::npos) //not found
-        throw std::runtime_error("missing '/' in " + p);
+    if (!parse_address(str, slash - str, p.m_bytes, p.m_family) ||
+        len > p.size() * 8) {
+        p = prefix();
+        return false;
+    }
+    p.m_len = len;
 
-    m_address = boost::asio::ip::address::from_string(p.substr(0, found));
-    m_prefix_len =  std::stoi(p.substr(found+1, p.length()));
+    return true;
 }
 
-prefix prefix::make_prefix(std::string str)
+bool prefix::parse(const char *address, uint8_t len, prefix &p)
 {
-    prefix tmp(str);
-    return prefix(tmp);
+    p = prefix();
+    if (address == nullptr ||
+        !parse_address(address, strlen(address), p.m_bytes, p.m_family) ||
+        len > p.size() * 8) {
+        p = prefix();
+        return false;
+    }
+    p.m_len = len;
+
+    return true;
 }
 
-unsigned short prefix::prefix_length() const
+prefix prefix::make_prefix(const std::string &str)
 {
-    return m_prefix_len;
+    prefix p;
+
+    if (!parse(str.c_str(), p))
+        throw std::runtime_error("invalid prefix " + str);
+
+    return p;
 }
 
-boost::asio::ip::address prefix::address() const
+size_t prefix::format(char *buf) const
 {
-    return m_address;
+    size_t n = 0;
+
+    if (m_family == AF_INET) {
+        for (int i = 0; i < 4; i++) {
+            if (i > 0)
+                buf[n++] = '.';
+            n += format_uint(buf + n, m_bytes[i]);
+        }
+    } else if (m_family == AF_INET6) {
+        if (inet_ntop(AF_INET6, m_bytes, buf, INET6_ADDRSTRLEN) == nullptr)
+            return 0;
+        n = strlen(buf);
+    } else {
+        buf[0] = '\0';
+        return 0;
+    }
+
+    buf[n++] = '/';
+    n += format_uint(buf + n, m_len);
+    buf[n] = '\0';
+
+    return n;
 }
 
 std::string prefix::to_string() const
 {
-    ostringstream os;
-    os << m_address << "/" << m_prefix_len;
-    return os.str();
+    char buf[STRLEN];
+    size_t n = format(buf);
+
+    return std::string(buf, n);
+}
+
+int prefix::family() const
+{
+    return m_family;
+}
+
+uint8_t prefix::prefix_length() const
+{
+    return m_len;
+}
+
+const uint8_t* prefix::bytes() const
+{
+    return m_bytes;
+}
+
+boost::asio::ip::address prefix::address() const
+{
+    if (m_family == AF_INET) {
+        boost::asio::ip::address_v4::bytes_type b;
+        memcpy(b.data(), m_bytes, b.size());
+        return boost::asio::ip::address_v4(b);
+    } else if (m_family == AF_INET6) {
+        boost::asio::ip::address_v6::bytes_type b;
+        memcpy(b.data(), m_bytes, b.size());
+        return boost::asio::ip::address_v6(b);
+    }
+
+    return boost::asio::ip::address();
+}
+
+prefix prefix::network() const
+{
+    prefix p(*this);
+    size_t i = m_len / 8;
+
+    if (i < p.size()) {
+        p.m_bytes[i] &= (uint8_t) (0xff00 >> (m_len % 8));
+        memset(p.m_bytes + i + 1, 0, p.size() - i - 1);
+    }
+
+    return p;
+}
+
+boost::asio::ip::address prefix::netmask() const
+{
+    prefix p(*this);
+
+    memset(p.m_bytes, 0xff, sizeof(p.m_bytes));
+
+    return p.network().address();
+}
+
+bool prefix::same_bits(const prefix &p, uint8_t len) const
+{
+    size_t i = len / 8;
+    uint8_t mask = 0xff00 >> (len % 8);
+
+    if (memcmp(m_bytes, p.m_bytes, i) != 0)
+        return false;
+
+    return (len % 8) == 0 || ((m_bytes[i] ^ p.m_bytes[i]) & mask) == 0;
+}
+
+bool prefix::contains(const prefix &p) const
+{
+    return !empty() && m_family == p.m_family && m_len <= p.m_len &&
+           same_bits(p, m_len);
+}
+
+bool prefix::overlaps(const prefix &p) const
+{
+    return !empty() && m_family == p.m_family &&
+           same_bits(p, std::min(m_len, p.m_len));
+}
+
+bool prefix::empty() const
+{
+    return m_family == AF_UNSPEC;
+}
+
+size_t prefix::size() const
+{
+    switch (m_family) {
+    case AF_INET:
+        return 4;
+    case AF_INET6:
+        return 16;
+    }
+
+    return 0;
+}
+
+bool prefix::operator==(const prefix &p) const
+{
+    return m_family == p.m_family && m_len == p.m_len &&
+           memcmp(m_bytes, p.m_bytes, size()) == 0;
+}
+
+bool prefix::operator!=(const prefix &p) const
+{
+    return !(*this == p);
+}
+
+bool prefix::operator<(const prefix &p) const
+{
+    int cmp;
+
+    if (m_family != p.m_family)
+        return m_family < p.m_family;
+
+    cmp = memcmp(m_bytes, p.m_bytes, size());
+    if (cmp != 0)
+        return cmp < 0;
+
+    return m_len < p.m_len;
+}
+
+size_t prefix::hash() const
+{
+    /* FNV-1a */
+    uint64_t h = 14695981039346656037ULL;
+    size_t n = size();
+
+    for (size_t i = 0; i < n; i++)
+        h = (h ^ m_bytes[i]) * 1099511628211ULL;
+    h = (h ^ m_family) * 1099511628211ULL;
+    h = (h ^ m_len) * 1099511628211ULL;
+
+    return h;
 }
 
 std::ostream& operator<<(std::ostream& os, const prefix& p)
 {
-    os << p.to_string();
+    char buf[prefix::STRLEN];
+
+    p.format(buf);
+    os << buf;
 
     return os;
 }
 
-bool prefix::empty() const
+xpath_filter::xpath_filter(const char *xpath, const std::string &node,
+                           const std::vector<std::string> &leaves)
+{
+    if (xpath == nullptr)
+        return;
+
+    std::string x(xpath);
+    size_t pos = std::string::npos;
+
+    /* Look for "/node" or "/module:node" followed by a predicate, a child
+     * or the end of the xpath */
+    for (size_t i = x.find(node); i != std::string::npos;
+         i = x.find(node, i + 1)) {
+        size_t end = i + node.length();
+        if (i == 0 || (x[i - 1] != '/' && x[i - 1] != ':'))
+            continue;
+        if (end < x.length() && x[end] != '[' && x[end] != '/')
+            continue;
+        pos = end;
+        break;
+    }
+    if (pos == std::string::npos)
+        return;
+
+    /* key predicates: [name='value'] or [name="value"] */
+    while (pos < x.length() && x[pos] == '[') {
+        size_t eq = x.find('=', pos);
+        if (eq == std::string::npos || eq + 1 >= x.length())
+            return;
+        char quote = x[eq + 1];
+        size_t close = x.find(quote, eq + 2);
+        if ((quote != '\'' && quote != '"') || close == std::string::npos)
+            return;
+        m_keys[x.substr(pos + 1, eq - pos - 1)] =
+            x.substr(eq + 2, close - eq - 2);
+        pos = x.find(']', close);
+        if (pos == std::string::npos)
+            return;
+        pos++;
+    }
+
+    /* node selected right below */
+    if (pos >= x.length() || x[pos] != '/')
+        return;
+    pos++;
+    size_t end = x.find_first_of("/[", pos);
+    m_selected = x.substr(pos, end == std::string::npos ? end : end - pos);
+    size_t colon = m_selected.find(':');
+    if (colon != std::string::npos)
+        m_selected.erase(0, colon + 1);
+
+    if (m_selected == "*")
+        m_selected.clear();
+
+    if (!leaves.empty() && count(leaves) == 0)
+        m_selected.clear();
+}
+
+std::string xpath_filter::key(const std::string &name) const
+{
+    auto it = m_keys.find(name);
+
+    if (it == m_keys.end())
+        return std::string();
+
+    return it->second;
+}
+
+const std::string& xpath_filter::selected() const
+{
+    return m_selected;
+}
+
+bool xpath_filter::wants(const std::string &leaf) const
+{
+    return m_selected.empty() || m_selected == leaf;
+}
+
+bool xpath_filter::wants(const char *leaf) const
+{
+    return m_selected.empty() || m_selected == leaf;
+}
+
+size_t xpath_filter::count(const std::vector<std::string> &leaves) const
+{
+    size_t n = 0;
+
+    for (auto &leaf : leaves)
+        if (wants(leaf))
+            n++;
+
+    return n;
+}
+
+xpath_builder::xpath_builder() : m_entry(0)
+{
+}
+
+void xpath_builder::entry(const char *path, const char *key,
+                          const char *value)
 {
-    return to_string().empty();
+    m_xpath.assign(path);
+    if (key != nullptr) {
+        m_xpath.append("[").append(key).append("='");
+        m_xpath.append(value).append("']");
+    }
+    m_entry = m_xpath.length();
+}
+
+const char* xpath_builder::leaf(const char *name)
+{
+    m_xpath.resize(m_entry);
+    m_xpath.append(1, '/').append(name);
+
+    return m_xpath.c_str();
+}
+
+int xpath_builder::set(sr_val_t *val, const char *name)
+{
+    return sr_val_set_xpath(val, leaf(name));
+}
+
+const size_t xpath_keys::MAX;
+
+std::string xpath_keys::value(size_t i) const
+{
+    if (i >= m_count)
+        return std::string();
+
+    return std::string(m_keys[i].value, m_keys[i].value_len);
+}
+
+std::string xpath_keys::value(const std::string &name) const
+{
+    for (size_t i = 0; i < m_count; i++) {
+        if (m_keys[i].name_len == name.length() &&
+            memcmp(m_keys[i].name, name.data(), name.length()) == 0)
+            return value(i);
+    }
+
+    return std::string();
+}
+
+const size_t schema_dispatch::NONE;
+
+schema_dispatch::schema_dispatch() : m_nodes(1)
+{
+    m_nodes[0].id = -1;
+}
+
+schema_dispatch::schema_dispatch(
+    std::initializer_list<std::pair<const char*, int>> nodes)
+    : schema_dispatch()
+{
+    for (auto &n : nodes)
+        add(n.first, n.second);
+}
+
+size_t schema_dispatch::child(size_t node, const char *name,
+                              size_t len) const
+{
+    /* a handful of children at most, a scan is the fastest */
+    for (auto &c : m_nodes[node].children) {
+        if (c.first.length() == len && memcmp(c.first.data(), name, len) == 0)
+            return c.second;
+    }
+
+    return NONE;
+}
+
+void schema_dispatch::add(const char *path, int id)
+{
+    size_t node = 0;
+    const char *p = path;
+
+    while (*p == '/') {
+        const char *name = ++p;
+
+        while (*p && *p != '/')
+            p++;
+
+        size_t next = child(node, name, p - name);
+        if (NONE == next) {
+            next = m_nodes.size();
+            m_nodes[node].children.emplace_back(std::string(name, p - name),
+                                                next);
+            m_nodes.emplace_back();
+            m_nodes[next].id = -1;
+        }
+        node = next;
+    }
+
+    m_nodes[node].id = id;
+}
+
+int schema_dispatch::match(const char *xpath, xpath_keys &keys) const
+{
+    size_t node = 0;
+    const char *p = xpath;
+
+    keys.m_count = 0;
+    if (nullptr == p)
+        return -1;
+
+    while (*p == '/') {
+        const char *name = ++p;
+
+        while (*p && *p != '/' && *p != '[')
+            p++;
+
+        node = child(node, name, p - name);
+        if (NONE == node)
+            return -1;
+
+        /* key predicates: [name='value'] or [name="value"] */
+        while (*p == '[') {
+            const char *key = ++p;
+            const char *eq = strchr(key, '=');
+            if (nullptr == eq || (eq[1] != '\'' && eq[1] != '"'))
+                return -1;
+            const char *value = eq + 2;
+            const char *close = strchr(value, eq[1]);
+            if (nullptr == close || close[1] != ']')
+                return -1;
+
+            if (keys.m_count < xpath_keys::MAX) {
+                xpath_keys::key_t &k = keys.m_keys[keys.m_count++];
+                k.name = key;
+                k.name_len = eq - key;
+                k.value = value;
+                k.value_len = close - value;
+            }
+            p = close + 2;
+        }
+    }
+
+    return *p ? -1 : m_nodes[node].id;
 }
 
 }
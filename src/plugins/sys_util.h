@@ -21,22 +21,28 @@
 //TODO: Add to only one header file
 extern "C" {
     #include <sysrepo.h>
+    #include <sysrepo/values.h>
     #include <sysrepo/xpath.h>
     #include <sysrepo/plugins.h>
 }
 
+#include <functional>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <map>
 #include <exception>
 #include <boost/asio.hpp>
 
+#include <arpa/inet.h>
+
 using namespace std;
 
 /* BEGIN sysrepo utils */
 
 #define foreach_change(ds, it, oper, old, newch) \
     while( (event != SR_EV_ABORT) && \
-            sr_get_change_next(ds, it, &oper, &old, &newch) == SR_ERR_OK)
+            sc_get_change_next(ds, it, &oper, &old, &newch) == SR_ERR_OK)
 
 #define XPATH_SIZE 2000
 
@@ -74,72 +80,214 @@ using namespace std;
 
 namespace utils {
 
-/* Convert netmask to prefix length.
- * 255.255.255.0->24
- */
-inline uint8_t netmask_to_plen(boost::asio::ip::address netmask)
-{
-    in_addr_t n = 0;
-    uint8_t i = 0;
-    int af;
-    int rc;
-
-    if (netmask.is_v4())
-        af = AF_INET;
-    else if (netmask.is_v6())
-        af = AF_INET6;
-    else
-        throw std::runtime_error("Invalid address family");
-
-    /* Convert address to binary form */
-    rc = inet_pton(af, netmask.to_string().c_str(), &n);
-    if (rc <= 0)
-        throw std::runtime_error("Fail converting netmask to prefix length");
-
-    while (n > 0) {
-        n = n >> 1;
-        i++;
-    }
-
-    return i;
-}
+/* Prefix length of a contiguous IPv4 or IPv6 netmask, e.g.
+ * "255.255.255.0" -> 24, "ffff:ffff::" -> 32.
+ * Return -1 if netmask is not an address or not contiguous. */
+int netmask_to_plen(const char *netmask);
 
+/* IPv4 or IPv6 prefix, e.g. "10.0.0.1/24", held in a fixed-size value:
+ * parsing and formatting do not allocate. The address keeps its host bits,
+ * as an interface address does, network() clears them. */
 class prefix {
 public:
-     /* Default Constructor */
+    /* Longest text of a prefix, with the terminating '\0' */
+    static const size_t STRLEN = INET6_ADDRSTRLEN + 4;
+
+    /* Empty prefix, of no family */
     prefix();
 
-    /* Copy constructor */
-    prefix(const prefix &p);
+    /* Prefix of address with length len, empty if len is too long */
+    prefix(const boost::asio::ip::address &address, uint8_t len);
 
-    /* Constuctor from string prefix */
-    prefix(std::string p);
+    /* Parse "AAA.BBB.CCC.DDD/ZZ" or "YYYY:...:YYYY/ZZZ".
+     * Return false, leaving p empty, if str is not a prefix. */
+    static bool parse(const char *str, prefix &p);
 
-    /* Create a prefix from a string */
-    static prefix make_prefix(std::string p);
+    /* Parse an address without length and give it length len */
+    static bool parse(const char *address, uint8_t len, prefix &p);
+
+    /* Create a prefix from a string, throw if it is not a prefix */
+    static prefix make_prefix(const std::string &p);
+
+    /* Write "address/len" in buf of at least STRLEN bytes, return the
+     * length written, 0 if the prefix is empty */
+    size_t format(char *buf) const;
 
     /* Return prefix "AAA.BBB.CCC.DDD/ZZ"
      * "YYYY:YYYY:YYYY:YYYY:YYYY:YYYY:YYYY:YYYY/ZZZ */
     std::string to_string() const;
 
-    /* Extract prefix length "ZZ"/"ZZZ" an IP prefix: "AAA.BBB.CCC.DDD/ZZ"
-     * "YYYY:YYYY:YYYY:YYYY:YYYY:YYYY:YYYY:YYYY/ZZZ */
-    unsigned short prefix_length() const;
+    /* AF_INET, AF_INET6 or AF_UNSPEC if the prefix is empty */
+    int family() const;
+
+    uint8_t prefix_length() const;
+
+    /* Address bytes in network order, 4 or 16 of them */
+    const uint8_t* bytes() const;
 
-    /* Extract IP "AAA.BBB.CCC.DDD" from an IP prefix: "AAA.BBB.CCC.DDD/ZZ"
-     * "YYYY:YYYY:YYYY:YYYY:YYYY:YYYY:YYYY:YYYY/ZZZ */
     boost::asio::ip::address address() const;
 
+    /* Same prefix with the host bits of its address cleared */
+    prefix network() const;
+
+    /* Netmask of the prefix length, in the family of the prefix */
+    boost::asio::ip::address netmask() const;
+
+    /* Return true if every address of p is in this prefix */
+    bool contains(const prefix &p) const;
+
+    /* Return true if this prefix and p have addresses in common */
+    bool overlaps(const prefix &p) const;
+
     /* Return true if prefix is empty */
     bool empty() const;
 
+    bool operator==(const prefix &p) const;
+    bool operator!=(const prefix &p) const;
+    bool operator<(const prefix &p) const;
+
+    /* Hash of the family, address and length, for unordered containers */
+    size_t hash() const;
+
     friend ostream& operator<<(ostream& os, const prefix& p);
 
 private:
-    boost::asio::ip::address m_address;
-    unsigned short m_prefix_len;
+    /* Number of address bytes of the family */
+    size_t size() const;
+
+    /* Return true if the first len bits of both addresses are equal */
+    bool same_bits(const prefix &p, uint8_t len) const;
+
+    uint8_t m_bytes[16];
+    uint8_t m_family;
+    uint8_t m_len;
+};
+
+/* Key predicates and node selection of a request xpath below a given node.
+ * For "/m:state/interface[name='eth0']/oper-status" and node "interface":
+ * key("name") is "eth0" and selected() is "oper-status".
+ * If a list of leaves is given, a selection that is not one of them (e.g. a
+ * nested container) is dropped: the whole node is then requested. */
+class xpath_filter {
+public:
+    xpath_filter(const char *xpath, const std::string &node,
+                 const std::vector<std::string> &leaves = {});
+
+    /* Return value of the key predicate, empty if there is none */
+    std::string key(const std::string &name) const;
+
+    /* Return the node selected below node, empty if there is none */
+    const std::string& selected() const;
+
+    /* Return true if leaf has to be part of the reply */
+    bool wants(const std::string &leaf) const;
+    bool wants(const char *leaf) const;
+
+    /* Return number of leaves among the given ones to be part of the reply */
+    size_t count(const std::vector<std::string> &leaves) const;
+
+private:
+    std::map<std::string, std::string> m_keys;
+    std::string m_selected;
+};
+
+/* Xpaths of the leaves of list entries, built without a format parse per
+ * leaf: the prefix of an entry, e.g. "/m:state/interface[name='eth0']", is
+ * formatted once, then leaf() appends "/<leaf>" to it. The buffer is reused
+ * from one entry to the next, and from one call to the next if the builder
+ * is kept. */
+class xpath_builder {
+public:
+    xpath_builder();
+
+    /* Start entry path[key='value'], or path itself if there is no key */
+    void entry(const char *path, const char *key = nullptr,
+               const char *value = nullptr);
+
+    /* Return xpath of leaf of the current entry, valid until next call */
+    const char* leaf(const char *name);
+
+    /* Set xpath of val to leaf of the current entry */
+    int set(sr_val_t *val, const char *name);
+
+private:
+    std::string m_xpath;
+    size_t m_entry;
+};
+
+/* Key predicates of the lists on the path of an xpath, in path order, as
+ * read by schema_dispatch::match(). Values point into the xpath read, they
+ * are valid as long as it is. */
+class xpath_keys {
+public:
+    /* Keys kept, the next ones are skipped */
+    static const size_t MAX = 4;
+
+    xpath_keys() : m_count(0) {}
+
+    size_t size() const { return m_count; }
+
+    /* Return value of the i-th key, empty if there is none */
+    std::string value(size_t i) const;
+
+    /* Return value of the first key called name, empty if there is none */
+    std::string value(const std::string &name) const;
+
+private:
+    friend class schema_dispatch;
+
+    struct key_t {
+        const char *name;
+        size_t name_len;
+        const char *value;
+        size_t value_len;
+    };
+
+    key_t m_keys[MAX];
+    size_t m_count;
+};
+
+/* Schema nodes handled by a change callback, compiled once into a trie of
+ * node names: the node of a change and the keys of the lists on its path
+ * are found in a single pass over its xpath, without a string comparison
+ * per node handled. For "/m:a/b[k='v']/c" with "/m:a/b/c" added as 1,
+ * match() returns 1 and the only key is "v". */
+class schema_dispatch {
+public:
+    schema_dispatch();
+    schema_dispatch(std::initializer_list<std::pair<const char*, int>> nodes);
+
+    /* Map schema path, e.g. "/m:a/b/c", to id, which is not negative */
+    void add(const char *path, int id);
+
+    /* Return id of the schema node of xpath, -1 if it has none, and fill
+     * keys with its predicates */
+    int match(const char *xpath, xpath_keys &keys) const;
+
+private:
+    static const size_t NONE = (size_t) -1;
+
+    struct node_t {
+        /* (name, node index) */
+        std::vector<std::pair<std::string, size_t>> children;
+        int id;
+    };
+
+    /* Child called name of node, NONE if there is none */
+    size_t child(size_t node, const char *name, size_t len) const;
+
+    /* root first */
+    std::vector<node_t> m_nodes;
 };
 
 } //end of utils namespace
 
+namespace std {
+
+template <> struct hash<utils::prefix> {
+    size_t operator()(const utils::prefix &p) const { return p.hash(); }
+};
+
+}
+
 #endif /* __SYS_UTIL_H__ */
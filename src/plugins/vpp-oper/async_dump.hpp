@@ -0,0 +1,69 @@
+#ifndef __OPER_ASYNC_DUMP_H_
+#define __OPER_ASYNC_DUMP_H_
+
+#include <vom/dump_cmd.hpp>
+
+#include "cmd_window.hpp"
+
+/**
+ * A dump command that can also be issued without waiting for its reply,
+ * to be pipelined with others through a cmd_window or a pipeline_cmd.
+ *
+ * Subclasses fill the request in fill(); issue() sends it and waits, as
+ * VOM dumps do.
+ */
+template <typename MSG>
+class async_dump : public VOM::dump_cmd<MSG>
+{
+public:
+  /**
+   * Send the request, done is called by the RX thread with the dump
+   * complete
+   */
+  VOM::rc_t issue_async(VOM::connection& con, cmd_window::done_t done)
+  {
+    m_done = done;
+    this->m_dump.reset(new MSG(con.ctx(), std::ref(*this)));
+
+    fill(*this->m_dump);
+
+    VAPI_CALL(this->m_dump->execute());
+
+    return VOM::rc_t::OK;
+  }
+
+  /**
+   * Issue the command to VPP/HW
+   */
+  VOM::rc_t issue(VOM::connection& con)
+  {
+    issue_async(con, nullptr);
+
+    return this->wait();
+  }
+
+  /**
+   * Called by the RX thread when the dump is complete
+   */
+  vapi_error_e operator()(MSG& d)
+  {
+    cmd_window::done_t done = m_done;
+
+    VOM::dump_cmd<MSG>::operator()(d);
+    if (done)
+      done(VOM::rc_t::OK);
+
+    return (VAPI_OK);
+  }
+
+protected:
+  /**
+   * Fill the request, nothing to fill by default
+   */
+  virtual void fill(MSG&) {}
+
+private:
+  cmd_window::done_t m_done;
+};
+
+#endif //__OPER_ASYNC_DUMP_H_
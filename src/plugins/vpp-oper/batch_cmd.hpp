@@ -0,0 +1,130 @@
+#ifndef __OPER_BATCH_CMD_H_
+#define __OPER_BATCH_CMD_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <vom/cmd.hpp>
+
+#include "cmd_window.hpp"
+
+/**
+ * Allocation of the requests of a batch_cmd. Messages with a variable
+ * length array specialize it to size the array of each request.
+ */
+template <typename MSG>
+struct batch_msg
+{
+  template <typename CB>
+  static MSG* make(vapi::Connection& con, size_t, CB cb)
+  {
+    return new MSG(con, cb);
+  }
+};
+
+/**
+ * A command that sends many requests of the same type to VPP without
+ * waiting for each reply.
+ *
+ * The requests are pipelined through a cmd_window: issue() returns once
+ * all the replies are in, so a batch costs about one round trip per window
+ * of requests instead of one per request.
+ */
+template <typename MSG>
+class batch_cmd : public VOM::cmd
+{
+public:
+  typedef MSG msg_t;
+
+  /**
+   * Fill the payload of one request
+   */
+  typedef std::function<void(MSG&)> fill_t;
+
+  batch_cmd(const std::string& name,
+            size_t window = cmd_window::default_window())
+    : m_name(name)
+    , m_window(window)
+    , m_failed(0)
+  {
+  }
+
+  /**
+   * Add a request to the batch, with n elements in its variable length
+   * array if it has one
+   */
+  void add(fill_t fill, size_t n = 0) { m_fills.emplace_back(n, fill); }
+
+  /**
+   * Number of requests in the batch
+   */
+  size_t size() const { return m_fills.size(); }
+
+  /**
+   * Number of requests that failed or were not replied
+   */
+  size_t failed() const { return m_failed; }
+
+  /**
+   * Issue the command to VPP/HW
+   */
+  VOM::rc_t issue(VOM::connection& con)
+  {
+    cmd_window w(m_window);
+    VOM::rc_t rc;
+
+    m_msgs.clear();
+
+    for (auto& fill : m_fills) {
+      w.send([this, &con, &fill](cmd_window::done_t done) {
+        /* called by the VAPI RX thread with the reply */
+        std::function<vapi_error_e(MSG&)> reply = [done](MSG& r) {
+          int retval = r.get_response().get_payload().retval;
+
+          done(retval ? VOM::rc_t::INVALID : VOM::rc_t::OK);
+          return (VAPI_OK);
+        };
+
+        m_msgs.emplace_back(
+          batch_msg<MSG>::make(con.ctx(), fill.first, reply));
+
+        MSG* msg = m_msgs.back().get();
+        fill.second(*msg);
+        VAPI_CALL(msg->execute());
+      });
+    }
+
+    rc = w.drain();
+    m_failed = w.failed();
+
+    return (rc);
+  }
+
+  /**
+   * Nothing to retire, the requests are one-shot
+   */
+  void retire(VOM::connection&) {}
+
+  /**
+   * convert to string format for debug purposes
+   */
+  std::string to_string() const
+  {
+    return (m_name + "-batch:" + std::to_string(m_fills.size()));
+  }
+
+private:
+  std::string m_name;
+  size_t m_window;
+  std::vector<std::pair<size_t, fill_t>> m_fills;
+
+  /* requests sent, kept until the next issue for late replies */
+  std::vector<std::unique_ptr<MSG>> m_msgs;
+
+  size_t m_failed;
+};
+
+#endif //__OPER_BATCH_CMD_H_
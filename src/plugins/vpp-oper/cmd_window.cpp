@@ -0,0 +1,112 @@
+#include "cmd_window.hpp"
+
+#include <atomic>
+
+using namespace VOM;
+
+constexpr std::chrono::seconds cmd_window::TIMEOUT;
+
+/* as many as VOM lets be outstanding on a connection */
+static std::atomic<size_t> window_default(128);
+
+size_t
+cmd_window::default_window()
+{
+  return window_default;
+}
+
+void
+cmd_window::set_default_window(size_t window)
+{
+  window_default = (window ? window : 1);
+}
+
+cmd_window::cmd_window(size_t window)
+  : m_window(window ? window : 1)
+  , m_state(std::make_shared<state_t>())
+{
+}
+
+void
+cmd_window::send(sender_t sender)
+{
+  std::shared_ptr<state_t> s = m_state;
+
+  {
+    std::unique_lock<std::mutex> lk(s->lock);
+
+    s->cond.wait(lk, [this, &s]() { return s->outstanding < m_window; });
+    s->outstanding++;
+  }
+
+  /* the reply can be dispatched before the sender returns */
+  sender([s](rc_t rc) {
+    std::lock_guard<std::mutex> lg(s->lock);
+
+    if (rc_t::OK != rc) {
+      if (rc_t::OK == s->rc)
+        s->rc = rc;
+      s->failed++;
+    }
+    s->outstanding--;
+    s->cond.notify_all();
+  });
+}
+
+rc_t
+cmd_window::drain()
+{
+  std::unique_lock<std::mutex> lk(m_state->lock);
+
+  if (!m_state->cond.wait_for(lk, TIMEOUT, [this]() {
+        return 0 == m_state->outstanding;
+      })) {
+    /* late replies go to the state left behind, not counted again */
+    std::shared_ptr<state_t> s = std::make_shared<state_t>();
+
+    s->failed = m_state->failed + m_state->outstanding;
+    s->rc = rc_t::TIMEOUT;
+    lk.unlock();
+    m_state = s;
+
+    return rc_t::TIMEOUT;
+  }
+
+  return m_state->rc;
+}
+
+size_t
+cmd_window::failed()
+{
+  std::lock_guard<std::mutex> lg(m_state->lock);
+
+  return m_state->failed;
+}
+
+pipeline_cmd::pipeline_cmd(const std::string& name, size_t window)
+  : m_name(name)
+  , m_window(window)
+  , m_failed(0)
+{
+}
+
+rc_t
+pipeline_cmd::issue(connection& con)
+{
+  cmd_window w(m_window);
+  rc_t rc;
+
+  for (auto& issue : m_issues)
+    issue(con, w);
+
+  rc = w.drain();
+  m_failed = w.failed();
+
+  return rc;
+}
+
+std::string
+pipeline_cmd::to_string() const
+{
+  return (m_name + "-pipeline:" + std::to_string(m_issues.size()));
+}
@@ -0,0 +1,161 @@
+#ifndef __OPER_CMD_WINDOW_H_
+#define __OPER_CMD_WINDOW_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <vom/cmd.hpp>
+
+/**
+ * Pipelined issue of asynchronous requests on one VAPI connection.
+ *
+ * send() waits until fewer than window requests are in flight, then runs a
+ * sender, which executes a request and has the done callback it is given
+ * called, by the RX thread, once the reply is in. drain() waits for all the
+ * replies. A bulk operation thus costs one round trip per window of
+ * requests instead of one per request, and is bounded by the VPP API
+ * throughput rather than by its latency.
+ *
+ * The window must not exceed the requests VAPI lets be outstanding on a
+ * connection, 128 for the VOM ones.
+ */
+class cmd_window
+{
+public:
+  /**
+   * Completion of a request, with its result
+   */
+  typedef std::function<void(VOM::rc_t)> done_t;
+
+  /**
+   * Execute a request, whose reply calls done
+   */
+  typedef std::function<void(done_t done)> sender_t;
+
+  /**
+   * Maximum time drain() waits for the replies
+   */
+  static constexpr std::chrono::seconds TIMEOUT{ 10 };
+
+  /**
+   * Window of the commands built without one
+   */
+  static size_t default_window();
+  static void set_default_window(size_t window);
+
+  explicit cmd_window(size_t window = default_window());
+
+  /**
+   * Run sender once there is room in the window
+   */
+  void send(sender_t sender);
+
+  /**
+   * Issue an asynchronous command, see async_dump; done, if any, runs on
+   * the RX thread before the window moves on
+   */
+  template <typename CMD>
+  void issue(VOM::connection& con,
+             std::shared_ptr<CMD> cmd,
+             done_t done = nullptr)
+  {
+    send([&con, cmd, done](done_t d) {
+      cmd->issue_async(con, [cmd, done, d](VOM::rc_t rc) {
+        if (done)
+          done(rc);
+        d(rc);
+      });
+    });
+  }
+
+  /**
+   * Wait for the replies of all the requests sent, return the first
+   * failure
+   */
+  VOM::rc_t drain();
+
+  /**
+   * Number of requests that failed or were not replied
+   */
+  size_t failed();
+
+private:
+  /**
+   * Shared with the done callbacks, which may outlive a window that timed
+   * out
+   */
+  struct state_t
+  {
+    std::mutex lock;
+    std::condition_variable cond;
+    size_t outstanding = 0;
+    size_t failed = 0;
+    VOM::rc_t rc = VOM::rc_t::OK;
+  };
+
+  size_t m_window;
+  std::shared_ptr<state_t> m_state;
+};
+
+/**
+ * A command issuing asynchronous commands through a cmd_window, so that
+ * HW::write() pipelines them instead of waiting for each in turn.
+ */
+class pipeline_cmd : public VOM::cmd
+{
+public:
+  pipeline_cmd(const std::string& name,
+               size_t window = cmd_window::default_window());
+
+  /**
+   * Add a command, done runs on the RX thread once it completes
+   */
+  template <typename CMD>
+  void add(std::shared_ptr<CMD> cmd, cmd_window::done_t done = nullptr)
+  {
+    m_issues.push_back(
+      [cmd, done](VOM::connection& con, cmd_window& w) {
+        w.issue(con, cmd, done);
+      });
+  }
+
+  /**
+   * Number of commands in the pipeline
+   */
+  size_t size() const { return m_issues.size(); }
+
+  /**
+   * Number of commands that failed or did not complete
+   */
+  size_t failed() const { return m_failed; }
+
+  /**
+   * Issue the command to VPP/HW
+   */
+  VOM::rc_t issue(VOM::connection& con);
+
+  /**
+   * Nothing to retire, the commands are one-shot
+   */
+  void retire(VOM::connection&) {}
+
+  /**
+   * convert to string format for debug purposes
+   */
+  std::string to_string() const;
+
+private:
+  typedef std::function<void(VOM::connection&, cmd_window&)> issue_t;
+
+  std::string m_name;
+  size_t m_window;
+  std::vector<issue_t> m_issues;
+  size_t m_failed;
+};
+
+#endif //__OPER_CMD_WINDOW_H_
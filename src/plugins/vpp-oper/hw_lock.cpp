@@ -0,0 +1,9 @@
+#include "hw_lock.hpp"
+
+std::mutex&
+hw_lock()
+{
+  static std::mutex lock;
+
+  return lock;
+}
@@ -0,0 +1,15 @@
+#ifndef __OPER_HW_LOCK_H_
+#define __OPER_HW_LOCK_H_
+
+#include <mutex>
+
+/**
+ * The VOM object model and HW command queue are not thread safe, while
+ * VPP is programmed by the dispatcher workers, dumped by the sysrepo thread
+ * serving reads, and (re)connected by the connection thread. Each of them
+ * holds this lock from the first object written or command enqueued to the
+ * HW::write() that issues them.
+ */
+std::mutex& hw_lock();
+
+#endif //__OPER_HW_LOCK_H_
@@ -1,5 +1,9 @@
 #include "interface.hpp"
 
+#include <unistd.h>
+
+#include <vom/hw.hpp>
+
 using namespace VOM;
 
 interface_dump::interface_dump()
@@ -11,12 +15,10 @@ interface_dump::interface_dump(std::string interface_name)
 {
 }
 
-rc_t
-interface_dump::issue(connection& con)
+void
+interface_dump::fill(msg_t& msg)
 {
-  m_dump.reset(new msg_t(con.ctx(), std::ref(*this)));
-
-  auto& payload = m_dump->get_request().get_payload();
+  auto& payload = msg.get_request().get_payload();
 
   if (m_name.empty()) {
     payload.name_filter_valid = 0;
@@ -25,16 +27,108 @@ interface_dump::issue(connection& con)
     memset(payload.name_filter.buf, 0, payload.name_filter.length);
     memcpy(payload.name_filter.buf, m_name.c_str(), m_name.length());
   }
+}
 
-  VAPI_CALL(m_dump->execute());
+std::string
+interface_dump::to_string() const
+{
+  return ("itf-dump");
+}
+
+interface_events_cmd::interface_events_cmd(listener& l)
+  : event_cmd(l.status())
+  , m_listener(l)
+{
+}
+
+rc_t
+interface_events_cmd::issue(connection& con)
+{
+  /*
+   * Need to recreate the request on each issue since the event registration
+   * is per connection
+   */
+  m_reg.reset(new reg_t(con.ctx(), std::ref(*(static_cast<event_cmd*>(this)))));
+
+  msg_t req(con.ctx(), std::ref(*this));
+
+  auto& payload = req.get_request().get_payload();
+  payload.enable_disable = 1;
+  payload.pid = getpid();
+
+  VAPI_CALL(req.execute());
 
   wait();
 
   return rc_t::OK;
 }
 
+void
+interface_events_cmd::retire(connection& con)
+{
+  msg_t req(con.ctx(), std::ref(*this));
+
+  auto& payload = req.get_request().get_payload();
+  payload.enable_disable = 0;
+  payload.pid = getpid();
+
+  VAPI_CALL(req.execute());
+
+  wait();
+}
+
+void
+interface_events_cmd::notify()
+{
+  std::lock_guard<interface_events_cmd> lg(*this);
+
+  for (auto& msg : *this) {
+    auto& payload = msg.get_payload();
+
+    m_listener.handle_interface_event(payload.sw_if_index, payload.flags,
+                                      payload.deleted);
+  }
+
+  flush();
+}
+
 std::string
-interface_dump::to_string() const
+interface_events_cmd::to_string() const
 {
-  return ("itf-dump");
+  return ("itf-events");
+}
+
+admin_state_batch::admin_state_batch()
+  : m_flags(std::make_shared<flags_batch>("itf-flags"))
+{
+}
+
+void
+admin_state_batch::add(uint32_t sw_if_index, bool up)
+{
+  m_flags->add([sw_if_index, up](vapi::Sw_interface_set_flags& req) {
+    auto& payload = req.get_request().get_payload();
+    payload.sw_if_index = sw_if_index;
+    payload.flags = (up ? IF_STATUS_API_FLAG_ADMIN_UP
+                        : static_cast<vapi_enum_if_status_flags>(0));
+  });
+}
+
+size_t
+admin_state_batch::size() const
+{
+  return m_flags->size();
+}
+
+void
+admin_state_batch::enqueue()
+{
+  if (m_flags->size())
+    HW::enqueue(m_flags);
+}
+
+size_t
+admin_state_batch::failed() const
+{
+  return m_flags->failed();
 }
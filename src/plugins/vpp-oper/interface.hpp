@@ -1,10 +1,15 @@
 #ifndef __OPER_INTERFACE_H_
 #define __OPER_INTERFACE_H_
 
-#include <vom/dump_cmd.hpp>
+#include <memory>
+
+#include <vom/event_cmd.hpp>
 #include <vapi/interface.api.vapi.hpp>
 
-class interface_dump : public VOM::dump_cmd<vapi::Sw_interface_dump>
+#include "async_dump.hpp"
+#include "batch_cmd.hpp"
+
+class interface_dump : public async_dump<vapi::Sw_interface_dump>
 {
 public:
   /**
@@ -17,17 +22,116 @@ public:
    */
   interface_dump(std::string interface_name);
 
+  /**
+   * convert to string format for debug purposes
+   */
+  std::string to_string() const;
+
+protected:
+  /**
+   * Fill the request with the name filter
+   */
+  void fill(msg_t& msg);
+
+private:
+  std::string m_name; //interface name
+};
+
+/**
+ * A command class that registers for VPP interface admin/link/delete
+ * events and forwards them to a listener.
+ */
+class interface_events_cmd
+  : public VOM::event_cmd<vapi::Want_interface_events,
+                          vapi::Sw_interface_event>
+{
+public:
+  /**
+   * Receiver of the interface events
+   */
+  class listener
+  {
+  public:
+    virtual ~listener() = default;
+
+    /**
+     * Called from the VAPI RX thread for each event received
+     */
+    virtual void handle_interface_event(uint32_t sw_if_index,
+                                        vapi_enum_if_status_flags flags,
+                                        bool deleted) = 0;
+
+    /**
+     * Status of the event registration in VPP
+     */
+    VOM::HW::item<bool>& status() { return m_status; }
+
+  protected:
+    VOM::HW::item<bool> m_status;
+  };
+
+  /**
+   * Constructor taking the listener to notify
+   */
+  interface_events_cmd(listener& l);
+
   /**
    * Issue the command to VPP/HW
    */
   VOM::rc_t issue(VOM::connection& con);
+
+  /**
+   * Retire the command - unsubscribe
+   */
+  void retire(VOM::connection& con);
+
+  /**
+   * Called when it's time to poke the listener
+   */
+  void notify();
+
   /**
    * convert to string format for debug purposes
    */
   std::string to_string() const;
 
 private:
-  std::string m_name; //interface name
+  listener& m_listener;
+};
+
+/**
+ * Admin state of interfaces set with pipelined requests, one per
+ * interface.
+ */
+class admin_state_batch
+{
+public:
+  admin_state_batch();
+
+  /**
+   * Add an interface and the admin state it must have to the batch
+   */
+  void add(uint32_t sw_if_index, bool up);
+
+  /**
+   * Number of interfaces in the batch
+   */
+  size_t size() const;
+
+  /**
+   * Enqueue the requests, sent by the next HW::write()
+   */
+  void enqueue();
+
+  /**
+   * Number of interfaces that failed once written
+   */
+  size_t failed() const;
+
+private:
+  typedef batch_cmd<vapi::Sw_interface_set_flags> flags_batch;
+
+  std::shared_ptr<flags_batch> m_flags;
 };
 
 #endif //__OPER_INTERFACE_H_
@@ -0,0 +1,223 @@
+#include "interface_cache.hpp"
+
+#include <algorithm>
+
+#include "hw_lock.hpp"
+#include "read_pool.hpp"
+
+using namespace VOM;
+
+const std::chrono::seconds interface_cache::MAX_AGE(30);
+
+interface_cache&
+interface_cache::instance()
+{
+  static interface_cache cache;
+
+  return cache;
+}
+
+interface_cache::interface_cache()
+  : m_valid(false)
+  , m_syncing(false)
+{
+}
+
+rc_t
+interface_cache::start()
+{
+  if (!m_events) {
+    std::lock_guard<std::mutex> hw(hw_lock());
+
+    m_events = std::make_shared<interface_events_cmd>(*this);
+    HW::enqueue(m_events);
+    HW::write();
+  }
+
+  invalidate();
+
+  return sync();
+}
+
+void
+interface_cache::stop()
+{
+  if (m_events) {
+    std::lock_guard<std::mutex> hw(hw_lock());
+
+    HW::dequeue(m_events);
+    m_events.reset();
+  }
+
+  std::lock_guard<std::mutex> lg(m_lock);
+  m_table.clear();
+  m_names.clear();
+  m_valid = false;
+}
+
+rc_t
+interface_cache::restart()
+{
+  /* the registration died with the previous connection */
+  m_events.reset();
+
+  return start();
+}
+
+void
+interface_cache::invalidate()
+{
+  std::lock_guard<std::mutex> lg(m_lock);
+  m_valid = false;
+}
+
+rc_t
+interface_cache::sync()
+{
+  std::shared_ptr<interface_dump> dump;
+  rc_t rc;
+
+  /* One dump at a time, as the backlog is the one of the dump in flight:
+   * concurrent readers wait for it and then find the table valid. */
+  std::lock_guard<std::mutex> sl(m_sync_lock);
+
+  {
+    std::lock_guard<std::mutex> lg(m_lock);
+
+    if (m_valid &&
+        std::chrono::steady_clock::now() - m_last_sync < MAX_AGE)
+      return rc_t::OK;
+
+    m_syncing = true;
+    m_backlog.clear();
+  }
+
+  /* The lock must not be held while waiting for the dump: the events are
+   * delivered by the same RX thread that completes the dump. */
+  dump = std::make_shared<interface_dump>();
+  rc = read_pool::instance().issue(dump);
+
+  std::lock_guard<std::mutex> lg(m_lock);
+  m_syncing = false;
+
+  if (rc_t::OK != rc)
+    return rc;
+
+  table_t before;
+
+  m_table.swap(before);
+  m_names.clear();
+  for (auto& it : *dump) {
+    const details_t& d = it.get_payload();
+    auto old = before.find(d.sw_if_index);
+
+    /* events may have been missed, on a VPP restart for instance, those
+     * received during the dump were reported already */
+    if (old != before.end() &&
+        std::none_of(m_backlog.begin(), m_backlog.end(),
+                     [&d](const event_t& ev) {
+                       return ev.sw_if_index == d.sw_if_index;
+                     }))
+      changed(old->second, d);
+
+    m_table[d.sw_if_index] = d;
+    m_names[d.interface_name] = d.sw_if_index;
+  }
+
+  m_valid = true;
+  m_last_sync = std::chrono::steady_clock::now();
+
+  for (auto& ev : m_backlog)
+    apply(ev, false);
+  m_backlog.clear();
+
+  return rc_t::OK;
+}
+
+bool
+interface_cache::find(const std::string& name, details_t& details)
+{
+  if (rc_t::OK != sync())
+    return false;
+
+  std::lock_guard<std::mutex> lg(m_lock);
+
+  auto it = m_names.find(name);
+  if (it == m_names.end())
+    return false;
+
+  details = m_table[it->second];
+
+  return true;
+}
+
+bool
+interface_cache::find(uint32_t sw_if_index, details_t& details)
+{
+  if (rc_t::OK != sync())
+    return false;
+
+  std::lock_guard<std::mutex> lg(m_lock);
+
+  auto it = m_table.find(sw_if_index);
+  if (it == m_table.end())
+    return false;
+
+  details = it->second;
+
+  return true;
+}
+
+void
+interface_cache::on_change(change_cb_t cb)
+{
+  std::lock_guard<std::mutex> lg(m_lock);
+
+  m_on_change = cb;
+}
+
+void
+interface_cache::changed(const details_t& before, const details_t& after)
+{
+  if (m_on_change && before.flags != after.flags)
+    m_on_change(before, after);
+}
+
+void
+interface_cache::handle_interface_event(uint32_t sw_if_index,
+                                        vapi_enum_if_status_flags flags,
+                                        bool deleted)
+{
+  event_t ev = { sw_if_index, flags, deleted };
+
+  std::lock_guard<std::mutex> lg(m_lock);
+
+  if (m_syncing)
+    m_backlog.push_back(ev);
+
+  apply(ev);
+}
+
+void
+interface_cache::apply(const event_t& ev, bool report)
+{
+  auto it = m_table.find(ev.sw_if_index);
+
+  if (it == m_table.end()) {
+    /* an interface we have never seen, dump again on next read */
+    if (!ev.deleted)
+      m_valid = false;
+    return;
+  }
+
+  if (ev.deleted) {
+    m_names.erase(it->second.interface_name);
+    m_table.erase(it);
+  } else {
+    details_t before = it->second;
+
+    it->second.flags = ev.flags;
+    if (report)
+      changed(before, it->second);
+  }
+}
@@ -0,0 +1,154 @@
+#ifndef __OPER_INTERFACE_CACHE_H_
+#define __OPER_INTERFACE_CACHE_H_
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "interface.hpp"
+
+/**
+ * In-memory table of the VPP interfaces keyed by sw_if_index.
+ *
+ * The table is filled by one sw_interface_dump and then kept current by
+ * the VPP interface events, so operational reads don't have to go to VPP.
+ * VPP does not signal interface creation, so an event for an unknown
+ * sw_if_index, an explicit invalidate() or an entry older than MAX_AGE
+ * triggers a new dump on the next read. Reads made while it is in flight
+ * wait for it rather than dumping again.
+ */
+class interface_cache : public interface_events_cmd::listener
+{
+public:
+  typedef vapi_payload_sw_interface_details details_t;
+  typedef std::map<uint32_t, details_t> table_t;
+
+  /**
+   * Called with the details of an interface before and after its status
+   * flags changed, m_lock held
+   */
+  typedef std::function<void(const details_t&, const details_t&)>
+    change_cb_t;
+
+  /**
+   * Maximum age of the table before it is dumped again
+   */
+  static const std::chrono::seconds MAX_AGE;
+
+  /**
+   * The singleton instance
+   */
+  static interface_cache& instance();
+
+  /**
+   * Register for the interface events and fill the table
+   */
+  VOM::rc_t start();
+
+  /**
+   * Unregister from the interface events and drop the table
+   */
+  void stop();
+
+  /**
+   * Re-register the events on a new VPP connection and mark the table as
+   * stale. To be called after VPP has restarted.
+   */
+  VOM::rc_t restart();
+
+  /**
+   * Mark the table as stale, next read dumps the interfaces again
+   */
+  void invalidate();
+
+  /**
+   * Call f with the up-to-date table, locked for the duration of the call
+   */
+  template <typename F>
+  VOM::rc_t read(F f)
+  {
+    VOM::rc_t rc = sync();
+
+    if (VOM::rc_t::OK != rc)
+      return rc;
+
+    std::lock_guard<std::mutex> lg(m_lock);
+    const table_t& table = m_table;
+    f(table);
+
+    return rc;
+  }
+
+  /**
+   * Copy the details of the interface with the given name.
+   * Return false if it does not exist.
+   */
+  bool find(const std::string& name, details_t& details);
+
+  /**
+   * Copy the details of the interface with the given sw_if_index.
+   * Return false if it does not exist.
+   */
+  bool find(uint32_t sw_if_index, details_t& details);
+
+  /**
+   * Have cb called on each change of the flags of a known interface, by an
+   * event or by a dump. nullptr to stop.
+   */
+  void on_change(change_cb_t cb);
+
+  /**
+   * interface_events_cmd::listener
+   */
+  void handle_interface_event(uint32_t sw_if_index,
+                              vapi_enum_if_status_flags flags,
+                              bool deleted);
+
+private:
+  struct event_t
+  {
+    uint32_t sw_if_index;
+    vapi_enum_if_status_flags flags;
+    bool deleted;
+  };
+
+  interface_cache();
+
+  /**
+   * Dump the interfaces from VPP if the table is stale
+   */
+  VOM::rc_t sync();
+
+  /**
+   * Apply one event to the table, m_lock must be held. The change is
+   * reported unless it was already, when replaying the backlog.
+   */
+  void apply(const event_t& ev, bool report = true);
+
+  /**
+   * Report a change of flags, m_lock must be held
+   */
+  void changed(const details_t& before, const details_t& after);
+
+  std::mutex m_lock;
+  table_t m_table;
+  std::unordered_map<std::string, uint32_t> m_names;
+  bool m_valid;
+  std::chrono::steady_clock::time_point m_last_sync;
+
+  /* serializes sync(), held while a dump is in flight */
+  std::mutex m_sync_lock;
+
+  /* events received while a dump is in flight, replayed on its result */
+  bool m_syncing;
+  std::vector<event_t> m_backlog;
+
+  std::shared_ptr<interface_events_cmd> m_events;
+
+  change_cb_t m_on_change;
+};
+
+#endif //__OPER_INTERFACE_CACHE_H_
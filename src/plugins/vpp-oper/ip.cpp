@@ -0,0 +1,192 @@
+#include "ip.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#include <vom/hw.hpp>
+
+using namespace VOM;
+
+ip_address_dump::ip_address_dump(uint32_t sw_if_index, bool is_ipv6)
+  : m_sw_if_index(sw_if_index)
+  , m_is_ipv6(is_ipv6)
+{
+}
+
+void
+ip_address_dump::fill(msg_t& msg)
+{
+  auto& payload = msg.get_request().get_payload();
+  payload.sw_if_index = m_sw_if_index;
+  payload.is_ipv6 = m_is_ipv6;
+}
+
+std::string
+ip_address_dump::to_string() const
+{
+  return ("ip-address-dump: " + std::to_string(m_sw_if_index) +
+          (m_is_ipv6 ? " ip6" : " ip4"));
+}
+
+route::prefix_t
+from_api(const vapi_type_prefix& p)
+{
+  boost::asio::ip::address addr;
+
+  if (ADDRESS_IP6 == p.address.af) {
+    boost::asio::ip::address_v6::bytes_type b;
+    std::copy(p.address.un.ip6, p.address.un.ip6 + b.size(), b.begin());
+    addr = boost::asio::ip::address_v6(b);
+  } else {
+    boost::asio::ip::address_v4::bytes_type b;
+    std::copy(p.address.un.ip4, p.address.un.ip4 + b.size(), b.begin());
+    addr = boost::asio::ip::address_v4(b);
+  }
+
+  return route::prefix_t(addr, p.len);
+}
+
+void
+to_api(const route::prefix_t& pfx, vapi_type_prefix& p)
+{
+  const boost::asio::ip::address& addr = pfx.address();
+
+  if (addr.is_v6()) {
+    auto b = addr.to_v6().to_bytes();
+    p.address.af = ADDRESS_IP6;
+    std::copy(b.begin(), b.end(), p.address.un.ip6);
+  } else {
+    auto b = addr.to_v4().to_bytes();
+    p.address.af = ADDRESS_IP4;
+    std::copy(b.begin(), b.end(), p.address.un.ip4);
+  }
+  p.len = pfx.mask_width();
+}
+
+address_batch::address_batch(bool is_add)
+  : m_is_add(is_add)
+  , m_addresses(std::make_shared<addresses_batch>(
+      is_add ? "itf-address-add" : "itf-address-del"))
+{
+}
+
+void
+address_batch::add(uint32_t sw_if_index, const route::prefix_t& pfx)
+{
+  uint8_t is_add = m_is_add;
+  vapi_type_prefix prefix;
+
+  to_api(pfx, prefix);
+  m_addresses->add(
+    [sw_if_index, is_add, prefix](vapi::Sw_interface_add_del_address& req) {
+      auto& payload = req.get_request().get_payload();
+      payload.sw_if_index = sw_if_index;
+      payload.is_add = is_add;
+      payload.del_all = 0;
+      payload.prefix = prefix;
+    });
+}
+
+size_t
+address_batch::size() const
+{
+  return m_addresses->size();
+}
+
+void
+address_batch::enqueue()
+{
+  if (m_addresses->size())
+    HW::enqueue(m_addresses);
+}
+
+size_t
+address_batch::failed() const
+{
+  return m_addresses->failed();
+}
+
+/* A path, its interface resolved to the sw_if_index it has now */
+static void
+to_api(const route::path& p, vapi_type_fib_path& o)
+{
+  const boost::asio::ip::address& nh = p.nh();
+
+  o.sw_if_index = p.itf() ? p.itf()->handle().value() : ~0;
+  o.table_id = p.rd() ? p.rd()->table_id() : route::DEFAULT_TABLE;
+  o.rpf_id = ~0;
+  o.weight = p.weight();
+  o.preference = p.preference();
+  o.proto = (nh_proto_t::IPV6 == p.nh_proto() ? FIB_API_PATH_NH_PROTO_IP6
+                                              : FIB_API_PATH_NH_PROTO_IP4);
+
+  if (route::path::special_t::DROP == p.type())
+    o.type = FIB_API_PATH_TYPE_DROP;
+  else if (route::path::special_t::LOCAL == p.type())
+    o.type = FIB_API_PATH_TYPE_LOCAL;
+  else
+    o.type = FIB_API_PATH_TYPE_NORMAL;
+
+  if (nh.is_v6()) {
+    auto b = nh.to_v6().to_bytes();
+    std::copy(b.begin(), b.end(), o.nh.address.ip6);
+  } else if (!nh.is_unspecified()) {
+    auto b = nh.to_v4().to_bytes();
+    std::copy(b.begin(), b.end(), o.nh.address.ip4);
+  }
+}
+
+route_batch::route_batch(bool is_add)
+  : m_is_add(is_add)
+  , m_routes(std::make_shared<routes_batch>(is_add ? "ip-route-add"
+                                                   : "ip-route-del"))
+{
+}
+
+void
+route_batch::add(const route::prefix_t& pfx, const route::path_list_t& paths)
+{
+  uint8_t is_add = m_is_add;
+  vapi_type_prefix prefix;
+  std::vector<vapi_type_fib_path> fib_paths;
+
+  to_api(pfx, prefix);
+  if (is_add) {
+    fib_paths.resize(paths.size());
+    auto p = paths.begin();
+    for (auto& f : fib_paths)
+      to_api(*p++, f);
+  }
+
+  m_routes->add(
+    [is_add, prefix, fib_paths](vapi::Ip_route_add_del& req) {
+      auto& payload = req.get_request().get_payload();
+      payload.is_add = is_add;
+      /* the paths given replace those the route had */
+      payload.is_multipath = 0;
+      payload.route.table_id = route::DEFAULT_TABLE;
+      payload.route.prefix = prefix;
+      payload.route.n_paths = fib_paths.size();
+      std::copy(fib_paths.begin(), fib_paths.end(), payload.route.paths);
+    },
+    fib_paths.size());
+}
+
+size_t
+route_batch::size() const
+{
+  return m_routes->size();
+}
+
+void
+route_batch::enqueue()
+{
+  if (m_routes->size())
+    HW::enqueue(m_routes);
+}
+
+size_t
+route_batch::failed() const
+{
+  return m_routes->failed();
+}
@@ -0,0 +1,131 @@
+#ifndef __OPER_IP_H_
+#define __OPER_IP_H_
+
+#include <memory>
+
+#include <vom/route.hpp>
+#include <vapi/interface.api.vapi.hpp>
+#include <vapi/ip.api.vapi.hpp>
+
+#include "async_dump.hpp"
+#include "batch_cmd.hpp"
+
+class ip_address_dump : public async_dump<vapi::Ip_address_dump>
+{
+public:
+  /**
+   * Constructor to dump the addresses of one family of one interface
+   */
+  ip_address_dump(uint32_t sw_if_index, bool is_ipv6);
+
+  /**
+   * convert to string format for debug purposes
+   */
+  std::string to_string() const;
+
+protected:
+  /**
+   * Fill the request with the interface and family
+   */
+  void fill(msg_t& msg);
+
+private:
+  uint32_t m_sw_if_index;
+  bool m_is_ipv6;
+};
+
+/**
+ * Conversions between VOM prefixes and VAPI ones
+ */
+VOM::route::prefix_t from_api(const vapi_type_prefix& p);
+void to_api(const VOM::route::prefix_t& pfx, vapi_type_prefix& p);
+
+/**
+ * Addresses of interfaces added or deleted with pipelined requests, one
+ * per address.
+ */
+class address_batch
+{
+public:
+  address_batch(bool is_add);
+
+  /**
+   * Add an address of an interface to the batch
+   */
+  void add(uint32_t sw_if_index, const VOM::route::prefix_t& pfx);
+
+  /**
+   * Number of addresses in the batch
+   */
+  size_t size() const;
+
+  /**
+   * Enqueue the requests, sent by the next HW::write()
+   */
+  void enqueue();
+
+  /**
+   * Number of addresses that failed once written
+   */
+  size_t failed() const;
+
+private:
+  typedef batch_cmd<vapi::Sw_interface_add_del_address> addresses_batch;
+
+  bool m_is_add;
+  std::shared_ptr<addresses_batch> m_addresses;
+};
+
+/**
+ * ip_route_add_del carries the paths of the route in its variable length
+ * array
+ */
+template <>
+struct batch_msg<vapi::Ip_route_add_del>
+{
+  template <typename CB>
+  static vapi::Ip_route_add_del* make(vapi::Connection& con, size_t n, CB cb)
+  {
+    return new vapi::Ip_route_add_del(con, n, cb);
+  }
+};
+
+/**
+ * Routes of the default table added or deleted with pipelined requests,
+ * one per route whatever its number of paths.
+ */
+class route_batch
+{
+public:
+  route_batch(bool is_add);
+
+  /**
+   * Add a route to the batch. Added, a route replaces the paths it had;
+   * deleted, its paths are ignored.
+   */
+  void add(const VOM::route::prefix_t& pfx,
+           const VOM::route::path_list_t& paths);
+
+  /**
+   * Number of routes in the batch
+   */
+  size_t size() const;
+
+  /**
+   * Enqueue the requests, sent by the next HW::write()
+   */
+  void enqueue();
+
+  /**
+   * Number of routes that failed once written
+   */
+  size_t failed() const;
+
+private:
+  typedef batch_cmd<vapi::Ip_route_add_del> routes_batch;
+
+  bool m_is_add;
+  std::shared_ptr<routes_batch> m_routes;
+};
+
+#endif //__OPER_IP_H_
@@ -0,0 +1,118 @@
+#include "nat.hpp"
+
+#include <algorithm>
+
+#include <vom/hw.hpp>
+
+using namespace VOM;
+
+std::string
+nat44_static_mapping_dump::to_string() const
+{
+  return ("nat44-static-mapping-dump");
+}
+
+std::string
+nat66_static_mapping_dump::to_string() const
+{
+  return ("nat66-static-mapping-dump");
+}
+
+std::string
+nat44_user_dump::to_string() const
+{
+  return ("nat44-user-dump");
+}
+
+nat44_user_session_dump::nat44_user_session_dump(
+  const boost::asio::ip::address_v4& user,
+  uint32_t vrf_id)
+  : m_user(user)
+  , m_vrf_id(vrf_id)
+{
+}
+
+void
+nat44_user_session_dump::fill(msg_t& msg)
+{
+  auto& payload = msg.get_request().get_payload();
+  auto bytes = m_user.to_bytes();
+  std::copy(bytes.begin(), bytes.end(), payload.ip_address);
+  payload.vrf_id = m_vrf_id;
+}
+
+std::string
+nat44_user_session_dump::to_string() const
+{
+  return ("nat44-user-session-dump:" + m_user.to_string());
+}
+
+template <typename BYTES>
+static void
+copy_bytes(const BYTES& from, uint8_t* to)
+{
+  std::copy(from.begin(), from.end(), to);
+}
+
+nat_static_batch::nat_static_batch(bool is_add)
+  : m_is_add(is_add)
+  , m_nat44(std::make_shared<nat44_batch>(is_add ? "nat44-static-add"
+                                                 : "nat44-static-del"))
+  , m_nat66(std::make_shared<nat66_batch>(is_add ? "nat66-static-add"
+                                                 : "nat66-static-del"))
+{
+}
+
+void
+nat_static_batch::add(const boost::asio::ip::address& inside,
+                      const boost::asio::ip::address& outside)
+{
+  uint8_t is_add = m_is_add;
+
+  if (inside.is_v4()) {
+    auto in = inside.to_v4().to_bytes();
+    auto out = outside.to_v4().to_bytes();
+
+    m_nat44->add([is_add, in, out](vapi::Nat44_add_del_static_mapping& req) {
+      auto& payload = req.get_request().get_payload();
+      payload.is_add = is_add;
+      payload.flags = NAT_IS_ADDR_ONLY;
+      copy_bytes(in, payload.local_ip_address);
+      copy_bytes(out, payload.external_ip_address);
+      payload.external_sw_if_index = ~0;
+      payload.vrf_id = 0;
+    });
+  } else {
+    auto in = inside.to_v6().to_bytes();
+    auto out = outside.to_v6().to_bytes();
+
+    m_nat66->add([is_add, in, out](vapi::Nat66_add_del_static_mapping& req) {
+      auto& payload = req.get_request().get_payload();
+      payload.is_add = is_add;
+      copy_bytes(in, payload.local_ip_address);
+      copy_bytes(out, payload.external_ip_address);
+      payload.vrf_id = 0;
+    });
+  }
+}
+
+size_t
+nat_static_batch::size() const
+{
+  return m_nat44->size() + m_nat66->size();
+}
+
+void
+nat_static_batch::enqueue()
+{
+  if (m_nat44->size())
+    HW::enqueue(m_nat44);
+  if (m_nat66->size())
+    HW::enqueue(m_nat66);
+}
+
+size_t
+nat_static_batch::failed() const
+{
+  return m_nat44->failed() + m_nat66->failed();
+}
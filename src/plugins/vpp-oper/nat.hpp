@@ -0,0 +1,113 @@
+#ifndef __OPER_NAT_H_
+#define __OPER_NAT_H_
+
+#include <memory>
+
+#include <boost/asio/ip/address.hpp>
+
+#include <vapi/nat.api.vapi.hpp>
+
+#include "async_dump.hpp"
+#include "batch_cmd.hpp"
+
+class nat44_static_mapping_dump
+  : public async_dump<vapi::Nat44_static_mapping_dump>
+{
+public:
+  /**
+   * convert to string format for debug purposes
+   */
+  std::string to_string() const;
+};
+
+class nat66_static_mapping_dump
+  : public async_dump<vapi::Nat66_static_mapping_dump>
+{
+public:
+  /**
+   * convert to string format for debug purposes
+   */
+  std::string to_string() const;
+};
+
+class nat44_user_dump : public async_dump<vapi::Nat44_user_dump>
+{
+public:
+  /**
+   * convert to string format for debug purposes
+   */
+  std::string to_string() const;
+};
+
+/**
+ * NAT44 sessions of one user, i.e. one inside address
+ */
+class nat44_user_session_dump
+  : public async_dump<vapi::Nat44_user_session_dump>
+{
+public:
+  nat44_user_session_dump(const boost::asio::ip::address_v4& user,
+                          uint32_t vrf_id);
+
+  /**
+   * The user and its VRF
+   */
+  const boost::asio::ip::address_v4& user() const { return m_user; }
+  uint32_t vrf_id() const { return m_vrf_id; }
+
+  /**
+   * convert to string format for debug purposes
+   */
+  std::string to_string() const;
+
+protected:
+  /**
+   * Fill the request with the user
+   */
+  void fill(msg_t& msg);
+
+private:
+  boost::asio::ip::address_v4 m_user;
+  uint32_t m_vrf_id;
+};
+
+/**
+ * Address only static NAT mappings added or deleted with pipelined
+ * requests, NAT44 and NAT66 ones alike.
+ */
+class nat_static_batch
+{
+public:
+  nat_static_batch(bool is_add);
+
+  /**
+   * Add a mapping to the batch
+   */
+  void add(const boost::asio::ip::address& inside,
+           const boost::asio::ip::address& outside);
+
+  /**
+   * Number of mappings in the batch
+   */
+  size_t size() const;
+
+  /**
+   * Enqueue the requests, sent by the next HW::write()
+   */
+  void enqueue();
+
+  /**
+   * Number of mappings that failed once written
+   */
+  size_t failed() const;
+
+private:
+  typedef batch_cmd<vapi::Nat44_add_del_static_mapping> nat44_batch;
+  typedef batch_cmd<vapi::Nat66_add_del_static_mapping> nat66_batch;
+
+  bool m_is_add;
+  std::shared_ptr<nat44_batch> m_nat44;
+  std::shared_ptr<nat66_batch> m_nat66;
+};
+
+#endif //__OPER_NAT_H_
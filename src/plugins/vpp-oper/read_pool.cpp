@@ -0,0 +1,122 @@
+#include "read_pool.hpp"
+#include "hw_lock.hpp"
+
+#include <vom/hw.hpp>
+
+using namespace VOM;
+
+const unsigned read_pool::SIZE;
+
+read_pool&
+read_pool::instance()
+{
+  static read_pool pool;
+
+  return pool;
+}
+
+void
+read_pool::rx_run(conn_t& c)
+{
+  while (c.connected)
+    c.con.ctx().dispatch();
+}
+
+unsigned
+read_pool::connect(unsigned n)
+{
+  std::lock_guard<std::mutex> lg(m_lock);
+
+  while (m_conns.size() < n) {
+    std::unique_ptr<conn_t> c(new conn_t());
+
+    if (0 != c->con.connect())
+      break;
+
+    c->connected = true;
+    c->busy = false;
+    conn_t* p = c.get();
+    c->rx = std::thread([p]() { rx_run(*p); });
+    m_conns.push_back(std::move(c));
+  }
+
+  m_free.notify_all();
+
+  return m_conns.size();
+}
+
+void
+read_pool::disconnect()
+{
+  std::vector<std::unique_ptr<conn_t>> conns;
+
+  {
+    std::unique_lock<std::mutex> lk(m_lock);
+
+    /* commands being issued need their RX thread */
+    m_free.wait(lk, [this]() {
+      for (auto& c : m_conns)
+        if (c->busy)
+          return false;
+      return true;
+    });
+    conns.swap(m_conns);
+  }
+
+  /* as VOM closes the HW connection: RX thread first */
+  for (auto& c : conns) {
+    c->connected = false;
+    c->rx.join();
+    c->con.disconnect();
+  }
+}
+
+rc_t
+read_pool::issue(std::shared_ptr<cmd> cmd)
+{
+  std::unique_lock<std::mutex> lk(m_lock);
+  conn_t* free = nullptr;
+  rc_t rc;
+
+  if (m_conns.empty()) {
+    lk.unlock();
+
+    std::lock_guard<std::mutex> hw(hw_lock());
+    HW::enqueue(cmd);
+    return HW::write();
+  }
+
+  m_free.wait(lk, [this, &free]() {
+    for (auto& c : m_conns) {
+      if (!c->busy) {
+        free = c.get();
+        return true;
+      }
+    }
+    return m_conns.empty();
+  });
+
+  if (nullptr == free) {
+    lk.unlock();
+    return issue(cmd);
+  }
+
+  free->busy = true;
+  lk.unlock();
+
+  rc = cmd->issue(free->con);
+
+  lk.lock();
+  free->busy = false;
+  m_free.notify_all();
+
+  return rc;
+}
+
+unsigned
+read_pool::size()
+{
+  std::lock_guard<std::mutex> lg(m_lock);
+
+  return m_conns.size();
+}
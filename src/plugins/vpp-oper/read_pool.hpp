@@ -0,0 +1,82 @@
+#ifndef __OPER_READ_POOL_H_
+#define __OPER_READ_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <vom/cmd.hpp>
+#include <vom/connection.hpp>
+
+/**
+ * VAPI connections of their own for the dumps serving operational reads.
+ *
+ * The VOM HW connection programs the configuration, under hw_lock(): a
+ * dump issued through it waits for the commit being programmed, and delays
+ * the next one. The dumps of the read pool go to VPP on one of SIZE other
+ * connections, each with its own RX thread as VOM has, so that monitoring
+ * traffic and commits do not wait for each other.
+ *
+ * Only commands that read VPP belong here: what they read is not ordered
+ * with what the HW connection writes at the same time.
+ */
+class read_pool
+{
+public:
+  /**
+   * Number of connections opened by connect()
+   */
+  static const unsigned SIZE = 2;
+
+  /**
+   * The singleton instance
+   */
+  static read_pool& instance();
+
+  /**
+   * Open n connections to VPP, once HW is connected. Return the number
+   * opened
+   */
+  unsigned connect(unsigned n = SIZE);
+
+  /**
+   * Close the connections, waiting for the commands being issued
+   */
+  void disconnect();
+
+  /**
+   * Issue cmd on a free connection, waiting for one if all are busy.
+   * Through HW, under hw_lock(), when none is connected
+   */
+  VOM::rc_t issue(std::shared_ptr<VOM::cmd> cmd);
+
+  /**
+   * Number of connections open
+   */
+  unsigned size();
+
+private:
+  struct conn_t
+  {
+    VOM::connection con;
+    std::thread rx;
+    std::atomic<bool> connected;
+    bool busy;
+  };
+
+  read_pool() = default;
+
+  /**
+   * Dispatch the replies of a connection until it is closed
+   */
+  static void rx_run(conn_t& c);
+
+  std::mutex m_lock;
+  std::condition_variable m_free;
+  std::vector<std::unique_ptr<conn_t>> m_conns;
+};
+
+#endif //__OPER_READ_POOL_H_
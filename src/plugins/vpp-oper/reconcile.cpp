@@ -0,0 +1,258 @@
+#include "reconcile.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include <vom/hw.hpp>
+#include <vom/interface.hpp>
+#include <vom/om.hpp>
+
+#include "batch_cmd.hpp"
+#include "cmd_window.hpp"
+#include "hw_lock.hpp"
+#include "interface.hpp"
+#include "ip.hpp"
+#include "nat.hpp"
+
+using namespace VOM;
+
+std::mutex reconcile::m_last_lock;
+reconcile::result_t reconcile::m_last = { false, 0, 0, 0,
+                                          std::chrono::milliseconds(0) };
+
+void
+reconcile::interface(const std::string& name, bool admin_up)
+{
+  m_interfaces[name] = admin_up;
+}
+
+void
+reconcile::address(const std::string& itf, const route::prefix_t& pfx)
+{
+  m_addresses[itf].insert(pfx);
+}
+
+void
+reconcile::route(const route::prefix_t& pfx, const route::path_list_t& paths)
+{
+  m_routes[pfx] = paths;
+}
+
+void
+reconcile::nat_static(const boost::asio::ip::address& inside,
+                      const boost::asio::ip::address& outside)
+{
+  m_nat_statics.insert(nat_pair_t(inside, outside));
+}
+
+reconcile::result_t
+reconcile::run()
+{
+  std::chrono::steady_clock::time_point begin =
+    std::chrono::steady_clock::now();
+  result_t res = { false, 0, 0, 0, std::chrono::milliseconds(0) };
+  std::unique_lock<std::mutex> hw(hw_lock());
+
+  if (!diff(res)) {
+    OM::replay();
+
+    /* addresses are programmed outside of VOM, on the interfaces it has
+     * replayed */
+    address_batch addrs(true);
+    size_t lost = 0;
+    for (auto& a : m_addresses) {
+      std::shared_ptr<VOM::interface> itf = VOM::interface::find(a.first);
+
+      if (!itf || handle_t::INVALID == itf->handle()) {
+        lost += a.second.size();
+        continue;
+      }
+      for (auto& pfx : a.second)
+        addrs.add(itf->handle().value(), pfx);
+    }
+    addrs.enqueue();
+
+    /* and so are NAT static mappings */
+    nat_static_batch nats(true);
+    for (auto& n : m_nat_statics)
+      nats.add(n.first, n.second);
+    nats.enqueue();
+
+    /* and so are the routes */
+    route_batch routes(true);
+    for (auto& r : m_routes)
+      routes.add(r.first, r.second);
+    routes.enqueue();
+    HW::write();
+
+    res.replayed = true;
+    res.written = res.checked;
+    res.failed = lost + addrs.failed() + nats.failed() + routes.failed();
+  }
+  hw.unlock();
+
+  res.duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+    std::chrono::steady_clock::now() - begin);
+
+  std::lock_guard<std::mutex> lg(m_last_lock);
+  m_last = res;
+
+  return res;
+}
+
+reconcile::result_t
+reconcile::last()
+{
+  std::lock_guard<std::mutex> lg(m_last_lock);
+
+  return m_last;
+}
+
+template <typename BYTES>
+static void
+copy_bytes(const BYTES& from, uint8_t* to)
+{
+  std::copy(from.begin(), from.end(), to);
+}
+
+bool
+reconcile::diff(result_t& res)
+{
+  std::map<std::string, uint32_t> sw_if_indexes;
+  std::map<uint32_t, bool> admin_up;
+  std::vector<std::shared_ptr<ip_address_dump>> addr_dumps;
+  std::set<nat_pair_t> nats;
+
+  res.checked = m_interfaces.size() + m_nat_statics.size() + m_routes.size();
+  for (auto& a : m_addresses)
+    res.checked += a.second.size();
+
+  auto itfs = std::make_shared<interface_dump>();
+  HW::enqueue(itfs);
+  if (rc_t::OK != HW::write())
+    return false;
+
+  for (auto& it : *itfs) {
+    const vapi_payload_sw_interface_details& d = it.get_payload();
+    sw_if_indexes[d.interface_name] = d.sw_if_index;
+    admin_up[d.sw_if_index] = (d.flags & IF_STATUS_API_FLAG_ADMIN_UP);
+  }
+
+  /* Programming VPP behind VOM's back is only right if VOM still knows
+   * the interfaces by the sw_if_index they have now */
+  auto known = [&](const std::string& name, uint32_t& sw_if_index) {
+    std::shared_ptr<VOM::interface> itf = VOM::interface::find(name);
+    auto it = sw_if_indexes.find(name);
+
+    if (!itf || it == sw_if_indexes.end() ||
+        itf->handle().value() != it->second)
+      return false;
+
+    sw_if_index = it->second;
+    return true;
+  };
+
+  admin_state_batch flags;
+  for (auto& e : m_interfaces) {
+    uint32_t sw_if_index;
+
+    if (!known(e.first, sw_if_index))
+      return false;
+    if (admin_up[sw_if_index] != e.second)
+      flags.add(sw_if_index, e.second);
+  }
+
+  /* addresses of all the interfaces, dumped in one pipeline */
+  auto addr_pipeline = std::make_shared<pipeline_cmd>("ip-address-dump");
+  for (auto& a : m_addresses) {
+    uint32_t sw_if_index;
+
+    if (!known(a.first, sw_if_index))
+      return false;
+
+    addr_dumps.push_back(std::make_shared<ip_address_dump>(sw_if_index, false));
+    addr_dumps.push_back(std::make_shared<ip_address_dump>(sw_if_index, true));
+    addr_pipeline->add(addr_dumps[addr_dumps.size() - 2]);
+    addr_pipeline->add(addr_dumps.back());
+  }
+  if (addr_pipeline->size()) {
+    HW::enqueue(addr_pipeline);
+    if (rc_t::OK != HW::write())
+      return false;
+  }
+
+  address_batch addrs(true);
+  auto dump = addr_dumps.begin();
+  for (auto& a : m_addresses) {
+    std::set<route::prefix_t> present;
+    uint32_t sw_if_index = sw_if_indexes[a.first];
+
+    for (int family = 0; family < 2; family++, dump++)
+      for (auto& it : **dump)
+        present.insert(from_api(it.get_payload().prefix));
+
+    for (auto& pfx : a.second) {
+      if (!present.count(pfx))
+        addrs.add(sw_if_index, pfx);
+    }
+  }
+
+  nat_static_batch nat(true);
+  if (!m_nat_statics.empty()) {
+    auto dump44 = std::make_shared<nat44_static_mapping_dump>();
+    auto dump66 = std::make_shared<nat66_static_mapping_dump>();
+    auto nat_pipeline = std::make_shared<pipeline_cmd>("nat-static-dump");
+
+    nat_pipeline->add(dump44);
+    nat_pipeline->add(dump66);
+    HW::enqueue(nat_pipeline);
+    if (rc_t::OK != HW::write())
+      return false;
+
+    for (auto& it : *dump44) {
+      const auto& d = it.get_payload();
+      boost::asio::ip::address_v4::bytes_type in, out;
+
+      std::copy(d.local_ip_address, d.local_ip_address + in.size(),
+                in.begin());
+      std::copy(d.external_ip_address, d.external_ip_address + out.size(),
+                out.begin());
+      nats.insert(nat_pair_t(boost::asio::ip::address_v4(in),
+                             boost::asio::ip::address_v4(out)));
+    }
+    for (auto& it : *dump66) {
+      const auto& d = it.get_payload();
+      boost::asio::ip::address_v6::bytes_type in, out;
+
+      std::copy(d.local_ip_address, d.local_ip_address + in.size(),
+                in.begin());
+      std::copy(d.external_ip_address, d.external_ip_address + out.size(),
+                out.begin());
+      nats.insert(nat_pair_t(boost::asio::ip::address_v6(in),
+                             boost::asio::ip::address_v6(out)));
+    }
+  }
+
+  for (auto& n : m_nat_statics) {
+    if (!nats.count(n))
+      nat.add(n.first, n.second);
+  }
+
+  route_batch routes(true);
+  for (auto& r : m_routes)
+    routes.add(r.first, r.second);
+
+  /* admin state first, then what depends on the interfaces */
+  flags.enqueue();
+  addrs.enqueue();
+  routes.enqueue();
+  nat.enqueue();
+  HW::write();
+
+  res.written = flags.size() + addrs.size() + routes.size() + nat.size();
+  res.failed =
+    flags.failed() + addrs.failed() + routes.failed() + nat.failed();
+
+  return true;
+}
@@ -0,0 +1,94 @@
+#ifndef __OPER_RECONCILE_H_
+#define __OPER_RECONCILE_H_
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+
+#include <vom/route.hpp>
+
+/**
+ * Bring a reconnected VPP back to the configuration sweetcomb has
+ * programmed, by difference instead of by replaying the VOM database.
+ *
+ * The expected objects are declared first. run() then dumps the
+ * interfaces, addresses and NAT static mappings VPP has, and programs
+ * only the missing ones, with pipelined requests. Routes are added again
+ * without dumping the FIB: an added route replaces the paths it had.
+ *
+ * The VOM objects are left as they are, which is only valid while VPP
+ * interfaces keep the sw_if_index VOM knows them by. If one does not,
+ * or an expected interface is missing, run() falls back to
+ * OM::replay(), then programs again what is not in VOM: addresses, NAT
+ * static mappings and routes.
+ */
+class reconcile
+{
+public:
+  struct result_t
+  {
+    /* the VOM database was replayed as a whole */
+    bool replayed;
+    /* expected objects compared with VPP */
+    size_t checked;
+    /* objects programmed again */
+    size_t written;
+    /* objects that failed to be programmed */
+    size_t failed;
+    std::chrono::milliseconds duration;
+  };
+
+  /**
+   * Declare an interface and its expected admin state
+   */
+  void interface(const std::string& name, bool admin_up);
+
+  /**
+   * Declare an address expected on an interface
+   */
+  void address(const std::string& itf, const VOM::route::prefix_t& pfx);
+
+  /**
+   * Declare a route expected in the default table
+   */
+  void route(const VOM::route::prefix_t& pfx,
+             const VOM::route::path_list_t& paths);
+
+  /**
+   * Declare an expected address only static NAT mapping
+   */
+  void nat_static(const boost::asio::ip::address& inside,
+                  const boost::asio::ip::address& outside);
+
+  /**
+   * Compare VPP with the declared objects and program the difference
+   */
+  result_t run();
+
+  /**
+   * Result of the last run, checked is 0 if there was none
+   */
+  static result_t last();
+
+private:
+  typedef std::pair<boost::asio::ip::address, boost::asio::ip::address>
+    nat_pair_t;
+
+  /**
+   * Program the difference, return false to fall back to a full replay
+   */
+  bool diff(result_t& res);
+
+  std::map<std::string, bool> m_interfaces;
+  std::map<std::string, std::set<VOM::route::prefix_t>> m_addresses;
+  std::map<VOM::route::prefix_t, VOM::route::path_list_t> m_routes;
+  std::set<nat_pair_t> m_nat_statics;
+
+  static std::mutex m_last_lock;
+  static result_t m_last;
+};
+
+#endif //__OPER_RECONCILE_H_
@@ -0,0 +1,233 @@
+#include "stats.hpp"
+
+#include <cstring>
+
+const std::chrono::milliseconds interface_stats::MAX_AGE(1000);
+
+namespace {
+
+/**
+ * Where each /if/ counter of the stats segment goes in if_counters_t
+ */
+struct combined_map_t
+{
+  const char* name;
+  if_counters_t::combined_t if_counters_t::*field;
+};
+
+struct simple_map_t
+{
+  const char* name;
+  uint64_t if_counters_t::*field;
+};
+
+const combined_map_t combined_map[] = {
+  { "/if/rx", &if_counters_t::rx },
+  { "/if/rx-unicast", &if_counters_t::rx_unicast },
+  { "/if/rx-multicast", &if_counters_t::rx_multicast },
+  { "/if/rx-broadcast", &if_counters_t::rx_broadcast },
+  { "/if/tx", &if_counters_t::tx },
+  { "/if/tx-unicast", &if_counters_t::tx_unicast },
+  { "/if/tx-multicast", &if_counters_t::tx_multicast },
+  { "/if/tx-broadcast", &if_counters_t::tx_broadcast },
+};
+
+const simple_map_t simple_map[] = {
+  { "/if/drops", &if_counters_t::drops },
+  { "/if/punt", &if_counters_t::punts },
+  { "/if/rx-no-buf", &if_counters_t::rx_no_buf },
+  { "/if/rx-miss", &if_counters_t::rx_miss },
+  { "/if/rx-error", &if_counters_t::rx_error },
+  { "/if/tx-error", &if_counters_t::tx_error },
+};
+
+} // namespace
+
+void
+interface_stats::snapshot_t::fill(const stat_segment_data_t* res)
+{
+  int n_entries = stat_segment_vec_len((void*)res);
+
+  m_taken = std::chrono::steady_clock::now();
+
+  for (int i = 0; i < n_entries; i++) {
+    const stat_segment_data_t& e = res[i];
+
+    if (STAT_DIR_TYPE_COUNTER_VECTOR_COMBINED == e.type) {
+      for (auto& m : combined_map) {
+        if (strcmp(e.name, m.name))
+          continue;
+
+        int n_threads = stat_segment_vec_len(e.combined_counter_vec);
+        for (int k = 0; k < n_threads; k++) {
+          vlib_counter_t* c = e.combined_counter_vec[k];
+          size_t n_itfs = stat_segment_vec_len(c);
+
+          if (m_counters.size() < n_itfs)
+            m_counters.resize(n_itfs, if_counters_t());
+          for (size_t j = 0; j < n_itfs; j++) {
+            (m_counters[j].*m.field).packets += c[j].packets;
+            (m_counters[j].*m.field).bytes += c[j].bytes;
+          }
+        }
+        break;
+      }
+    } else if (STAT_DIR_TYPE_COUNTER_VECTOR_SIMPLE == e.type) {
+      for (auto& m : simple_map) {
+        if (strcmp(e.name, m.name))
+          continue;
+
+        int n_threads = stat_segment_vec_len(e.simple_counter_vec);
+        for (int k = 0; k < n_threads; k++) {
+          counter_t* c = e.simple_counter_vec[k];
+          size_t n_itfs = stat_segment_vec_len(c);
+
+          if (m_counters.size() < n_itfs)
+            m_counters.resize(n_itfs, if_counters_t());
+          for (size_t j = 0; j < n_itfs; j++)
+            m_counters[j].*m.field += c[j];
+        }
+        break;
+      }
+    }
+  }
+}
+
+interface_stats&
+interface_stats::instance()
+{
+  static interface_stats stats;
+
+  return stats;
+}
+
+interface_stats::interface_stats()
+  : m_socket(STAT_SEGMENT_SOCKET_FILE)
+  , m_connected(false)
+  , m_patterns(nullptr)
+  , m_dir(nullptr)
+{
+}
+
+interface_stats::~interface_stats()
+{
+  free_dir();
+  if (m_connected)
+    stat_segment_disconnect();
+}
+
+void
+interface_stats::free_dir()
+{
+  if (m_patterns) {
+    for (int i = 0; i < stat_segment_vec_len(m_patterns); i++)
+      stat_segment_vec_free(m_patterns[i]);
+    stat_segment_vec_free(m_patterns);
+    m_patterns = nullptr;
+  }
+  if (m_dir) {
+    stat_segment_vec_free(m_dir);
+    m_dir = nullptr;
+  }
+}
+
+bool
+interface_stats::connect(const std::string& socket)
+{
+  std::lock_guard<std::mutex> lg(m_lock);
+
+  m_socket = socket;
+  if (!m_connected)
+    m_connected = (0 == stat_segment_connect(m_socket.c_str()));
+
+  return m_connected;
+}
+
+bool
+interface_stats::is_connected()
+{
+  std::lock_guard<std::mutex> lg(m_lock);
+
+  return m_connected;
+}
+
+void
+interface_stats::disconnect()
+{
+  std::lock_guard<std::mutex> lg(m_lock);
+
+  free_dir();
+  if (m_connected) {
+    stat_segment_disconnect();
+    m_connected = false;
+  }
+  std::atomic_store(&m_snapshot, std::shared_ptr<const snapshot_t>());
+}
+
+std::shared_ptr<const interface_stats::snapshot_t>
+interface_stats::snapshot()
+{
+  return snapshot(MAX_AGE);
+}
+
+std::shared_ptr<const interface_stats::snapshot_t>
+interface_stats::snapshot(std::chrono::milliseconds max_age)
+{
+  std::shared_ptr<const snapshot_t> snap = std::atomic_load(&m_snapshot);
+  std::chrono::steady_clock::time_point asked =
+    std::chrono::steady_clock::now();
+
+  if (snap && asked - snap->taken() < max_age)
+    return snap;
+
+  std::lock_guard<std::mutex> lg(m_lock);
+
+  /* another reader may have refreshed it while we waited */
+  snap = std::atomic_load(&m_snapshot);
+  if (snap && (std::chrono::steady_clock::now() - snap->taken() < max_age ||
+               snap->taken() >= asked))
+    return snap;
+
+  snap = read();
+  if (snap)
+    std::atomic_store(&m_snapshot, snap);
+
+  return snap;
+}
+
+std::shared_ptr<const interface_stats::snapshot_t>
+interface_stats::read()
+{
+  stat_segment_data_t* res = nullptr;
+
+  if (!m_connected)
+    m_connected = (0 == stat_segment_connect(m_socket.c_str()));
+  if (!m_connected)
+    return nullptr;
+
+  /* The directory indexes are stale when VPP has changed the directory
+   * since the last ls, in which case the dump fails: list again once. */
+  for (int attempt = 0; attempt < 2 && !res; attempt++) {
+    if (!m_dir || attempt) {
+      if (!m_patterns)
+        m_patterns = stat_segment_string_vector(nullptr, "^/if/");
+
+      if (m_dir)
+        stat_segment_vec_free(m_dir);
+      m_dir = stat_segment_ls(m_patterns);
+      if (!m_dir)
+        return nullptr;
+    }
+    /* copies the counter vectors, see the class comment */
+    res = stat_segment_dump(m_dir);
+  }
+
+  if (!res)
+    return nullptr;
+
+  std::shared_ptr<snapshot_t> snap = std::make_shared<snapshot_t>();
+  snap->fill(res);
+  stat_segment_data_free(res);
+
+  return snap;
+}
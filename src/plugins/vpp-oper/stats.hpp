@@ -0,0 +1,159 @@
+#ifndef __OPER_STATS_H_
+#define __OPER_STATS_H_
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include <vpp-api/client/stat_client.h>
+}
+
+/**
+ * Counters of one interface, summed over all VPP threads
+ */
+struct if_counters_t
+{
+  struct combined_t
+  {
+    uint64_t packets;
+    uint64_t bytes;
+  };
+
+  combined_t rx;
+  combined_t rx_unicast;
+  combined_t rx_multicast;
+  combined_t rx_broadcast;
+  combined_t tx;
+  combined_t tx_unicast;
+  combined_t tx_multicast;
+  combined_t tx_broadcast;
+  uint64_t drops;
+  uint64_t punts;
+  uint64_t rx_no_buf;
+  uint64_t rx_miss;
+  uint64_t rx_error;
+  uint64_t tx_error;
+};
+
+/**
+ * Bulk reader of the interface counters from the VPP stats segment.
+ *
+ * All the /if/ counter vectors are read in one pass with the VPP stat
+ * client, which maps the segment and reads it without lock: a read is
+ * retried when VPP bumped the segment epoch or was updating it meanwhile.
+ * The result is an immutable snapshot indexed by sw_if_index, shared by
+ * all readers until it is older than MAX_AGE.
+ *
+ * The counters are copied by stat_segment_dump() rather than read in place:
+ * the stat client of the VPP releases supported has no public accessor of
+ * the segment, whose layout and update protocol are private to it. The copy
+ * is made once per snapshot, at most once per MAX_AGE whatever the number
+ * of readers, and is freed as soon as it is folded.
+ */
+class interface_stats
+{
+public:
+  /**
+   * A snapshot of the counters of all interfaces, indexed by sw_if_index
+   */
+  class snapshot_t
+  {
+  public:
+    /**
+     * Return the counters of an interface, nullptr if not in snapshot
+     */
+    const if_counters_t* get(uint32_t sw_if_index) const
+    {
+      if (sw_if_index >= m_counters.size())
+        return nullptr;
+      return &m_counters[sw_if_index];
+    }
+
+    /**
+     * Number of interface slots in the snapshot
+     */
+    size_t size() const { return m_counters.size(); }
+
+    /**
+     * When the snapshot was taken
+     */
+    std::chrono::steady_clock::time_point taken() const { return m_taken; }
+
+    /**
+     * Fold the per-thread counter vectors of a stat segment dump
+     */
+    void fill(const stat_segment_data_t* res);
+
+  private:
+    std::vector<if_counters_t> m_counters;
+    std::chrono::steady_clock::time_point m_taken;
+  };
+
+  /**
+   * Maximum age of a snapshot before the segment is read again
+   */
+  static const std::chrono::milliseconds MAX_AGE;
+
+  /**
+   * The singleton instance
+   */
+  static interface_stats& instance();
+
+  /**
+   * Connect to the VPP stats segment
+   */
+  bool connect(const std::string& socket = STAT_SEGMENT_SOCKET_FILE);
+
+  /**
+   * Return true if connected to the VPP stats segment
+   */
+  bool is_connected();
+
+  /**
+   * Disconnect from the VPP stats segment, e.g. when VPP has restarted
+   */
+  void disconnect();
+
+  /**
+   * Return a snapshot not older than MAX_AGE, nullptr if the segment
+   * can not be read
+   */
+  std::shared_ptr<const snapshot_t> snapshot();
+
+  /**
+   * Return a snapshot not older than max_age, 0 to read the segment
+   * anyway, e.g. to sample the counters at a fixed interval
+   */
+  std::shared_ptr<const snapshot_t> snapshot(std::chrono::milliseconds max_age);
+
+private:
+  interface_stats();
+  ~interface_stats();
+
+  /**
+   * Free the directory indexes and their patterns
+   */
+  void free_dir();
+
+  /**
+   * Read all the interface counters from the segment
+   */
+  std::shared_ptr<const snapshot_t> read();
+
+  /* the stat client is not thread safe, serialize the segment reads */
+  std::mutex m_lock;
+  std::string m_socket;
+  bool m_connected;
+
+  /* directory indexes of the /if/ counters */
+  uint8_t** m_patterns;
+  uint32_t* m_dir;
+
+  /* last snapshot, accessed with atomic_load/atomic_store only */
+  std::shared_ptr<const snapshot_t> m_snapshot;
+};
+
+#endif //__OPER_STATS_H_
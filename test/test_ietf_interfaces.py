@@ -17,6 +17,7 @@
 #
 
 import unittest
+import time
 
 import util
 from framework import SweetcombTestCase, SweetcombTestRunner
@@ -115,6 +116,8 @@ class TestIetfInterfaces(SweetcombTestCase):
         prefix = interface.ipv4.address[1].ip + "/" + \
                                 str(interface.ipv4.address[1].prefix_length)
         self.assertIn(prefix, a.addr)
+        # each address is programmed once, with its own prefix length
+        self.assertEqual(len(a.addr), 2)
 
         try:
             crud_service.delete(self.netopeer_cli, interface)
@@ -128,6 +131,137 @@ class TestIetfInterfaces(SweetcombTestCase):
 
         self.logger.info("IETF_INTERFACE_TEST_FINISH_002")
 
+    def test_ipv6(self):
+
+        self.logger.info("IETF_INTERFACE_TEST_START_005")
+
+        name = "host-vpp1"
+        crud_service = CRUDService()
+
+        interface = ietf_interfaces.Interfaces.Interface()
+        interface.name = name
+        interface.type = iana_if_type.EthernetCsmacd()
+        interface.ipv6 = interface.Ipv6()
+        addr = interface.Ipv6().Address()
+        addr.ip = "2001:db8::1"
+        addr.prefix_length = 64
+        interface.ipv6.address.append(addr)
+
+        try:
+            crud_service.create(self.netopeer_cli, interface)
+        except YError as err:
+            print("Error create services: {}".format(err))
+            assert()
+
+        a = self.vppctl.show_address(name)
+        self.assertIsNotNone(a)
+
+        prefix = addr.ip + "/" + str(addr.prefix_length)
+        self.assertIn(prefix, a.addr)
+
+        try:
+            crud_service.delete(self.netopeer_cli, interface)
+        except YError as err:
+            print("Error create services: {}".format(err))
+            assert()
+
+        a = self.vppctl.show_address(name)
+
+        self.assertIsNone(a)
+
+        self.logger.info("IETF_INTERFACE_TEST_FINISH_005")
+
+    def test_interface_state(self):
+
+        self.logger.info("IETF_INTERFACE_TEST_START_003")
+
+        name = "host-vpp1"
+        crud_service = CRUDService()
+        AdminStatus = ietf_interfaces.InterfacesState.Interface.AdminStatus
+
+        # restored once done, for the next tests
+        initial = self.vppctl.show_interface(name)
+        self.assertIsNotNone(initial)
+        self.assertIsNotNone(initial.State)
+
+        # State changes made behind sweetcomb's back reach it through VPP
+        # interface events, which are asynchronous: the operational reads
+        # must follow them within a few seconds.
+        try:
+            for enabled in [False, True, False]:
+                expected = AdminStatus.up if enabled else AdminStatus.down
+                self.vppctl.set_interface_state(name, enabled)
+
+                interface = ietf_interfaces.InterfacesState.Interface()
+                interface.name = name
+                deadline = time.time() + 5
+
+                while True:
+                    try:
+                        state = crud_service.read(self.netopeer_cli,
+                                                  interface)
+                    except YError as err:
+                        print("Error read services: {}".format(err))
+                        assert()
+
+                    if (state is not None and
+                            state.admin_status == expected) or \
+                            time.time() > deadline:
+                        break
+                    time.sleep(0.1)
+
+                self.assertIsNotNone(state)
+                self.assertEqual(state.admin_status, expected)
+        finally:
+            self.vppctl.set_interface_state(name, initial.State)
+
+        self.logger.info("IETF_INTERFACE_TEST_FINISH_003")
+
+    def test_vpp_restart(self):
+
+        self.logger.info("IETF_INTERFACE_TEST_START_004")
+
+        name = "host-vpp1"
+        crud_service = CRUDService()
+
+        interface = ietf_interfaces.Interfaces.Interface()
+        interface.name = name
+        interface.type = iana_if_type.EthernetCsmacd()
+        interface.enabled = True
+
+        try:
+            crud_service.create(self.netopeer_cli, interface)
+        except YError as err:
+            print("Error create services: {}".format(err))
+            self.fail()
+
+        p = self.vppctl.show_interface(name)
+        self.assertIsNotNone(p)
+        self.assertTrue(p.State)
+
+        # The health check must notice the new VPP process and replay the
+        # configuration on it.
+        self.vpp.kill()
+        self.vpp.spawn()
+
+        p = None
+        for _ in range(30):
+            p = self.vppctl.show_interface(name)
+            if p is not None and p.State:
+                break
+            time.sleep(1)
+
+        self.assertIsNotNone(p)
+        self.assertTrue(p.State)
+
+        try:
+            crud_service.delete(self.netopeer_cli, interface)
+        except YError as err:
+            print("Error delete services: {}".format(err))
+            self.fail()
+
+        self.logger.info("IETF_INTERFACE_TEST_FINISH_004")
+
 
 if __name__ == '__main__':
     unittest.main(testRunner=SweetcombTestRunner)
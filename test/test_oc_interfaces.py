@@ -72,6 +72,55 @@ class TestOcInterfaces(SweetcombTestCase):
 
         self.logger.info("OC_INTERFACE_FINISH_001")
 
+    def test_interface_counters(self):
+
+        self.logger.info("OC_INTERFACE_START_003")
+
+        name = "host-vpp1"
+        crud_service = CRUDService()
+
+        config = openconfig_interfaces.Interfaces.Interface()
+        config.name = name
+
+        # subinterfaces are config data, their state is read once configured
+        subinterface = config.Subinterfaces.Subinterface()
+        subinterface.index = 0
+        subinterface.config.index = 0
+        config.subinterfaces.subinterface.append(subinterface)
+
+        try:
+            crud_service.create(self.netopeer_cli, config)
+        except YError as err:
+            print("Error create services: {}".format(err))
+            self.fail()
+
+        interface = openconfig_interfaces.Interfaces.Interface()
+        interface.name = name
+
+        try:
+            state = crud_service.read(self.netopeer_cli, interface)
+        except YError as err:
+            print("Error read services: {}".format(err))
+            assert()
+
+        self.assertIsNotNone(state)
+        self.assertIsNotNone(state.state.counters.in_octets)
+        self.assertIsNotNone(state.state.counters.out_octets)
+
+        # subinterface 0 is the interface itself
+        self.assertEqual(state.subinterfaces.subinterface[0].index, 0)
+        self.assertEqual(state.subinterfaces.subinterface[0].state.name, name)
+
+        # the interface config created above goes with its subinterface
+        try:
+            crud_service.delete(self.netopeer_cli, subinterface)
+            crud_service.delete(self.netopeer_cli, config)
+        except YError as err:
+            print("Error delete services: {}".format(err))
+            self.fail()
+
+        self.logger.info("OC_INTERFACE_FINISH_003")
+
     @unittest.skip("YDK return error when try set IP address")
     def test_interface_ipv4(self):
 
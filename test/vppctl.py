@@ -89,6 +89,11 @@ class Vppctl:
 
         return None
 
+    def set_interface_state(self, name, up):
+        state = "up" if up else "down"
+        subprocess.run(self.cmd + " set interface state " + name + " " +
+                       state, shell=True, stdout=subprocess.PIPE)
+
     def show_address(self, ifName=None):
         interfaces = dict()
         p = subprocess.run(self.cmd + " show int addr", shell=True,